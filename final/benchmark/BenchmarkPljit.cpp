@@ -0,0 +1,291 @@
+#include "pljit/BatchDispatcher.hpp"
+#include "pljit/Pljit.hpp"
+#include "pljit/ThreadPool.hpp"
+#include "test/ProgramGenerator.hpp"
+#include <benchmark/benchmark.h>
+//---------------------------------------------------------------------------
+using namespace std;
+using namespace pljit;
+using namespace pljit::semanticanalysis;
+//---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+// Build a program with the given number of statements
+string buildProgram(size_t statements, size_t depth = 3) {
+    ProgramShape shape;
+    shape.statements = statements;
+    shape.parameters = 3;
+    shape.depth = depth;
+    return ProgramGenerator(shape).generate();
+}
+//---------------------------------------------------------------------------
+// Run the front end on a program
+Function analyze(const string& code) {
+    shared_ptr<CodeManagement> codeM = make_shared<CodeManagement>(code);
+    Lexer lexer(code.data(), codeM);
+    Parsing parser(lexer, codeM);
+    parser.parsing();
+    SemanticAnalysis semanticAnalysis(codeM);
+    return semanticAnalysis.getAST(parser);
+}
+//---------------------------------------------------------------------------
+// Representative functions for the call latency
+const vector<string> functions = {
+    "PARAM a, b;\nBEGIN\nRETURN a + b\nEND.\n",
+    "PARAM a, b; VAR d; CONST c = 2; BEGIN d := (a + b); d := d * c; RETURN d END.",
+    "VAR d, e; BEGIN d := -1 * (12 / (-6)); e := d + +2; e := -(-(-e)); RETURN e; RETURN d END.",
+    buildProgram(64)};
+//---------------------------------------------------------------------------
+void BenchmarkLexer(benchmark::State& state) {
+    string code = buildProgram(state.range(0));
+    shared_ptr<CodeManagement> codeM = make_shared<CodeManagement>(code);
+
+    for (auto _ : state) {
+        Lexer lexer(code.data(), codeM);
+        for (Token token = lexer.next(); token.tokenType() != Token::EndToken && token.tokenType() != Token::Unexpected; token = lexer.next()) {
+            benchmark::DoNotOptimize(token);
+        }
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * code.size()));
+}
+//---------------------------------------------------------------------------
+void BenchmarkParse(benchmark::State& state) {
+    string code = buildProgram(state.range(0));
+
+    for (auto _ : state) {
+        shared_ptr<CodeManagement> codeM = make_shared<CodeManagement>(code);
+        Lexer lexer(code.data(), codeM);
+        Parsing parser(lexer, codeM);
+        parser.parsing();
+        benchmark::DoNotOptimize(parser.getTree());
+    }
+
+    state.SetComplexityN(state.range(0));
+}
+//---------------------------------------------------------------------------
+void BenchmarkSemanticAnalysis(benchmark::State& state) {
+    string code = buildProgram(state.range(0));
+
+    for (auto _ : state) {
+        Function function = analyze(code);
+        benchmark::DoNotOptimize(function);
+    }
+
+    state.SetComplexityN(state.range(0));
+}
+//---------------------------------------------------------------------------
+void BenchmarkPass(benchmark::State& state) {
+    auto pass = static_cast<Pass>(state.range(0));
+    string code = buildProgram(state.range(1));
+    PassManager passManager({pass});
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        unique_ptr<ASTNode> function = make_unique<Function>(analyze(code));
+        state.ResumeTiming();
+
+        passManager.run(function);
+        benchmark::DoNotOptimize(function);
+    }
+
+    state.SetLabel(string(PassManager::getName(pass)));
+}
+//---------------------------------------------------------------------------
+void BenchmarkCall(benchmark::State& state) {
+    Pljit jit;
+    const string& code = functions[state.range(0)];
+    auto func = jit.registerFunction(code);
+    vector<int64_t> parameters = {1, 2, 3};
+    parameters.resize(analyze(code).getSymbolTable().getParameterCount());
+    // The first call compiles the function
+    func(parameters);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(func(parameters));
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+//---------------------------------------------------------------------------
+// Call a handle with a fixed number of parameters, the arguments stay on the stack
+void BenchmarkCallTyped(benchmark::State& state) {
+    Pljit jit;
+    auto func = jit.registerFunction<2>(functions[1]);
+    func(1, 2);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(func(1, 2));
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+//---------------------------------------------------------------------------
+// All threads call the same handle
+Pljit sharedJit;
+PljitHandle sharedHandle = sharedJit.registerFunction(functions[1]);
+//---------------------------------------------------------------------------
+void BenchmarkCallSingleHandle(benchmark::State& state) {
+    vector<int64_t> parameters = {1, 2};
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sharedHandle(parameters));
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+//---------------------------------------------------------------------------
+// Every thread calls its own handle
+constexpr size_t maxThreads = 16;
+Pljit multipleJit;
+vector<unique_ptr<PljitHandle>> multipleHandles;
+//---------------------------------------------------------------------------
+void BenchmarkCallMultipleHandles(benchmark::State& state) {
+    vector<int64_t> parameters = {1, 2};
+
+    if (state.thread_index == 0 && multipleHandles.empty()) {
+        // The handles are compiled before the threads start calling them
+        for (size_t i = 0; i < maxThreads; i++) {
+            multipleHandles.emplace_back(new PljitHandle(multipleJit.registerFunction(functions[1])));
+            (*multipleHandles.back())(parameters);
+        }
+    }
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize((*multipleHandles[state.thread_index])(parameters));
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+//---------------------------------------------------------------------------
+// All threads call the same handle through a batch dispatcher
+PljitHandle batchedHandle = sharedJit.registerFunction(functions[1]);
+BatchDispatcher batchDispatcher(batchedHandle);
+//---------------------------------------------------------------------------
+void BenchmarkCallBatched(benchmark::State& state) {
+    vector<int64_t> parameters = {1, 2};
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(batchDispatcher(parameters));
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+//---------------------------------------------------------------------------
+// Evaluate a batch of calls on a pool with the given number of workers
+void BenchmarkEvaluateParallel(benchmark::State& state) {
+    ThreadPool pool(static_cast<size_t>(state.range(0)));
+    Pljit jit;
+    auto func = jit.registerFunction(functions[3]);
+    vector<vector<int64_t>> calls;
+    for (int64_t i = 0; i < 4096; i++) {
+        calls.push_back({i, i + 1, i + 2});
+    }
+    func.compileInBackground(pool).get();
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(func.evaluateParallel(pool, calls));
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(calls.size()));
+}
+//---------------------------------------------------------------------------
+// Scaling of every phase with the number of statements (range 0) and the expression depth (range 1)
+void BenchmarkScalingLexer(benchmark::State& state) {
+    string code = buildProgram(state.range(0), state.range(1));
+    shared_ptr<CodeManagement> codeM = make_shared<CodeManagement>(code);
+
+    for (auto _ : state) {
+        Lexer lexer(code.data(), codeM);
+        for (Token token = lexer.next(); token.tokenType() != Token::EndToken && token.tokenType() != Token::Unexpected; token = lexer.next()) {
+            benchmark::DoNotOptimize(token);
+        }
+    }
+
+    state.SetComplexityN(static_cast<int64_t>(code.size()));
+}
+//---------------------------------------------------------------------------
+void BenchmarkScalingParse(benchmark::State& state) {
+    string code = buildProgram(state.range(0), state.range(1));
+
+    for (auto _ : state) {
+        shared_ptr<CodeManagement> codeM = make_shared<CodeManagement>(code);
+        Lexer lexer(code.data(), codeM);
+        Parsing parser(lexer, codeM);
+        parser.parsing();
+        benchmark::DoNotOptimize(parser.getTree());
+    }
+
+    state.SetComplexityN(static_cast<int64_t>(code.size()));
+}
+//---------------------------------------------------------------------------
+void BenchmarkScalingSemanticAnalysis(benchmark::State& state) {
+    string code = buildProgram(state.range(0), state.range(1));
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        shared_ptr<CodeManagement> codeM = make_shared<CodeManagement>(code);
+        Lexer lexer(code.data(), codeM);
+        Parsing parser(lexer, codeM);
+        parser.parsing();
+        state.ResumeTiming();
+
+        SemanticAnalysis semanticAnalysis(codeM);
+        Function function = semanticAnalysis.getAST(parser);
+        benchmark::DoNotOptimize(function);
+    }
+
+    state.SetComplexityN(static_cast<int64_t>(code.size()));
+}
+//---------------------------------------------------------------------------
+void BenchmarkScalingOptimization(benchmark::State& state) {
+    string code = buildProgram(state.range(0), state.range(1));
+    PassManager passManager(OptimizationLevel::O2);
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        unique_ptr<ASTNode> function = make_unique<Function>(analyze(code));
+        state.ResumeTiming();
+
+        passManager.run(function);
+        benchmark::DoNotOptimize(function);
+    }
+
+    state.SetComplexityN(static_cast<int64_t>(code.size()));
+}
+//---------------------------------------------------------------------------
+void BenchmarkScalingEvaluation(benchmark::State& state) {
+    string code = buildProgram(state.range(0), state.range(1));
+    Pljit jit;
+    auto func = jit.registerFunction(code);
+    vector<int64_t> parameters = {1, 2, 3};
+    func(parameters);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(func(parameters));
+    }
+
+    state.SetComplexityN(static_cast<int64_t>(code.size()));
+}
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+BENCHMARK(BenchmarkLexer)->RangeMultiplier(4)->Range(16, 16384);
+BENCHMARK(BenchmarkParse)->RangeMultiplier(4)->Range(16, 16384)->Complexity();
+BENCHMARK(BenchmarkSemanticAnalysis)->RangeMultiplier(4)->Range(16, 16384)->Complexity();
+BENCHMARK(BenchmarkPass)->ArgsProduct({{0, 1, 2, 3, 4}, {64, 1024}});
+BENCHMARK(BenchmarkCall)->DenseRange(0, 3);
+BENCHMARK(BenchmarkCallTyped);
+BENCHMARK(BenchmarkCallSingleHandle)->ThreadRange(1, maxThreads)->UseRealTime();
+BENCHMARK(BenchmarkCallMultipleHandles)->ThreadRange(1, maxThreads)->UseRealTime();
+BENCHMARK(BenchmarkCallBatched)->ThreadRange(1, maxThreads)->UseRealTime();
+BENCHMARK(BenchmarkEvaluateParallel)->RangeMultiplier(2)->Range(1, 8)->UseRealTime();
+BENCHMARK(BenchmarkScalingLexer)->RangeMultiplier(4)->Ranges({{64, 16384}, {3, 3}})->Complexity();
+BENCHMARK(BenchmarkScalingParse)->RangeMultiplier(4)->Ranges({{64, 16384}, {3, 3}})->Complexity();
+BENCHMARK(BenchmarkScalingParse)->ArgsProduct({{16}, {2, 4, 8, 12, 16}});
+BENCHMARK(BenchmarkScalingSemanticAnalysis)->RangeMultiplier(4)->Ranges({{64, 16384}, {3, 3}})->Complexity();
+BENCHMARK(BenchmarkScalingOptimization)->RangeMultiplier(4)->Ranges({{64, 16384}, {3, 3}})->Complexity();
+BENCHMARK(BenchmarkScalingEvaluation)->RangeMultiplier(4)->Ranges({{64, 16384}, {3, 3}})->Complexity();
+//---------------------------------------------------------------------------
+BENCHMARK_MAIN();
+//---------------------------------------------------------------------------
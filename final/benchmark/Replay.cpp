@@ -0,0 +1,36 @@
+#include "pljit/Replayer.hpp"
+#include <cstring>
+#include <iostream>
+//---------------------------------------------------------------------------
+using namespace std;
+using namespace pljit;
+//---------------------------------------------------------------------------
+// Replay a recorded trace and report its throughput and latencies
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        cerr << "usage: " << argv[0] << " <trace> [--timed]" << endl;
+        return 1;
+    }
+
+    optional<vector<RecordedEvent>> events = Recorder::read(argv[1]);
+    if (!events) {
+        cerr << "error: cannot read the trace " << argv[1] << endl;
+        return 1;
+    }
+
+    ReplayOptions options;
+    options.timed = argc > 2 && strcmp(argv[2], "--timed") == 0;
+    ReplayResult result = Replayer(move(*events)).run(options);
+
+    cout << "mode: " << (options.timed ? "timed" : "as fast as possible") << endl;
+    cout << "threads: " << result.threads << endl;
+    cout << "invocations: " << result.invocations << endl;
+    cout << "mismatches: " << result.mismatches << endl;
+    cout << "duration: " << chrono::duration<double, milli>(result.duration).count() << " ms" << endl;
+    cout << "throughput: " << result.getThroughput() << " calls/s" << endl;
+    for (double share : {0.5, 0.9, 0.99, 0.999, 1.0}) {
+        cout << "p" << share * 100 << ": " << result.latency.percentile(share).count() << " ns" << endl;
+    }
+    return result.mismatches == 0 ? 0 : 2;
+}
+//---------------------------------------------------------------------------
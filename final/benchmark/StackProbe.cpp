@@ -0,0 +1,130 @@
+#include "pljit/Pljit.hpp"
+#include "test/ProgramGenerator.hpp"
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+//---------------------------------------------------------------------------
+using namespace std;
+using namespace pljit;
+using namespace pljit::semanticanalysis;
+//---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+/// All phases that recurse over the program
+const char* const phaseNames[] = {"parsing", "semantic analysis", "optimization", "evaluation", "none"};
+//---------------------------------------------------------------------------
+// Name of the phase, the probe reports -1 when it could not observe the child
+const char* phaseName(int phase) {
+    return phase >= 0 && phase <= 4 ? phaseNames[phase] : "unknown";
+}
+//---------------------------------------------------------------------------
+// Run all phases on the program, the index of the current phase is written to the pipe before it starts
+void runPhases(const string& code, int pipe) {
+    auto enter = [pipe](char phase) {
+        if (write(pipe, &phase, 1) != 1) {
+            _exit(2);
+        }
+    };
+
+    enter(0);
+    shared_ptr<CodeManagement> codeM = make_shared<CodeManagement>(code);
+    Lexer lexer(code.data(), codeM);
+    Parsing parser(lexer, codeM);
+    parser.parsing();
+
+    enter(1);
+    SemanticAnalysis semanticAnalysis(codeM);
+    unique_ptr<ASTNode> function = make_unique<Function>(semanticAnalysis.getAST(parser));
+
+    enter(2);
+    PassManager passManager(OptimizationLevel::O2);
+    passManager.run(function);
+
+    enter(3);
+    vector<int64_t> parameters = {1};
+    EvaluationContext evaluationContext(static_cast<Function&>(*function).getSymbolTable(), parameters);
+    function->evaluate(evaluationContext);
+
+    enter(4);
+}
+//---------------------------------------------------------------------------
+// Compile and evaluate the program in a child process, returns the phase that crashed or 4 if none did
+int probe(const string& code) {
+    int pipes[2];
+    if (pipe(pipes) != 0) {
+        return -1;
+    }
+
+    pid_t child = fork();
+    if (child == 0) {
+        close(pipes[0]);
+        runPhases(code, pipes[1]);
+        _exit(0);
+    }
+    close(pipes[1]);
+
+    int phase = -1;
+    char current = 0;
+    while (read(pipes[0], &current, 1) == 1) {
+        phase = current;
+    }
+    close(pipes[0]);
+
+    int status = 0;
+    waitpid(child, &status, 0);
+    bool success = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    return success ? 4 : phase;
+}
+//---------------------------------------------------------------------------
+// Find the largest size for which the generated program still works
+void search(const char* shape, string (*generate)(size_t), size_t limit) {
+    size_t good = 0;
+    size_t bad = 0;
+    int failedPhase = 4;
+
+    for (size_t size = 64; size <= limit; size *= 2) {
+        int phase = probe(generate(size));
+        if (phase != 4) {
+            bad = size;
+            failedPhase = phase;
+            break;
+        }
+        good = size;
+    }
+
+    if (bad == 0) {
+        cout << shape << ": no failure up to " << good << endl;
+        return;
+    }
+
+    while (bad - good > 1) {
+        size_t middle = good + (bad - good) / 2;
+        int phase = probe(generate(middle));
+        if (phase == 4) {
+            good = middle;
+        } else {
+            bad = middle;
+            failedPhase = phase;
+        }
+    }
+    cout << shape << ": largest working size " << good << ", fails in " << phaseName(failedPhase) << endl;
+}
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+// Probe how deeply the recursive phases can nest before they run out of stack
+int main(int argc, char** argv) {
+    size_t limit = argc > 1 ? stoull(argv[1]) : size_t(1) << 22;
+
+    rlimit stackLimit{};
+    getrlimit(RLIMIT_STACK, &stackLimit);
+    if (stackLimit.rlim_cur == RLIM_INFINITY) {
+        cout << "stack limit: unlimited" << endl;
+    } else {
+        cout << "stack limit: " << stackLimit.rlim_cur / 1024 << " KiB" << endl;
+    }
+
+    search("nested parentheses", ProgramGenerator::generateNested, limit);
+    search("operator chain", ProgramGenerator::generateChain, limit);
+}
+//---------------------------------------------------------------------------
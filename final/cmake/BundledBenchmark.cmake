@@ -0,0 +1,9 @@
+message(STATUS "Adding bundled Google Benchmark")
+
+set(BENCHMARK_ENABLE_TESTING OFF CACHE BOOL INTERNAL)
+set(BENCHMARK_ENABLE_INSTALL OFF CACHE BOOL INTERNAL)
+set(BENCHMARK_ENABLE_GTEST_TESTS OFF CACHE BOOL INTERNAL)
+# Newer compilers warn in the bundled sources, which must not fail the optimized builds
+set(BENCHMARK_ENABLE_WERROR OFF CACHE BOOL INTERNAL)
+
+add_subdirectory(${CMAKE_CURRENT_LIST_DIR}/thirdparty/benchmark)
@@ -0,0 +1,5 @@
+set(ENABLE_INSTRUMENTATION OFF CACHE BOOL "record per-phase timers and counters of the jit, they are compiled out otherwise")
+
+if (ENABLE_INSTRUMENTATION)
+   add_compile_definitions(PLJIT_INSTRUMENTATION)
+endif ()
@@ -8,6 +8,7 @@ set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -Wall -Wextra -Wpedantic")
 
 include(EnableAddressSanitizer)
 include(EnableUndefinedSanitizer)
+include(EnableInstrumentation)
 include(clang-tidy)
 include(BundledGTest)
 
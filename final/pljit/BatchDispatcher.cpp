@@ -0,0 +1,90 @@
+#include "pljit/BatchDispatcher.hpp"
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+// Constructor
+BatchDispatcher::BatchDispatcher(PljitHandle& handle, BatchOptions options) : handle(handle), options(options) {
+    if (this->options.maxBatchSize == 0) {
+        this->options.maxBatchSize = 1;
+    }
+    worker = thread([this] { run(); });
+}
+//---------------------------------------------------------------------------
+// Destructor
+BatchDispatcher::~BatchDispatcher() {
+    {
+        unique_lock lock(pendingMutex);
+        stopping = true;
+    }
+    pendingCondition.notify_one();
+    worker.join();
+}
+//---------------------------------------------------------------------------
+// Queue a call
+future<optional<int64_t>> BatchDispatcher::submit(vector<int64_t> parameters) {
+    promise<optional<int64_t>> result;
+    future<optional<int64_t>> resultFuture = result.get_future();
+    size_t pending;
+    {
+        unique_lock lock(pendingMutex);
+        pendingParameters.push_back(move(parameters));
+        pendingPromises.push_back(move(result));
+        pending = pendingParameters.size();
+    }
+    // The dispatcher only has to wake up for the first call and for a full batch
+    if (pending == 1 || pending == options.maxBatchSize) {
+        pendingCondition.notify_one();
+    }
+    return resultFuture;
+}
+//---------------------------------------------------------------------------
+// Collect and evaluate batches until the dispatcher is destroyed
+void BatchDispatcher::run() {
+    vector<vector<int64_t>> batchParameters;
+    vector<promise<optional<int64_t>>> batchPromises;
+    // A single call after an idle period is evaluated immediately, the window is only used under concurrent load
+    bool concurrentLoad = false;
+
+    while (true) {
+        bool waited = false;
+        {
+            unique_lock lock(pendingMutex);
+            pendingCondition.wait(lock, [this] { return stopping || !pendingParameters.empty(); });
+            if (pendingParameters.empty()) {
+                return;
+            }
+
+            if (concurrentLoad && !stopping && pendingParameters.size() < options.maxBatchSize) {
+                pendingCondition.wait_for(lock, options.window, [this] { return stopping || pendingParameters.size() >= options.maxBatchSize; });
+                waited = true;
+            }
+
+            size_t batchSize = min(pendingParameters.size(), options.maxBatchSize);
+            auto parametersEnd = pendingParameters.begin() + static_cast<ptrdiff_t>(batchSize);
+            auto promisesEnd = pendingPromises.begin() + static_cast<ptrdiff_t>(batchSize);
+            batchParameters.assign(make_move_iterator(pendingParameters.begin()), make_move_iterator(parametersEnd));
+            batchPromises.assign(make_move_iterator(pendingPromises.begin()), make_move_iterator(promisesEnd));
+            pendingParameters.erase(pendingParameters.begin(), parametersEnd);
+            pendingPromises.erase(pendingPromises.begin(), promisesEnd);
+
+            statistics.calls += batchSize;
+            statistics.batches++;
+            statistics.waitedBatches += waited;
+        }
+
+        vector<optional<int64_t>> results = handle.evaluateBatch(batchParameters);
+        for (size_t i = 0; i < results.size(); i++) {
+            batchPromises[i].set_value(results[i]);
+        }
+        concurrentLoad = results.size() > 1;
+    }
+}
+//---------------------------------------------------------------------------
+// Return the statistics of the dispatcher
+BatchStatistics BatchDispatcher::getStatistics() const {
+    unique_lock lock(pendingMutex);
+    return statistics;
+}
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
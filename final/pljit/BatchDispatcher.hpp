@@ -0,0 +1,66 @@
+#ifndef H_PLJIT_BATCHDISPATCHER
+#define H_PLJIT_BATCHDISPATCHER
+#include "pljit/Pljit.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <thread>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+/// Struct that represents the limits of a batch
+struct BatchOptions {
+    /// Maximum number of calls in a batch
+    size_t maxBatchSize = 64;
+    /// Maximum time the first call of a batch waits for further calls
+    chrono::microseconds window = chrono::microseconds(20);
+};
+/// Struct that represents the statistics of a dispatcher
+struct BatchStatistics {
+    /// Number of evaluated calls
+    size_t calls = 0;
+    /// Number of evaluated batches
+    size_t batches = 0;
+    /// Number of batches that waited for the window
+    size_t waitedBatches = 0;
+};
+/// Class that collects concurrent calls of a function and evaluates them as one batch
+class BatchDispatcher {
+    public:
+    /// Constructor, the handle has to outlive the dispatcher
+    explicit BatchDispatcher(PljitHandle& handle, BatchOptions options = BatchOptions());
+    /// Destructor, evaluates the pending calls before the thread is joined
+    ~BatchDispatcher();
+    /// Queue a call, the future is completed when its batch was evaluated
+    future<optional<int64_t>> submit(vector<int64_t> parameters);
+    /// Function call that blocks until the batch of the call was evaluated
+    optional<int64_t> operator()(vector<int64_t> parameters) { return submit(move(parameters)).get(); }
+    /// Return the statistics of the dispatcher
+    BatchStatistics getStatistics() const;
+
+    private:
+    /// Collect and evaluate batches until the dispatcher is destroyed
+    void run();
+    /// Storage of the handle
+    PljitHandle& handle;
+    /// Storage of the limits of a batch
+    BatchOptions options;
+    /// Storage of the parameters of the pending calls
+    vector<vector<int64_t>> pendingParameters;
+    /// Storage of the promises of the pending calls
+    vector<promise<optional<int64_t>>> pendingPromises;
+    /// Storage of the mutex that protects the pending calls and the statistics
+    mutable mutex pendingMutex;
+    /// Storage of the condition variable that signals new calls
+    condition_variable pendingCondition;
+    /// Storage of the statistics
+    BatchStatistics statistics;
+    /// Storage of whether the dispatcher is destroyed
+    bool stopping = false;
+    /// Storage of the thread
+    thread worker;
+};
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
+#endif // H_PLJIT_BATCHDISPATCHER
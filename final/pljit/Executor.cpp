@@ -0,0 +1,45 @@
+#include "pljit/Executor.hpp"
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+// Constructor
+ThreadExecutor::ThreadExecutor() : worker([this] { run(); }) {}
+//---------------------------------------------------------------------------
+// Destructor
+ThreadExecutor::~ThreadExecutor() {
+    {
+        unique_lock lock(queueMutex);
+        stopping = true;
+    }
+    queueCondition.notify_one();
+    worker.join();
+}
+//---------------------------------------------------------------------------
+// Queue the work
+void ThreadExecutor::execute(function<void()> work) {
+    {
+        unique_lock lock(queueMutex);
+        queue.push_back(move(work));
+    }
+    queueCondition.notify_one();
+}
+//---------------------------------------------------------------------------
+// Run the queued work until the executor is destroyed
+void ThreadExecutor::run() {
+    while (true) {
+        function<void()> work;
+        {
+            unique_lock lock(queueMutex);
+            queueCondition.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (queue.empty()) {
+                return;
+            }
+            work = move(queue.front());
+            queue.pop_front();
+        }
+        work();
+    }
+}
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
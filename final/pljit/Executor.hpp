@@ -0,0 +1,63 @@
+#ifndef H_PLJIT_EXECUTOR
+#define H_PLJIT_EXECUTOR
+#include <condition_variable>
+#include <coroutine>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+using namespace std;
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+/// Class that represents a place where work runs, coroutines are resumed on it by awaiting schedule()
+class Executor {
+    public:
+    /// Awaitable that resumes the awaiting coroutine on the executor
+    struct ScheduleAwaiter {
+        Executor& executor;
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(coroutine_handle<> handle) { executor.execute([handle] { handle.resume(); }); }
+        void await_resume() const noexcept {}
+    };
+    /// Destructor
+    virtual ~Executor() = default;
+    /// Run the work, it may run before the call returns
+    virtual void execute(function<void()> work) = 0;
+    /// Return an awaitable that moves the awaiting coroutine to the executor
+    ScheduleAwaiter schedule() { return ScheduleAwaiter{*this}; }
+};
+/// Class that represents an executor that runs the work on the calling thread
+class InlineExecutor : public Executor {
+    public:
+    /// Run the work immediately
+    void execute(function<void()> work) override { work(); }
+};
+/// Class that represents an executor that runs the work in order on a single background thread
+class ThreadExecutor : public Executor {
+    public:
+    /// Constructor
+    ThreadExecutor();
+    /// Destructor, runs the remaining work before the thread is joined
+    ~ThreadExecutor() override;
+    /// Queue the work
+    void execute(function<void()> work) override;
+
+    private:
+    /// Run the queued work until the executor is destroyed
+    void run();
+    /// Storage of the queued work
+    deque<function<void()>> queue;
+    /// Storage of the mutex that protects the queue
+    mutex queueMutex;
+    /// Storage of the condition variable that signals new work
+    condition_variable queueCondition;
+    /// Storage of whether the executor is destroyed
+    bool stopping = false;
+    /// Storage of the thread
+    thread worker;
+};
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
+#endif // H_PLJIT_EXECUTOR
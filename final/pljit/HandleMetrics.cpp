@@ -0,0 +1,137 @@
+#include "pljit/HandleMetrics.hpp"
+#include <bit>
+#include <cmath>
+#include <memory>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+// Constructor
+HistogramSnapshot::HistogramSnapshot() : counts(LatencyHistogram::bucketCount) {
+}
+//---------------------------------------------------------------------------
+// Return the latency below which the given share of the values lies
+chrono::nanoseconds HistogramSnapshot::percentile(double share) const {
+    if (total == 0) {
+        return chrono::nanoseconds(0);
+    }
+
+    auto rank = max<uint64_t>(static_cast<uint64_t>(ceil(share * static_cast<double>(total))), 1);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < counts.size(); i++) {
+        seen += counts[i];
+        if (seen >= rank) {
+            return chrono::nanoseconds(static_cast<int64_t>(min<uint64_t>(LatencyHistogram::getUpperBound(i), INT64_MAX)));
+        }
+    }
+    return chrono::nanoseconds(INT64_MAX);
+}
+//---------------------------------------------------------------------------
+// Add the counts of another histogram
+void HistogramSnapshot::merge(const HistogramSnapshot& other) {
+    for (size_t i = 0; i < counts.size(); i++) {
+        counts[i] += other.counts[i];
+    }
+    total += other.total;
+}
+//---------------------------------------------------------------------------
+// Record a latency
+void LatencyHistogram::record(chrono::nanoseconds latency) {
+    uint64_t value = latency.count() > 0 ? static_cast<uint64_t>(latency.count()) : 0;
+    counts[getBucket(value)].fetch_add(1, memory_order_relaxed);
+}
+//---------------------------------------------------------------------------
+// Return the counts
+HistogramSnapshot LatencyHistogram::getSnapshot() const {
+    HistogramSnapshot snapshot;
+    for (size_t i = 0; i < bucketCount; i++) {
+        snapshot.counts[i] = counts[i].load(memory_order_relaxed);
+        snapshot.total += snapshot.counts[i];
+    }
+    return snapshot;
+}
+//---------------------------------------------------------------------------
+// Return the bucket of a value
+size_t LatencyHistogram::getBucket(uint64_t value) {
+    // Small values have a bucket each, larger ones are split by their highest bit and the following subBucketBits bits
+    if (value < subBucketCount) {
+        return value;
+    }
+    size_t exponent = bit_width(value) - 1;
+    size_t shift = exponent - subBucketBits;
+    return (shift + 1) * subBucketCount + ((value >> shift) & (subBucketCount - 1));
+}
+//---------------------------------------------------------------------------
+// Return the largest value of a bucket
+uint64_t LatencyHistogram::getUpperBound(size_t bucket) {
+    if (bucket < subBucketCount) {
+        return bucket;
+    }
+    size_t shift = bucket / subBucketCount - 1;
+    uint64_t lowerBound = (subBucketCount + bucket % subBucketCount) << shift;
+    return lowerBound + ((uint64_t(1) << shift) - 1);
+}
+//---------------------------------------------------------------------------
+// Add the metrics of another snapshot
+void MetricsSnapshot::merge(const MetricsSnapshot& other) {
+    calls += other.calls;
+    compileErrors += other.compileErrors;
+    parameterCountErrors += other.parameterCountErrors;
+    divisionByZeroErrors += other.divisionByZeroErrors;
+    fuelExhaustedErrors += other.fuelExhaustedErrors;
+    overflowErrors += other.overflowErrors;
+    lockWait += other.lockWait;
+    latency.merge(other.latency);
+}
+//---------------------------------------------------------------------------
+// Destructor
+HandleMetrics::~HandleMetrics() {
+    delete latency.load(memory_order_relaxed);
+}
+//---------------------------------------------------------------------------
+// Record a single call with its latency
+void HandleMetrics::recordCall(CallOutcome outcome, chrono::nanoseconds latency1) {
+    recordCall(outcome);
+    LatencyHistogram* histogram = latency.load(memory_order_acquire);
+    if (!histogram) {
+        // A concurrent call may have created the histogram first, its histogram is used then
+        auto created = make_unique<LatencyHistogram>();
+        if (latency.compare_exchange_strong(histogram, created.get(), memory_order_acq_rel)) {
+            histogram = created.release();
+        }
+    }
+    histogram->record(latency1);
+}
+//---------------------------------------------------------------------------
+// Record a call of a batch
+void HandleMetrics::recordCall(CallOutcome outcome) {
+    recordCalls(outcome, 1);
+}
+//---------------------------------------------------------------------------
+// Record several calls of a batch with the same outcome
+void HandleMetrics::recordCalls(CallOutcome outcome, uint64_t count) {
+    if (count == 0) {
+        return;
+    }
+    calls.fetch_add(count, memory_order_relaxed);
+    outcomes[static_cast<size_t>(outcome)].fetch_add(count, memory_order_relaxed);
+}
+//---------------------------------------------------------------------------
+// Return the metrics
+MetricsSnapshot HandleMetrics::getSnapshot() const {
+    MetricsSnapshot snapshot;
+    snapshot.functionId = functionId;
+    snapshot.calls = calls.load(memory_order_relaxed);
+    snapshot.compileErrors = outcomes[static_cast<size_t>(CallOutcome::CompileError)].load(memory_order_relaxed);
+    snapshot.parameterCountErrors = outcomes[static_cast<size_t>(CallOutcome::ParameterCountError)].load(memory_order_relaxed);
+    snapshot.divisionByZeroErrors = outcomes[static_cast<size_t>(CallOutcome::DivisionByZero)].load(memory_order_relaxed);
+    snapshot.fuelExhaustedErrors = outcomes[static_cast<size_t>(CallOutcome::FuelExhausted)].load(memory_order_relaxed);
+    snapshot.overflowErrors = outcomes[static_cast<size_t>(CallOutcome::Overflow)].load(memory_order_relaxed);
+    snapshot.lockWait = chrono::nanoseconds(lockWait.load(memory_order_relaxed));
+    if (const LatencyHistogram* histogram = latency.load(memory_order_acquire)) {
+        snapshot.latency = histogram->getSnapshot();
+    }
+    return snapshot;
+}
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
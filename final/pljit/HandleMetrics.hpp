@@ -0,0 +1,119 @@
+#ifndef H_PLJIT_HANDLEMETRICS
+#define H_PLJIT_HANDLEMETRICS
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+using namespace std;
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+/// All possible outcomes of a call
+enum class CallOutcome {
+    Success,
+    CompileError,
+    ParameterCountError,
+    DivisionByZero,
+    FuelExhausted,
+    Overflow
+};
+/// Number of possible outcomes of a call
+constexpr size_t callOutcomeCount = 6;
+/// Struct that represents the counts of a latency histogram at one point in time
+struct HistogramSnapshot {
+    /// Constructor
+    HistogramSnapshot();
+    /// Storage of the count of every bucket
+    vector<uint64_t> counts;
+    /// Storage of the number of recorded values
+    uint64_t total = 0;
+    /// Return the latency below which the given share of the values lies, it is the upper bound of its bucket
+    chrono::nanoseconds percentile(double share) const;
+    /// Add the counts of another histogram
+    void merge(const HistogramSnapshot& other);
+};
+/// Class that represents a lock-free histogram of latencies with logarithmic buckets that are split linearly
+/// Every power of two is divided into subBucketCount buckets, so a bucket is at most 1/subBucketCount of its values wide.
+class LatencyHistogram {
+    public:
+    /// Number of linear buckets per power of two
+    static constexpr size_t subBucketBits = 4;
+    static constexpr size_t subBucketCount = 1 << subBucketBits;
+    /// Number of buckets to cover all 64 bit values
+    static constexpr size_t bucketCount = (64 - subBucketBits + 1) * subBucketCount;
+    /// Constructor
+    LatencyHistogram() = default;
+    /// Record a latency
+    void record(chrono::nanoseconds latency);
+    /// Return the counts
+    HistogramSnapshot getSnapshot() const;
+    /// Return the bucket of a value
+    static size_t getBucket(uint64_t value);
+    /// Return the largest value of a bucket
+    static uint64_t getUpperBound(size_t bucket);
+
+    private:
+    /// Storage of the count of every bucket
+    array<atomic<uint64_t>, bucketCount> counts{};
+};
+/// Struct that represents the metrics of one or more handles at one point in time
+struct MetricsSnapshot {
+    /// Id of the handle, 0 for the aggregate of several handles
+    uint64_t functionId = 0;
+    /// Number of calls
+    uint64_t calls = 0;
+    /// Number of calls of a function that did not compile
+    uint64_t compileErrors = 0;
+    /// Number of calls with the wrong number of parameters
+    uint64_t parameterCountErrors = 0;
+    /// Number of calls that divided by zero
+    uint64_t divisionByZeroErrors = 0;
+    /// Number of calls that were aborted because their fuel was exhausted
+    uint64_t fuelExhaustedErrors = 0;
+    /// Number of calls that overflowed in the trapping arithmetic mode
+    uint64_t overflowErrors = 0;
+    /// Accumulated time spent waiting for the mutex of the handle
+    chrono::nanoseconds lockWait{0};
+    /// Latencies of the single calls
+    HistogramSnapshot latency;
+    /// Add the metrics of another snapshot
+    void merge(const MetricsSnapshot& other);
+};
+/// Class that represents the metrics of a handle, all counters are updated without a lock
+/// The latency histogram is only allocated by the first single call, so an idle handle keeps its metrics small.
+class HandleMetrics {
+    public:
+    /// Constructor
+    explicit HandleMetrics(uint64_t functionId) : functionId(functionId) {}
+    /// Destructor
+    ~HandleMetrics();
+    /// Metrics are not copyable
+    HandleMetrics(const HandleMetrics&) = delete;
+    HandleMetrics& operator=(const HandleMetrics&) = delete;
+    /// Record a single call with its latency
+    void recordCall(CallOutcome outcome, chrono::nanoseconds latency);
+    /// Record a call of a batch, its latency is not measured separately
+    void recordCall(CallOutcome outcome);
+    /// Record several calls of a batch with the same outcome at once
+    void recordCalls(CallOutcome outcome, uint64_t count);
+    /// Record a wait for the mutex of the handle
+    void recordLockWait(chrono::nanoseconds wait) { lockWait.fetch_add(wait.count(), memory_order_relaxed); }
+    /// Return the metrics
+    MetricsSnapshot getSnapshot() const;
+
+    private:
+    /// Storage of the id of the handle
+    uint64_t functionId;
+    /// Storage of the counters
+    atomic<uint64_t> calls = 0;
+    array<atomic<uint64_t>, callOutcomeCount> outcomes{};
+    atomic<int64_t> lockWait = 0;
+    /// Storage of the latencies, nullptr until the first latency is recorded
+    atomic<LatencyHistogram*> latency = nullptr;
+};
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
+#endif // H_PLJIT_HANDLEMETRICS
+//---------------------------------------------------------------------------
@@ -0,0 +1,239 @@
+#include "pljit/IncrementalCompiler.hpp"
+#include "pljit/ast/ASTCloner.hpp"
+#include <algorithm>
+#include <set>
+using namespace pljit::semanticanalysis;
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+// Compile a version of the code
+unique_ptr<Function> IncrementalCompiler::compile(shared_ptr<const string> newCode) {
+    if (entries.empty()) {
+        return compileFull(move(newCode));
+    }
+
+    bool failed = false;
+    unique_ptr<Function> function = compileChanged(newCode, failed);
+    if (failed) {
+        return nullptr;
+    }
+    if (!function) {
+        return compileFull(move(newCode));
+    }
+    return function;
+}
+//---------------------------------------------------------------------------
+// Return the codes the names of the last compiled function refer to
+vector<shared_ptr<const string>> IncrementalCompiler::getSources() const {
+    vector<shared_ptr<const string>> sources = {declarationSource};
+    for (const auto& entry : entries) {
+        if (find(sources.begin(), sources.end(), entry.source) == sources.end()) {
+            sources.push_back(entry.source);
+        }
+    }
+    return sources;
+}
+//---------------------------------------------------------------------------
+// Compile the whole code
+unique_ptr<Function> IncrementalCompiler::compileFull(shared_ptr<const string> newCode) {
+    shared_ptr<CodeManagement> codeM = make_shared<CodeManagement>(*newCode);
+    Lexer lexer(*newCode, codeM);
+    Parsing parser(lexer, codeM);
+    parser.parsing();
+
+    if (parser.errorOccurred()) {
+        return nullptr;
+    }
+
+    SemanticAnalysis semanticAnalysis(codeM, resource);
+    Function function = semanticAnalysis.getAST(parser);
+
+    if (function.errorOccurred()) {
+        return nullptr;
+    }
+
+    // The code is known to be valid, so the body is found by skipping the tokens up to BEGIN
+    Lexer bodyLexer(*newCode, codeM);
+    while (bodyLexer.next().tokenType() != Token::TokenType::BeginKeyword) {
+    }
+    vector<pair<size_t, size_t>> ranges = splitStatements(bodyLexer);
+
+    entries.clear();
+    ASTCloner astCloner(resource);
+    for (size_t i = 0; i < ranges.size(); i++) {
+        StatementEntry entry;
+        tie(entry.begin, entry.end) = ranges[i];
+        entry.statement = astCloner.clone(*function.getStatements()[i]);
+        entry.source = newCode;
+        entries.push_back(move(entry));
+    }
+
+    code = newCode;
+    declarationSource = newCode;
+    declarations = semanticAnalysis.getDeclarations();
+
+    statistics = UpdateStatistics();
+    statistics.analyzedStatements = entries.size();
+    return allocateNode<Function>(resource, move(function));
+}
+//---------------------------------------------------------------------------
+// Compile only the statements around the changed characters
+unique_ptr<Function> IncrementalCompiler::compileChanged(const shared_ptr<const string>& newCode, bool& failed) {
+    const string& oldText = *code;
+    const string& newText = *newCode;
+
+    // The changed characters are [prefix, oldText.size() - suffix) in the old and [prefix, newText.size() - suffix) in the new code
+    size_t limit = min(oldText.size(), newText.size());
+    size_t prefix = mismatch(oldText.begin(), oldText.begin() + static_cast<ptrdiff_t>(limit), newText.begin()).first - oldText.begin();
+    size_t suffix = 0;
+    while (suffix < limit - prefix && oldText[oldText.size() - suffix - 1] == newText[newText.size() - suffix - 1]) {
+        suffix++;
+    }
+    size_t changeEnd = oldText.size() - suffix;
+
+    // A change of the declarations or of the end of the function needs a full compilation
+    if (prefix < entries.front().begin || changeEnd > entries.back().end) {
+        return nullptr;
+    }
+
+    // The neighbours of the changed statements are analyzed as well, since a changed separator can merge them
+    size_t first = 0;
+    while (entries[first].end < prefix) {
+        first++;
+    }
+    first = first > 0 ? first - 1 : 0;
+    size_t last = entries.size() - 1;
+    while (entries[last].begin > changeEnd) {
+        last--;
+    }
+    last = min(last + 1, entries.size() - 1);
+
+    auto delta = static_cast<ptrdiff_t>(newText.size()) - static_cast<ptrdiff_t>(oldText.size());
+    size_t regionBegin = entries[first].begin;
+    auto regionEnd = static_cast<size_t>(static_cast<ptrdiff_t>(entries[last].end) + delta);
+    if (regionEnd <= regionBegin) {
+        return nullptr;
+    }
+
+    // The region is lexed from a copy that ends with a dot, the positions still refer to the new code
+    shared_ptr<CodeManagement> codeM = make_shared<CodeManagement>(newText);
+    string region = newText.substr(regionBegin, regionEnd - regionBegin) + ".";
+    Lexer lexer(region.data(), regionBegin, codeM);
+    Parsing parser(lexer, codeM);
+    parser.parsingStatements();
+
+    if (parser.errorOccurred()) {
+        failed = true;
+        return nullptr;
+    }
+
+    SymbolTable scope = declarations;
+    for (size_t i = 0; i < first; i++) {
+        string_view assignedName = getAssignedName(*entries[i].statement);
+        if (!assignedName.empty()) {
+            scope.initialize(assignedName);
+        }
+    }
+
+    SemanticAnalysis semanticAnalysis(codeM, resource);
+    vector<unique_ptr<ASTNode>> statements;
+    if (semanticAnalysis.errorAnalyzeStatements(parser.getStatementList(), move(scope), statements)) {
+        failed = true;
+        return nullptr;
+    }
+
+    // The following statements stay valid if every variable the old region initialized is still initialized
+    // The return statement counts as the empty name, so a region that contained it still contains one
+    set<string_view> oldAssigned;
+    set<string_view> newAssigned;
+    for (size_t i = first; i <= last; i++) {
+        oldAssigned.insert(getAssignedName(*entries[i].statement));
+    }
+    for (const auto& statement : statements) {
+        newAssigned.insert(getAssignedName(*statement));
+    }
+    if (!includes(newAssigned.begin(), newAssigned.end(), oldAssigned.begin(), oldAssigned.end())) {
+        return nullptr;
+    }
+
+    Lexer regionLexer(region.data(), regionBegin, codeM);
+    vector<pair<size_t, size_t>> ranges = splitStatements(regionLexer);
+
+    vector<StatementEntry> newEntries;
+    for (size_t i = 0; i < first; i++) {
+        newEntries.push_back(move(entries[i]));
+    }
+    for (size_t i = 0; i < statements.size(); i++) {
+        StatementEntry entry;
+        tie(entry.begin, entry.end) = ranges[i];
+        entry.statement = move(statements[i]);
+        entry.source = newCode;
+        newEntries.push_back(move(entry));
+    }
+    for (size_t i = last + 1; i < entries.size(); i++) {
+        entries[i].begin = static_cast<size_t>(static_cast<ptrdiff_t>(entries[i].begin) + delta);
+        entries[i].end = static_cast<size_t>(static_cast<ptrdiff_t>(entries[i].end) + delta);
+        newEntries.push_back(move(entries[i]));
+    }
+
+    entries = move(newEntries);
+    code = newCode;
+
+    statistics = UpdateStatistics();
+    statistics.fullCompilation = false;
+    statistics.analyzedStatements = statements.size();
+    statistics.reusedStatements = entries.size() - statements.size();
+    return buildFunction();
+}
+//---------------------------------------------------------------------------
+// Build the function from the entries
+unique_ptr<Function> IncrementalCompiler::buildFunction() const {
+    ASTCloner astCloner(resource);
+    vector<unique_ptr<ASTNode>> statements;
+    for (const auto& entry : entries) {
+        statements.push_back(astCloner.clone(*entry.statement));
+        // The statements of a region were numbered within the region
+        static_cast<ASTStatement&>(*statements.back()).setSourceIndex(statements.size() - 1);
+    }
+    return allocateNode<Function>(resource, move(statements), OptimizationTable(declarations));
+}
+//---------------------------------------------------------------------------
+// Return the ranges of the statements in a code that was parsed without errors
+vector<pair<size_t, size_t>> IncrementalCompiler::splitStatements(Lexer& lexer) {
+    vector<pair<size_t, size_t>> ranges;
+    // A statement is open once its first token was read, it ends after its last token
+    bool open = false;
+    size_t begin = 0;
+    size_t end = 0;
+
+    for (Token token = lexer.next();; token = lexer.next()) {
+        Token::TokenType type = token.tokenType();
+        if (type == Token::TokenType::EndLineSeparator || type == Token::TokenType::EndKeyword || type == Token::TokenType::Dot || type == Token::TokenType::EndToken) {
+            if (open) {
+                ranges.emplace_back(begin, end);
+                open = false;
+            }
+            if (type != Token::TokenType::EndLineSeparator) {
+                return ranges;
+            }
+            continue;
+        }
+        if (!open) {
+            begin = token.reference().begin;
+            open = true;
+        }
+        end = token.reference().begin + token.reference().length;
+    }
+}
+//---------------------------------------------------------------------------
+// Return the variable a statement assigns to
+string_view IncrementalCompiler::getAssignedName(const ASTNode& statement) {
+    const auto& expression = static_cast<const ASTStatement&>(statement).getExpression();
+    if (expression.getType() == ASTNode::Type::AssignmentExpr) {
+        return static_cast<const AssignmentExpr&>(expression).getName();
+    }
+    return {};
+}
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
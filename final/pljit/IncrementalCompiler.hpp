@@ -0,0 +1,69 @@
+#ifndef H_PLJIT_INCREMENTALCOMPILER
+#define H_PLJIT_INCREMENTALCOMPILER
+#include "pljit/semantic/SemanticAnalysis.hpp"
+#include <memory>
+#include <string>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+/// Struct that represents how much of a function an update had to analyze again
+struct UpdateStatistics {
+    /// Whether the whole function was compiled again
+    bool fullCompilation = true;
+    /// Number of statements whose ast was reused
+    size_t reusedStatements = 0;
+    /// Number of statements that were parsed and analyzed again
+    size_t analyzedStatements = 0;
+};
+/// Class that compiles versions of a function and only analyzes the statements that changed since the last version
+/// The declarations and the parts before and after the changed statements are compared textually with the last version.
+/// The returned functions are not optimized, their names refer to the codes returned by getSources.
+class IncrementalCompiler {
+    public:
+    /// Constructor, the asts are allocated from the memory resource
+    explicit IncrementalCompiler(pmr::memory_resource* resource = pmr::get_default_resource()) : resource(resource), declarations(resource) {}
+    /// Compile a version of the code, returns nullptr on error and keeps the last version in that case
+    unique_ptr<Function> compile(shared_ptr<const string> newCode);
+    /// Return the statistics of the last successful compilation
+    const UpdateStatistics& getStatistics() const { return statistics; }
+    /// Return the codes the names of the last compiled function refer to
+    vector<shared_ptr<const string>> getSources() const;
+
+    private:
+    /// Struct that represents an analyzed statement of the current version
+    struct StatementEntry {
+        /// Position of the first character and the position after the last character in the current code
+        size_t begin = 0;
+        size_t end = 0;
+        /// Storage of the analyzed, unoptimized statement
+        unique_ptr<ASTNode> statement;
+        /// Storage of the code the statement was analyzed in
+        shared_ptr<const string> source;
+    };
+    /// Compile the whole code
+    unique_ptr<Function> compileFull(shared_ptr<const string> newCode);
+    /// Compile only the statements around the changed characters, returns nullptr if the whole code has to be compiled
+    unique_ptr<Function> compileChanged(const shared_ptr<const string>& newCode, bool& failed);
+    /// Build the function from the entries
+    unique_ptr<Function> buildFunction() const;
+    /// Return the ranges of the statements in a code that was parsed without errors, the lexer starts inside the body
+    static vector<pair<size_t, size_t>> splitStatements(Lexer& lexer);
+    /// Return the variable a statement assigns to, an empty name for a return statement
+    static string_view getAssignedName(const ASTNode& statement);
+    /// Storage of the memory resource of the asts
+    pmr::memory_resource* resource;
+    /// Storage of the current code
+    shared_ptr<const string> code;
+    /// Storage of the code the declarations were analyzed in
+    shared_ptr<const string> declarationSource;
+    /// Storage of the declared symbols
+    SymbolTable declarations;
+    /// Storage of the statements of the current version
+    vector<StatementEntry> entries;
+    /// Storage of the statistics of the last compilation
+    UpdateStatistics statistics;
+};
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
+#endif // H_PLJIT_INCREMENTALCOMPILER
@@ -0,0 +1,44 @@
+#include "pljit/Instrumentation.hpp"
+#include <sstream>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+// Return the name of a phase
+string_view InstrumentationSnapshot::getName(Phase phase) {
+    switch (phase) {
+        case Phase::Lexing: return "lexing";
+        case Phase::Parsing: return "parsing";
+        case Phase::SemanticAnalysis: return "semanticAnalysis";
+        case Phase::Optimization: return "optimization";
+        case Phase::Evaluation: return "evaluation";
+        case Phase::LockWait: return "lockWait";
+    }
+    return "";
+}
+//---------------------------------------------------------------------------
+// Return the measurements as a json object
+string InstrumentationSnapshot::toJSON() const {
+    stringstream out;
+    out << "{\"enabled\":" << (enabled ? "true" : "false") << ",\"phases\":{";
+    for (size_t i = 0; i < phaseCount; i++) {
+        out << (i == 0 ? "" : ",") << "\"" << getName(static_cast<Phase>(i)) << "\":{\"count\":" << counts[i] << ",\"nanoseconds\":" << durations[i].count() << "}";
+    }
+    out << "},\"nodes\":" << nodes << ",\"allocations\":" << allocations << "}";
+    return out.str();
+}
+//---------------------------------------------------------------------------
+// Return the measurements
+InstrumentationSnapshot Instrumentation::getSnapshot() const {
+    InstrumentationSnapshot snapshot;
+    snapshot.enabled = enabled;
+    for (size_t i = 0; i < phaseCount; i++) {
+        snapshot.durations[i] = chrono::nanoseconds(durations[i].load(memory_order_relaxed));
+        snapshot.counts[i] = counts[i].load(memory_order_relaxed);
+    }
+    snapshot.nodes = nodes.load(memory_order_relaxed);
+    snapshot.allocations = allocations.load(memory_order_relaxed);
+    return snapshot;
+}
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
@@ -0,0 +1,102 @@
+#ifndef H_PLJIT_INSTRUMENTATION
+#define H_PLJIT_INSTRUMENTATION
+#include "pljit/Tracer.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <string>
+using namespace std;
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+/// All measured phases of a function handle
+enum class Phase {
+    Lexing,
+    Parsing,
+    SemanticAnalysis,
+    Optimization,
+    Evaluation,
+    LockWait
+};
+/// Number of measured phases
+constexpr size_t phaseCount = 6;
+/// Struct that represents the measurements of a function handle at one point in time
+struct InstrumentationSnapshot {
+    /// Accumulated wall time of every phase
+    array<chrono::nanoseconds, phaseCount> durations{};
+    /// Number of times every phase was entered
+    array<size_t, phaseCount> counts{};
+    /// Number of ast nodes of the last compiled function
+    size_t nodes = 0;
+    /// Approximate number of allocations, every ast node built by the semantic analysis or a pass is one allocation
+    size_t allocations = 0;
+    /// Whether the measurements were compiled in
+    bool enabled = false;
+    /// Getters
+    chrono::nanoseconds getDuration(Phase phase) const { return durations[static_cast<size_t>(phase)]; }
+    size_t getCount(Phase phase) const { return counts[static_cast<size_t>(phase)]; }
+    /// Return the name of a phase
+    static string_view getName(Phase phase);
+    /// Return the measurements as a json object
+    string toJSON() const;
+};
+/// Class that records the measurements of a function handle, all functions are empty unless PLJIT_INSTRUMENTATION is defined
+class Instrumentation {
+    public:
+    /// Type of a point in time
+    using TimePoint = chrono::steady_clock::time_point;
+#ifdef PLJIT_INSTRUMENTATION
+    static constexpr bool enabled = true;
+#else
+    static constexpr bool enabled = false;
+#endif
+    /// Constructor, the function id tags the spans of the handle in a trace
+    explicit Instrumentation(uint64_t functionId = 0) : functionId(functionId) {}
+    /// Return the current time, it is only taken if the measurements are compiled in or a tracer is active
+    static TimePoint now() {
+        if (enabled || Tracer::isActive()) {
+            return chrono::steady_clock::now();
+        }
+        return TimePoint();
+    }
+    /// Add one execution of a phase that started at begin, it becomes a span in an active trace
+    void record(Phase phase, TimePoint begin, chrono::nanoseconds duration) {
+        if constexpr (enabled) {
+            durations[static_cast<size_t>(phase)].fetch_add(duration.count(), memory_order_relaxed);
+            counts[static_cast<size_t>(phase)].fetch_add(1, memory_order_relaxed);
+        }
+        if (Tracer::isActive()) {
+            Tracer::record(InstrumentationSnapshot::getName(phase), functionId, begin, duration);
+        }
+    }
+    /// Add the time since begin to a phase
+    void recordSince(Phase phase, TimePoint begin) {
+        if (enabled || Tracer::isActive()) {
+            record(phase, begin, now() - begin);
+        }
+    }
+    /// Record the result of a compilation
+    void recordCompilation(size_t nodes1, size_t allocations1) {
+        if constexpr (enabled) {
+            nodes.store(nodes1, memory_order_relaxed);
+            allocations.fetch_add(allocations1, memory_order_relaxed);
+        }
+    }
+    /// Return the measurements
+    InstrumentationSnapshot getSnapshot() const;
+
+    private:
+    /// Storage of the id of the function in a trace
+    uint64_t functionId;
+    /// Storage of the accumulated durations in nanoseconds
+    array<atomic<int64_t>, phaseCount> durations{};
+    /// Storage of the counters
+    array<atomic<size_t>, phaseCount> counts{};
+    atomic<size_t> nodes = 0;
+    atomic<size_t> allocations = 0;
+};
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
+#endif // H_PLJIT_INSTRUMENTATION
+//---------------------------------------------------------------------------
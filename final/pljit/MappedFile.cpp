@@ -0,0 +1,92 @@
+#include "pljit/MappedFile.hpp"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <utility>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+// Constructor
+MappedFile::MappedFile(const string& path) {
+    int file = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (file < 0) {
+        return;
+    }
+
+    struct stat status {};
+    if (fstat(file, &status) != 0) {
+        close(file);
+        return;
+    }
+
+    // An empty file cannot be mapped, its contents are an empty view
+    size = static_cast<size_t>(status.st_size);
+    if (size > 0) {
+        void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+        if (mapping == MAP_FAILED) {
+            size = 0;
+            close(file);
+            return;
+        }
+        data = static_cast<const char*>(mapping);
+        madvise(mapping, size, MADV_SEQUENTIAL);
+    }
+    close(file);
+    open = true;
+}
+//---------------------------------------------------------------------------
+// Destructor
+MappedFile::~MappedFile() {
+    unmap();
+}
+//---------------------------------------------------------------------------
+// Move constructor
+MappedFile::MappedFile(MappedFile&& other) noexcept : data(exchange(other.data, nullptr)), size(exchange(other.size, 0)), open(exchange(other.open, false)) {
+}
+//---------------------------------------------------------------------------
+// Move assignment
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        unmap();
+        data = exchange(other.data, nullptr);
+        size = exchange(other.size, 0);
+        open = exchange(other.open, false);
+    }
+    return *this;
+}
+//---------------------------------------------------------------------------
+// Ask the kernel to read a range of the file ahead
+void MappedFile::prefetch(size_t offset, size_t length) const {
+    advise(offset, length, MADV_WILLNEED);
+}
+//---------------------------------------------------------------------------
+// Tell the kernel that a range of the file is not read again
+void MappedFile::release(size_t offset, size_t length) const {
+    advise(offset, length, MADV_DONTNEED);
+}
+//---------------------------------------------------------------------------
+// Give the kernel advice about a range of the file
+void MappedFile::advise(size_t offset, size_t length, int advice) const {
+    if (!data || offset >= size) {
+        return;
+    }
+    size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_t begin = offset / pageSize * pageSize;
+    size_t end = min(offset + length, size);
+    madvise(const_cast<char*>(data) + begin, end - begin, advice);
+}
+//---------------------------------------------------------------------------
+// Unmap the file
+void MappedFile::unmap() {
+    if (data) {
+        munmap(const_cast<char*>(data), size);
+    }
+    data = nullptr;
+    size = 0;
+    open = false;
+}
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
@@ -0,0 +1,45 @@
+#ifndef H_PLJIT_MAPPEDFILE
+#define H_PLJIT_MAPPEDFILE
+#include <string>
+#include <string_view>
+using namespace std;
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+/// Class that maps a file read-only into memory, the contents stay valid as long as the object exists
+class MappedFile {
+    public:
+    /// Constructor, maps the file at the given path
+    explicit MappedFile(const string& path);
+    /// Destructor, unmaps the file
+    ~MappedFile();
+    /// Mapped files are only movable
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    /// Return whether the file was mapped, an empty file counts as mapped
+    bool isOpen() const { return open; }
+    /// Return the contents of the file, they are not terminated by a NUL character
+    string_view getContents() const { return {data, size}; }
+    /// Ask the kernel to read a range of the file ahead
+    void prefetch(size_t offset, size_t length) const;
+    /// Tell the kernel that a range of the file is not read again, its pages can be dropped
+    void release(size_t offset, size_t length) const;
+
+    private:
+    /// Unmap the file
+    void unmap();
+    /// Give the kernel advice about a range of the file, the range is extended to whole pages
+    void advise(size_t offset, size_t length, int advice) const;
+    /// Storage of the mapped memory
+    const char* data = nullptr;
+    size_t size = 0;
+    /// Storage of whether the file was mapped
+    bool open = false;
+};
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
+#endif // H_PLJIT_MAPPEDFILE
+//---------------------------------------------------------------------------
@@ -0,0 +1,122 @@
+#include "pljit/MemoizationCache.hpp"
+#include <algorithm>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+// Constructor
+MemoizationCache::MemoizationCache(size_t parameterCount, size_t memoryBudget) : parameterCount(parameterCount), memoryBudget(memoryBudget) {
+    size_t slotSize = sizeof(Slot) + parameterCount * sizeof(int64_t);
+    size_t slotCount = memoryBudget / slotSize;
+
+    if (slotCount == 0) {
+        return;
+    }
+
+    size_t shardCount = min(slotCount, maxShardCount);
+    slotsPerShard = slotCount / shardCount;
+
+    for (size_t i = 0; i < shardCount; i++) {
+        auto shard = make_unique<Shard>();
+        shard->slots.resize(slotsPerShard);
+        shard->keys.resize(slotsPerShard * parameterCount);
+        shards.push_back(move(shard));
+    }
+}
+//---------------------------------------------------------------------------
+// Hash the parameters
+uint64_t MemoizationCache::hash(span<const int64_t> parameters) {
+    uint64_t hashValue = 0x9e3779b97f4a7c15ull;
+    for (int64_t parameter : parameters) {
+        uint64_t value = static_cast<uint64_t>(parameter) + 0x9e3779b97f4a7c15ull + (hashValue << 6) + (hashValue >> 2);
+        value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ull;
+        value = (value ^ (value >> 27)) * 0x94d049bb133111ebull;
+        hashValue ^= value ^ (value >> 31);
+    }
+    return hashValue;
+}
+//---------------------------------------------------------------------------
+// Check whether the slot holds the parameters
+bool MemoizationCache::matches(const Shard& shard, size_t slot, uint64_t hashValue, span<const int64_t> parameters) const {
+    const Slot& header = shard.slots[slot];
+    if (!header.occupied || header.hash != hashValue) {
+        return false;
+    }
+    return equal(parameters.begin(), parameters.end(), shard.keys.begin() + static_cast<ptrdiff_t>(slot * parameterCount));
+}
+//---------------------------------------------------------------------------
+// Return the cached result for the parameters
+optional<int64_t> MemoizationCache::lookup(span<const int64_t> parameters) {
+    if (parameters.size() != parameterCount) {
+        return nullopt;
+    }
+    // A budget that does not fit a single slot answers no call, so every lookup is a miss
+    if (shards.empty()) {
+        misses.fetch_add(1, memory_order_relaxed);
+        return nullopt;
+    }
+
+    uint64_t hashValue = hash(parameters);
+    Shard& shard = *shards[hashValue % shards.size()];
+    size_t home = (hashValue / shards.size()) % slotsPerShard;
+
+    {
+        unique_lock lock(shard.shardMutex);
+        for (size_t i = 0; i < min(probeLength, slotsPerShard); i++) {
+            size_t slot = (home + i) % slotsPerShard;
+            if (matches(shard, slot, hashValue, parameters)) {
+                hits.fetch_add(1, memory_order_relaxed);
+                return shard.slots[slot].result;
+            }
+        }
+    }
+
+    misses.fetch_add(1, memory_order_relaxed);
+    return nullopt;
+}
+//---------------------------------------------------------------------------
+// Store the result for the parameters
+void MemoizationCache::store(span<const int64_t> parameters, int64_t result) {
+    if (shards.empty() || parameters.size() != parameterCount) {
+        return;
+    }
+
+    uint64_t hashValue = hash(parameters);
+    Shard& shard = *shards[hashValue % shards.size()];
+    size_t home = (hashValue / shards.size()) % slotsPerShard;
+    size_t target = home;
+
+    unique_lock lock(shard.shardMutex);
+    for (size_t i = 0; i < min(probeLength, slotsPerShard); i++) {
+        size_t slot = (home + i) % slotsPerShard;
+        if (matches(shard, slot, hashValue, parameters)) {
+            return;
+        }
+        if (!shard.slots[slot].occupied) {
+            target = slot;
+            break;
+        }
+    }
+
+    Slot& header = shard.slots[target];
+    if (!header.occupied) {
+        entries.fetch_add(1, memory_order_relaxed);
+    }
+    header.hash = hashValue;
+    header.result = result;
+    header.occupied = true;
+    copy(parameters.begin(), parameters.end(), shard.keys.begin() + static_cast<ptrdiff_t>(target * parameterCount));
+}
+//---------------------------------------------------------------------------
+// Return the statistics of the cache
+MemoizationStatistics MemoizationCache::getStatistics() const {
+    MemoizationStatistics statistics;
+    statistics.hits = hits.load(memory_order_relaxed);
+    statistics.misses = misses.load(memory_order_relaxed);
+    statistics.entries = entries.load(memory_order_relaxed);
+    statistics.capacity = slotsPerShard * shards.size();
+    statistics.memoryBudget = memoryBudget;
+    return statistics;
+}
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
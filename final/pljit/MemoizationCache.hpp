@@ -0,0 +1,78 @@
+#ifndef H_PLJIT_MEMOIZATIONCACHE
+#define H_PLJIT_MEMOIZATIONCACHE
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <vector>
+using namespace std;
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+/// Struct that represents the statistics of a memoization cache
+struct MemoizationStatistics {
+    /// Number of calls answered from the cache
+    size_t hits = 0;
+    /// Number of calls that had to be evaluated
+    size_t misses = 0;
+    /// Number of occupied entries
+    size_t entries = 0;
+    /// Maximum number of entries
+    size_t capacity = 0;
+    /// Memory budget of the cache in bytes
+    size_t memoryBudget = 0;
+};
+/// Class that represents a concurrent fixed-capacity hash table that memoizes the results of a pure function
+class MemoizationCache {
+    public:
+    /// Constructor, all memory of the table is allocated once within the given budget
+    MemoizationCache(size_t parameterCount, size_t memoryBudget);
+    /// Return the cached result for the parameters
+    optional<int64_t> lookup(span<const int64_t> parameters);
+    optional<int64_t> lookup(const vector<int64_t>& parameters) { return lookup(span<const int64_t>(parameters)); }
+    /// Store the result for the parameters, replaces an older entry if the probed slots are full
+    void store(span<const int64_t> parameters, int64_t result);
+    void store(const vector<int64_t>& parameters, int64_t result) { store(span<const int64_t>(parameters), result); }
+    /// Return the statistics of the cache
+    MemoizationStatistics getStatistics() const;
+    /// Number of slots that are probed for a key
+    static constexpr size_t probeLength = 4;
+    /// Number of independently locked shards
+    static constexpr size_t maxShardCount = 16;
+
+    private:
+    /// Struct that represents the header of a slot, the parameters are stored separately
+    struct Slot {
+        uint64_t hash = 0;
+        int64_t result = 0;
+        bool occupied = false;
+    };
+    /// Struct that represents an independently locked part of the table
+    struct Shard {
+        mutex shardMutex;
+        vector<Slot> slots;
+        vector<int64_t> keys;
+    };
+    /// Hash the parameters
+    static uint64_t hash(span<const int64_t> parameters);
+    /// Check whether the slot holds the parameters
+    bool matches(const Shard& shard, size_t slot, uint64_t hashValue, span<const int64_t> parameters) const;
+    /// Storage of the number of parameters of the function
+    size_t parameterCount;
+    /// Storage of the memory budget
+    size_t memoryBudget;
+    /// Storage of the number of slots per shard
+    size_t slotsPerShard = 0;
+    /// Storage of the shards
+    vector<unique_ptr<Shard>> shards;
+    /// Storage of the counters
+    atomic<size_t> hits = 0;
+    atomic<size_t> misses = 0;
+    atomic<size_t> entries = 0;
+};
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
+#endif // H_PLJIT_MEMOIZATIONCACHE
@@ -0,0 +1,94 @@
+#include "pljit/PassManager.hpp"
+#include "pljit/ast/ASTNodeCounter.hpp"
+#include "pljit/ast/ASTOptimizerConstantPropagation.hpp"
+#include "pljit/ast/ASTOptimizerDeadCode.hpp"
+#include "pljit/ir/ASTBuilder.hpp"
+#include "pljit/ir/IRBuilder.hpp"
+#include "pljit/ir/IROptimizerCommonSubexpression.hpp"
+#include "pljit/ir/IROptimizerConstantPropagation.hpp"
+#include "pljit/ir/IROptimizerDeadCode.hpp"
+using namespace pljit::ir;
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+// Return the pipeline of an optimization level
+vector<Pass> PassManager::getPipeline(OptimizationLevel level) {
+    switch (level) {
+        case OptimizationLevel::O0: return {};
+        case OptimizationLevel::O1: return {Pass::DeadCode, Pass::ConstantPropagation};
+        case OptimizationLevel::O2:
+            return {Pass::DeadCode, Pass::ConstantPropagation, Pass::SSAConstantPropagation, Pass::SSACommonSubexpression, Pass::SSADeadCode};
+    }
+    return {};
+}
+//---------------------------------------------------------------------------
+// Return the name of a pass
+string_view PassManager::getName(Pass pass) {
+    switch (pass) {
+        case Pass::DeadCode: return "DeadCode";
+        case Pass::ConstantPropagation: return "ConstantPropagation";
+        case Pass::SSAConstantPropagation: return "SSAConstantPropagation";
+        case Pass::SSACommonSubexpression: return "SSACommonSubexpression";
+        case Pass::SSADeadCode: return "SSADeadCode";
+    }
+    return "";
+}
+//---------------------------------------------------------------------------
+// Run a single pass
+void PassManager::runPass(Pass pass, unique_ptr<ASTNode>& function, pmr::memory_resource* resource) const {
+    switch (pass) {
+        case Pass::DeadCode: {
+            ASTOptimizerDeadCode astOptimizerDeadCode(resource);
+            function->optimize(astOptimizerDeadCode, function);
+            return;
+        }
+        case Pass::ConstantPropagation: {
+            auto& function1 = static_cast<Function&>(*function);
+            ASTOptimizerConstantPropagation astOptimizerConstantPropagation(function1.getSymbolTable(), arithmeticMode, resource);
+            function->optimize(astOptimizerConstantPropagation, function);
+            return;
+        }
+        default: break;
+    }
+
+    // The ssa passes lower the function and build a new ast from the optimized form
+    IRBuilder irBuilder;
+    IRFunction irFunction = irBuilder.build(static_cast<Function&>(*function));
+
+    if (pass == Pass::SSAConstantPropagation) {
+        IROptimizerConstantPropagation irOptimizer(arithmeticMode);
+        irOptimizer.optimize(irFunction);
+    } else if (pass == Pass::SSACommonSubexpression) {
+        IROptimizerCommonSubexpression irOptimizer;
+        irOptimizer.optimize(irFunction);
+    } else {
+        IROptimizerDeadCode irOptimizer(arithmeticMode);
+        irOptimizer.optimize(irFunction);
+    }
+
+    ASTBuilder astBuilder(arithmeticMode, resource);
+    function = astBuilder.build(irFunction);
+}
+//---------------------------------------------------------------------------
+// Run all passes in order
+vector<PassStatistics> PassManager::run(unique_ptr<ASTNode>& function, pmr::memory_resource* resource) const {
+    vector<PassStatistics> statistics;
+    ASTNodeCounter astNodeCounter;
+
+    for (Pass pass : pipeline) {
+        PassStatistics passStatistics;
+        passStatistics.pass = pass;
+        passStatistics.nodesBefore = astNodeCounter.count(*function);
+
+        auto begin = chrono::steady_clock::now();
+        runPass(pass, function, resource);
+        passStatistics.duration = chrono::steady_clock::now() - begin;
+
+        passStatistics.nodesAfter = astNodeCounter.count(*function);
+        statistics.push_back(passStatistics);
+    }
+    return statistics;
+}
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
@@ -0,0 +1,72 @@
+#ifndef H_PLJIT_PASSMANAGER
+#define H_PLJIT_PASSMANAGER
+#include "pljit/ast/AST.hpp"
+#include <chrono>
+#include <vector>
+using namespace pljit::ast;
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+/// All available optimization passes
+enum class Pass {
+    /// Remove the statements after the first return (ast)
+    DeadCode,
+    /// Propagate and fold constants (ast)
+    ConstantPropagation,
+    /// Propagate and fold constants (ssa)
+    SSAConstantPropagation,
+    /// Compute equal values only once (ssa)
+    SSACommonSubexpression,
+    /// Remove values that do not reach the return (ssa)
+    SSADeadCode
+};
+/// All optimization levels
+enum class OptimizationLevel {
+    /// No passes, for functions that are only called a few times
+    O0,
+    /// The ast passes
+    O1,
+    /// All passes
+    O2
+};
+/// Struct that represents the measurements of one pass
+struct PassStatistics {
+    /// The pass
+    Pass pass;
+    /// Wall time of the pass
+    chrono::nanoseconds duration{0};
+    /// Number of ast nodes before the pass
+    size_t nodesBefore = 0;
+    /// Number of ast nodes after the pass
+    size_t nodesAfter = 0;
+};
+/// Class that runs an ordered pipeline of optimization passes on a function
+class PassManager {
+    public:
+    /// Constructors, the passes keep the results and errors of the arithmetic mode the function is evaluated in
+    PassManager() : PassManager(OptimizationLevel::O1) {}
+    explicit PassManager(OptimizationLevel level, ArithmeticMode arithmeticMode = ArithmeticMode::Wrapping) : pipeline(getPipeline(level)), arithmeticMode(arithmeticMode) {}
+    explicit PassManager(vector<Pass> pipeline, ArithmeticMode arithmeticMode = ArithmeticMode::Wrapping) : pipeline(move(pipeline)), arithmeticMode(arithmeticMode) {}
+    /// Return the pipeline of an optimization level
+    static vector<Pass> getPipeline(OptimizationLevel level);
+    /// Return the name of a pass
+    static string_view getName(Pass pass);
+    /// Getters
+    const vector<Pass>& getPipeline() const { return pipeline; }
+    ArithmeticMode getArithmeticMode() const { return arithmeticMode; }
+    /// Run all passes in order, the new nodes are allocated from the memory resource, returns the measurements of every pass
+    vector<PassStatistics> run(unique_ptr<ASTNode>& function, pmr::memory_resource* resource = pmr::get_default_resource()) const;
+
+    private:
+    /// Run a single pass
+    void runPass(Pass pass, unique_ptr<ASTNode>& function, pmr::memory_resource* resource) const;
+    /// Storage of the pipeline
+    vector<Pass> pipeline;
+    /// Storage of the arithmetic mode
+    ArithmeticMode arithmeticMode;
+};
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
+#endif // H_PLJIT_PASSMANAGER
+//---------------------------------------------------------------------------
@@ -1,55 +1,966 @@
 #include "pljit/Pljit.hpp"
-#include "pljit/ast/ASTOptimizerConstantPropagation.hpp"
-#include "pljit/ast/ASTOptimizerDeadCode.hpp"
+#include "pljit/ast/ASTNodeCounter.hpp"
+#include <algorithm>
+#include <memory_resource>
 using namespace pljit::semanticanalysis;
 //---------------------------------------------------------------------------
 namespace pljit {
 //---------------------------------------------------------------------------
-// Overloaded function call
-optional<int64_t> PljitHandle::operator()(const vector<int64_t>& parameters) {
-    shared_ptr<CodeManagement> codeM = make_shared<CodeManagement>(code);
+namespace {
+//---------------------------------------------------------------------------
+// Size of the buffer on the stack that holds the parse tree of a typical function
+constexpr size_t scratchSize = 4096;
+//---------------------------------------------------------------------------
+// Return the outcome of an evaluation that failed
+CallOutcome getErrorOutcome(const EvaluationContext& evaluationContext) {
+    if (evaluationContext.fuelExhausted()) {
+        return CallOutcome::FuelExhausted;
+    }
+    return evaluationContext.overflowOccurred() ? CallOutcome::Overflow : CallOutcome::DivisionByZero;
+}
+//---------------------------------------------------------------------------
+// Share the ownership of a compiled function
+shared_ptr<Function> shareFunction(unique_ptr<ASTNode> function) {
+    return shared_ptr<Function>(static_cast<Function*>(function.release()));
+}
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+// Register a handle
+void FunctionStorage::addHandle(uint64_t handleId, string_view code, const RecordedSettings& settings, shared_ptr<const HandleMetrics> handleMetrics) {
+    shared_ptr<Recorder> currentRecorder;
+    {
+        unique_lock lock(functionsMutex);
+        metrics.emplace(handleId, move(handleMetrics));
+        currentRecorder = recorder;
+    }
+    if (currentRecorder) {
+        currentRecorder->recordRegistration(handleId, code, settings);
+    }
+}
+//---------------------------------------------------------------------------
+// Unregister a destroyed handle
+void FunctionStorage::removeHandle(uint64_t handleId) {
+    // Only the counts are kept, so many short-lived handles do not keep their histograms alive
+    unique_lock lock(functionsMutex);
+    auto it = metrics.find(handleId);
+    if (it == metrics.end()) {
+        return;
+    }
+    retiredMetrics.merge(it->second->getSnapshot());
+    metrics.erase(it);
+}
+//---------------------------------------------------------------------------
+// Set the recorder of the registrations and invocations
+void FunctionStorage::setRecorder(shared_ptr<Recorder> recorder1) {
+    unique_lock lock(functionsMutex);
+    recorder = move(recorder1);
+    recording.store(recorder != nullptr, memory_order_relaxed);
+}
+//---------------------------------------------------------------------------
+// Return the recorder
+shared_ptr<Recorder> FunctionStorage::getRecorder() const {
+    unique_lock lock(functionsMutex);
+    return recorder;
+}
+//---------------------------------------------------------------------------
+// Return the metrics of all handles
+vector<shared_ptr<const HandleMetrics>> FunctionStorage::getMetrics() const {
+    vector<shared_ptr<const HandleMetrics>> handleMetrics;
+    unique_lock lock(functionsMutex);
+    handleMetrics.reserve(metrics.size());
+    for (const auto& [handleId, metrics1] : metrics) {
+        handleMetrics.push_back(metrics1);
+    }
+    return handleMetrics;
+}
+//---------------------------------------------------------------------------
+// Return the metrics of all handles added up
+MetricsSnapshot FunctionStorage::getAggregateMetrics() const {
+    MetricsSnapshot aggregate;
+    vector<shared_ptr<const HandleMetrics>> handleMetrics;
+    {
+        unique_lock lock(functionsMutex);
+        aggregate = retiredMetrics;
+        for (const auto& [handleId, metrics1] : metrics) {
+            handleMetrics.push_back(metrics1);
+        }
+    }
+    for (const auto& metrics1 : handleMetrics) {
+        aggregate.merge(metrics1->getSnapshot());
+    }
+    return aggregate;
+}
+//---------------------------------------------------------------------------
+// Destructor
+PljitHandle::~PljitHandle() {
+    functionsRef.removeHandle(id);
+}
+//---------------------------------------------------------------------------
+// Compile the code with the bound parameters treated as constants
+unique_ptr<ASTNode> PljitHandle::compile(const ParameterBinding& binding) {
+    // The parse tree only lives during the compilation, so it is allocated from a buffer that is released in one step at the end
+    array<byte, scratchSize> scratchBuffer;
+    pmr::monotonic_buffer_resource scratch(scratchBuffer.data(), scratchBuffer.size());
+    string_view currentCode = getCode(version.get());
+    shared_ptr<CodeManagement> codeM = allocate_shared<CodeManagement>(pmr::polymorphic_allocator<CodeManagement>(&scratch), currentCode);
+    Lexer lexer(currentCode, codeM);
+    // The lexer runs on demand of the parser, its time is measured separately whenever the phases are recorded
+    lexer.setTimed(Instrumentation::enabled || Tracer::isActive());
+    Parsing parser(lexer, codeM, &scratch);
+
+    Instrumentation::TimePoint begin = Instrumentation::now();
+    parser.parsing();
+    chrono::nanoseconds lexingTime = parser.getLexer().getLexingTime();
+    instrumentation.record(Phase::Lexing, begin, lexingTime);
+    instrumentation.record(Phase::Parsing, begin + lexingTime, Instrumentation::now() - begin - lexingTime);
+
+    if (parser.errorOccurred()) {
+        return nullptr;
+    }
+
+    begin = Instrumentation::now();
+    SemanticAnalysis semanticAnalysis(codeM, functionsRef.getMemoryResource());
+    Function function = semanticAnalysis.getAST(parser);
+    instrumentation.recordSince(Phase::SemanticAnalysis, begin);
+
+    if (function.errorOccurred()) {
+        return nullptr;
+    }
+
+    for (const auto& [parameterPos, value] : binding) {
+        function.getSymbolTable().bindParameter(parameterPos, value);
+    }
+
+    unique_ptr<ASTNode> functionPtr = allocateNode<Function>(functionsRef.getMemoryResource(), move(function));
+    begin = Instrumentation::now();
+    passStatistics = passManager.run(functionPtr, functionsRef.getMemoryResource());
+    instrumentation.recordSince(Phase::Optimization, begin);
+
+    if constexpr (Instrumentation::enabled) {
+        ASTNodeCounter astNodeCounter;
+        size_t nodes = astNodeCounter.count(*functionPtr);
+        size_t allocations = passStatistics.empty() ? nodes : passStatistics.front().nodesBefore;
+        for (const auto& statistics : passStatistics) {
+            allocations += statistics.nodesAfter;
+        }
+        instrumentation.recordCompilation(nodes, allocations);
+    }
+
+    return functionPtr;
+}
+//---------------------------------------------------------------------------
+// Evaluate a compiled function
+optional<int64_t> PljitHandle::evaluate(ASTNode& function, span<const int64_t> parameters, ExecutionProfile* executionProfile, CallOutcome* outcome, bool limitFuel) {
+    Instrumentation::TimePoint begin = Instrumentation::now();
+    const auto& function1 = static_cast<const Function&>(function);
+    EvaluationContext evaluationContext(function1.getSymbolTable(), parameters);
+    evaluationContext.setArithmeticMode(arithmeticMode);
+    evaluationContext.setFuel(limitFuel ? fuelLimit.load(memory_order_relaxed) : 0);
+    if (executionProfile) {
+        executionProfile->recordCall(parameters);
+        evaluationContext.setProfile(executionProfile);
+    }
+    function1.execute(evaluationContext);
+    instrumentation.recordSince(Phase::Evaluation, begin);
+
+    if (evaluationContext.errorOccurred()) {
+        if (outcome) {
+            *outcome = getErrorOutcome(evaluationContext);
+        }
+        return nullopt;
+    }
+
+    return evaluationContext.getReturnValue();
+}
+//---------------------------------------------------------------------------
+// Compile the function if it is not compiled yet
+bool PljitHandle::ensureCompiled() {
+    if (!compiled.load(memory_order_relaxed)) {
+        unique_ptr<ASTNode> function = compile({});
+
+        if (!function) {
+            return false;
+        }
+
+        size_t parameterCount = static_cast<Function&>(*function).getSymbolTable().getParameterCount();
+        if (expectedArity && *expectedArity != parameterCount) {
+            errorParameterCount(parameterCount, *expectedArity);
+            return false;
+        }
+
+        version = createVersion(move(function), parameterCount);
+        compiled.store(true, memory_order_release);
+    }
+    return true;
+}
+//---------------------------------------------------------------------------
+// Create the version of a compiled function
+shared_ptr<PljitHandle::Version> PljitHandle::createVersion(unique_ptr<ASTNode> function, size_t parameterCount, vector<shared_ptr<const string>> sources) {
+    auto compiledVersion = make_shared<Version>();
+    compiledVersion->function = shareFunction(move(function));
+    compiledVersion->sources = move(sources);
+    compiledVersion->pipeline = passManager.getPipeline();
+    compiledVersion->arity = parameterCount;
+
+    // A function without parameters always computes the same result or error
+    if (parameterCount == 0) {
+        compiledVersion->constantResult = evaluate(*compiledVersion->function, {}, nullptr, &compiledVersion->constantOutcome, false);
+        compiledVersion->constantFolded = true;
+    }
+    return compiledVersion;
+}
+//---------------------------------------------------------------------------
+// Report a call with the wrong number of parameters
+void PljitHandle::errorParameterCount(size_t expected, size_t actual) {
+    cerr << "error: the function expects " << expected << " parameters, but " << actual << " were provided" << endl;
+}
+//---------------------------------------------------------------------------
+// Function call
+optional<int64_t> PljitHandle::call(span<const int64_t> parameters, bool checkArity, CallOutcome* outcome) {
+    auto begin = chrono::steady_clock::now();
+    CallOutcome callOutcome = CallOutcome::Success;
+    shared_ptr<const Version> current;
+    optional<int64_t> result = evaluateCall(parameters, checkArity, callOutcome, current);
+    metrics->recordCall(callOutcome, chrono::steady_clock::now() - begin);
+    if (outcome) {
+        *outcome = callOutcome;
+    }
+
+    if (functionsRef.isRecording()) {
+        if (shared_ptr<Recorder> recorder = functionsRef.getRecorder()) {
+            // The version of a finalized handle is never replaced, so it is read without the lock
+            const Version* recorded = current ? current.get() : isFinalized() ? version.get() : nullptr;
+            recorder->recordInvocation(id, getCode(recorded), getRecordedSettings(recorded), begin, parameters, result);
+        }
+    }
+    return result;
+}
+//---------------------------------------------------------------------------
+// Compile the function if needed and evaluate one call
+optional<int64_t> PljitHandle::evaluateCall(span<const int64_t> parameters, bool checkArity, CallOutcome& outcome, shared_ptr<const Version>& current) {
+    // The version of a finalized handle is never replaced, so its image is evaluated without the lock
+    if (isFinalized()) {
+        Instrumentation::TimePoint begin = Instrumentation::now();
+        optional<int64_t> result = evaluateImage(*version, parameters, outcome);
+        instrumentation.recordSince(Phase::Evaluation, begin);
+        return result;
+    }
+
+    // The call keeps its version alive, so a concurrent update or finalization does not release it
+    shared_ptr<MemoizationCache> memoizationCache;
+    bool profiled = false;
     {
+        unique_lock lock = lockHandle();
+
+        if (!ensureCompiled()) {
+            outcome = CallOutcome::CompileError;
+            return nullopt;
+        }
+        current = version;
+        if (checkArity && parameters.size() != current->arity) {
+            errorParameterCount(current->arity, parameters.size());
+            outcome = CallOutcome::ParameterCountError;
+            return nullopt;
+        }
+        if (current->constantFolded) {
+            outcome = current->constantOutcome;
+            return current->constantResult;
+        }
+        memoizationCache = memoization;
+        profiled = profiling;
+    }
+    if (current->isFinalized()) {
+        return evaluateImage(*current, parameters, outcome);
+    }
+
+    if (memoizationCache) {
+        if (optional<int64_t> result = memoizationCache->lookup(parameters)) {
+            return result;
+        }
+    }
+
+    // A version is never modified, so it is evaluated without the lock, a profiled call only takes it to add its profile
+    optional<int64_t> result;
+    if (current->profileSpecialization && current->matchesProfileBinding(parameters)) {
+        result = evaluate(*current->profileSpecialization, parameters, nullptr, &outcome);
+    } else if (profiled) {
+        ExecutionProfile callProfile;
+        result = evaluate(*current->function, parameters, &callProfile, &outcome);
+        unique_lock lock = lockHandle();
+        // The profile belongs to the current version, a call of a replaced version is not recorded
+        if (profile && version == current) {
+            profile->merge(callProfile);
+        }
+    } else {
+        result = evaluate(*current->function, parameters, nullptr, &outcome);
+    }
+
+    if (result && memoizationCache) {
+        memoizationCache->store(parameters, result.value());
+    }
+    return result;
+}
+//---------------------------------------------------------------------------
+// Record the invocations in the recorder of the functions reference
+void PljitHandle::recordInvocations(Recorder::TimePoint begin, span<const vector<int64_t>> calls, span<const optional<int64_t>> results, const Version* current) const {
+    if (!functionsRef.isRecording()) {
+        return;
+    }
+    if (shared_ptr<Recorder> recorder = functionsRef.getRecorder()) {
+        RecordedSettings settings = getRecordedSettings(current);
+        for (size_t i = 0; i < calls.size(); i++) {
+            recorder->recordInvocation(id, getCode(current), settings, begin, calls[i], results[i]);
+        }
+    }
+}
+//---------------------------------------------------------------------------
+// Return the settings of a version for a recording
+RecordedSettings PljitHandle::getRecordedSettings(const Version* current) const {
+    RecordedSettings settings;
+    if (current) {
+        settings.pipeline = current->pipeline;
+    } else {
         unique_lock lock(uniqueMutex);
+        settings.pipeline = passManager.getPipeline();
+    }
+    settings.arithmeticMode = arithmeticMode;
+    settings.fuelLimit = fuelLimit.load(memory_order_relaxed);
+    return settings;
+}
+//---------------------------------------------------------------------------
+// Lock the mutex of the handle and record the time spent waiting for it
+unique_lock<mutex> PljitHandle::lockHandle() {
+    if (Instrumentation::enabled || Tracer::isActive()) {
+        Instrumentation::TimePoint begin = Instrumentation::now();
+        unique_lock lock(uniqueMutex);
+        chrono::nanoseconds wait = Instrumentation::now() - begin;
+        instrumentation.record(Phase::LockWait, begin, wait);
+        metrics->recordLockWait(wait);
+        return lock;
+    }
 
-        if (!compiled) {
-            Lexer lexer(code.data(), codeM);
-            Parsing parser(lexer, codeM);
+    // Without instrumentation the time is only taken if the mutex is contended
+    unique_lock lock(uniqueMutex, try_to_lock);
+    if (!lock.owns_lock()) {
+        auto begin = chrono::steady_clock::now();
+        lock.lock();
+        metrics->recordLockWait(chrono::steady_clock::now() - begin);
+    }
+    return lock;
+}
+//---------------------------------------------------------------------------
+// Evaluate a call of a finalized handle
+optional<int64_t> PljitHandle::evaluateImage(const Version& current, span<const int64_t> parameters, CallOutcome& outcome, bool reportErrors) const {
+    if (parameters.size() != current.arity) {
+        if (reportErrors) {
+            errorParameterCount(current.arity, parameters.size());
+        }
+        outcome = CallOutcome::ParameterCountError;
+        return nullopt;
+    }
+    if (current.constantFolded) {
+        outcome = current.constantOutcome;
+        return current.constantResult;
+    }
 
-            parser.parsing();
-            if (parser.errorOccurred()) {
-                return nullopt;
+    int64_t result = 0;
+    ir::CodeImage::Status status = current.image->execute(parameters, fuelLimit.load(memory_order_relaxed), result, reportErrors);
+    switch (status) {
+        case ir::CodeImage::Status::Success: outcome = CallOutcome::Success; return result;
+        case ir::CodeImage::Status::DivisionByZero: outcome = CallOutcome::DivisionByZero; return nullopt;
+        case ir::CodeImage::Status::FuelExhausted: outcome = CallOutcome::FuelExhausted; return nullopt;
+        case ir::CodeImage::Status::Overflow: outcome = CallOutcome::Overflow; return nullopt;
+    }
+    return nullopt;
+}
+//---------------------------------------------------------------------------
+// Evaluate calls of the compiled function with one evaluation context
+template <typename Calls>
+void PljitHandle::evaluateCalls(const Calls& calls, span<optional<int64_t>> results, const Version& current, MemoizationCache* memoizationCache, ExecutionProfile* executionProfile) const {
+    // The outcomes are counted locally, so parallel morsels do not contend on the counters of the metrics
+    // The errors of the rows are only counted, a stream with many failing rows would otherwise serialize the workers on stderr
+    array<uint64_t, callOutcomeCount> outcomes{};
+    if (current.isFinalized()) {
+        for (size_t i = 0; i < calls.size(); i++) {
+            CallOutcome outcome = CallOutcome::Success;
+            results[i] = evaluateImage(current, calls[i], outcome, false);
+            outcomes[static_cast<size_t>(outcome)]++;
+        }
+        for (size_t i = 0; i < outcomes.size(); i++) {
+            metrics->recordCalls(static_cast<CallOutcome>(i), outcomes[i]);
+        }
+        return;
+    }
+
+    const Function& function = *current.function;
+    uint64_t fuel = fuelLimit.load(memory_order_relaxed);
+    EvaluationContext evaluationContext(function.getSymbolTable());
+    evaluationContext.setArithmeticMode(arithmeticMode);
+    evaluationContext.setProfile(executionProfile);
+    evaluationContext.setFuel(fuel);
+    evaluationContext.setReportErrors(false);
+    optional<EvaluationContext> specializedContext;
+
+    for (size_t i = 0; i < calls.size(); i++) {
+        span<const int64_t> parameters = calls[i];
+        if (parameters.size() != current.arity) {
+            outcomes[static_cast<size_t>(CallOutcome::ParameterCountError)]++;
+            continue;
+        }
+        if (current.constantFolded) {
+            results[i] = current.constantResult;
+            outcomes[static_cast<size_t>(current.constantOutcome)]++;
+            continue;
+        }
+        if (memoizationCache) {
+            if ((results[i] = memoizationCache->lookup(parameters))) {
+                outcomes[static_cast<size_t>(CallOutcome::Success)]++;
+                continue;
+            }
+        }
+
+        // The version chosen by the profile has its own context, since its symbol table differs
+        EvaluationContext* context = &evaluationContext;
+        const Function* target = &function;
+        if (current.profileSpecialization && current.matchesProfileBinding(parameters)) {
+            if (!specializedContext) {
+                specializedContext.emplace(current.profileSpecialization->getSymbolTable());
+                specializedContext->setArithmeticMode(arithmeticMode);
+                specializedContext->setFuel(fuel);
+                specializedContext->setReportErrors(false);
+            }
+            context = &*specializedContext;
+            target = current.profileSpecialization.get();
+        } else if (executionProfile) {
+            executionProfile->recordCall(parameters);
+        }
+
+        context->reset(parameters);
+        target->execute(*context);
+        if (context->errorOccurred()) {
+            outcomes[static_cast<size_t>(getErrorOutcome(*context))]++;
+            continue;
+        }
+
+        outcomes[static_cast<size_t>(CallOutcome::Success)]++;
+        results[i] = context->getReturnValue();
+        if (memoizationCache) {
+            memoizationCache->store(parameters, *results[i]);
+        }
+    }
+
+    for (size_t i = 0; i < outcomes.size(); i++) {
+        metrics->recordCalls(static_cast<CallOutcome>(i), outcomes[i]);
+    }
+}
+//---------------------------------------------------------------------------
+// Evaluate several calls at once
+vector<optional<int64_t>> PljitHandle::evaluateBatch(span<const vector<int64_t>> calls) {
+    auto arrival = chrono::steady_clock::now();
+    vector<optional<int64_t>> results(calls.size());
+    shared_ptr<const Version> current;
+    shared_ptr<MemoizationCache> memoizationCache;
+    bool profiled = false;
+    {
+        unique_lock lock = lockHandle();
+
+        if (ensureCompiled()) {
+            current = version;
+            memoizationCache = memoization;
+            profiled = profiling;
+        }
+    }
+
+    // The batch evaluates its version without the lock like a morsel of evaluateParallel
+    ExecutionProfile batchProfile;
+    if (current) {
+        Instrumentation::TimePoint begin = Instrumentation::now();
+        evaluateCalls(calls, results, *current, memoizationCache.get(), profiled ? &batchProfile : nullptr);
+        instrumentation.recordSince(Phase::Evaluation, begin);
+    }
+    if (profiled) {
+        unique_lock lock = lockHandle();
+        if (profile && version == current) {
+            profile->merge(batchProfile);
+        }
+    }
+
+    recordInvocations(arrival, calls, results, current.get());
+    return results;
+}
+//---------------------------------------------------------------------------
+// Compile the function on the pool
+future<bool> PljitHandle::compileInBackground(ThreadPool& pool) {
+    return pool.submit([this] {
+        unique_lock lock = lockHandle();
+        return ensureCompiled();
+    });
+}
+//---------------------------------------------------------------------------
+// Evaluate many calls on the pool
+vector<optional<int64_t>> PljitHandle::evaluateParallel(ThreadPool& pool, span<const vector<int64_t>> calls, size_t morselSize) {
+    auto arrival = chrono::steady_clock::now();
+    vector<optional<int64_t>> results(calls.size());
+    shared_ptr<const Version> current;
+    shared_ptr<MemoizationCache> memoizationCache;
+    bool profiled = false;
+    {
+        unique_lock lock = lockHandle();
+
+        if (!ensureCompiled()) {
+            return results;
+        }
+        current = version;
+        memoizationCache = memoization;
+        profiled = profiling;
+    }
+
+    // The morsels evaluate the version of the start of the batch without the lock, it stays alive until they are done
+    Instrumentation::TimePoint begin = Instrumentation::now();
+    morselSize = max<size_t>(morselSize, 1);
+    span<optional<int64_t>> resultSpan = results;
+    vector<future<void>> morsels;
+    for (size_t first = 0; first < calls.size(); first += morselSize) {
+        size_t count = min(morselSize, calls.size() - first);
+        morsels.push_back(pool.submit([this, calls, resultSpan, current, memoizationCache, profiled, first, count] {
+            // Every morsel records its own profile, it is added to the profile of the handle unless the version was replaced
+            ExecutionProfile morselProfile;
+            evaluateCalls(calls.subspan(first, count), resultSpan.subspan(first, count), *current, memoizationCache.get(), profiled ? &morselProfile : nullptr);
+            if (profiled) {
+                unique_lock lock = lockHandle();
+                if (profile && version == current) {
+                    profile->merge(morselProfile);
+                }
             }
+        }));
+    }
+    for (auto& morsel : morsels) {
+        morsel.get();
+    }
+    instrumentation.recordSince(Phase::Evaluation, begin);
+
+    recordInvocations(arrival, calls, results, current.get());
+    return results;
+}
+//---------------------------------------------------------------------------
+// Evaluate calls whose parameters are stored one after another
+bool PljitHandle::evaluateRows(span<const int64_t> parameters, span<optional<int64_t>> results) {
+    shared_ptr<const Version> current;
+    shared_ptr<MemoizationCache> memoizationCache;
+    {
+        unique_lock lock = lockHandle();
+
+        if (!ensureCompiled() || parameters.size() != results.size() * version->arity) {
+            return false;
+        }
+        current = version;
+        memoizationCache = memoization;
+    }
+
+    Instrumentation::TimePoint begin = Instrumentation::now();
+    evaluateCalls(ParameterRows{parameters, current->arity, results.size()}, results, *current, memoizationCache.get(), nullptr);
+    instrumentation.recordSince(Phase::Evaluation, begin);
+    return true;
+}
+//---------------------------------------------------------------------------
+// Return the number of parameters of the function
+optional<size_t> PljitHandle::getParameterCount() {
+    unique_lock lock = lockHandle();
+    if (!ensureCompiled()) {
+        return nullopt;
+    }
+    return version->arity;
+}
+//---------------------------------------------------------------------------
+// Asynchronous function call
+Task<optional<int64_t>> PljitHandle::callAsync(Executor& executor, vector<int64_t> parameters) {
+    // The parameters are owned by the coroutine frame, so the caller may return before the call runs
+    co_await executor.schedule();
+    co_return call(parameters, true);
+}
+//---------------------------------------------------------------------------
+// Return the specialized version of a binding
+ASTNode* PljitHandle::getSpecialization(const ParameterBinding& binding) {
+    if (ASTNode* function = specializations.find(binding)) {
+        return function;
+    }
+
+    unique_ptr<ASTNode> function = compile(binding);
 
-            SemanticAnalysis semanticAnalysis(codeM);
-            Function function = semanticAnalysis.getAST(parser);
+    if (!function) {
+        return nullptr;
+    }
 
-            if (function.errorOccurred()) {
+    return &specializations.insert(binding, move(function));
+}
+//---------------------------------------------------------------------------
+// Function call of the version specialized for the bound parameters
+optional<int64_t> PljitHandle::operator()(const ParameterBinding& binding, span<const int64_t> parameters) {
+    ParameterBinding normalizedBinding = SpecializationCache::normalize(binding);
+    if (!isFinalized()) {
+        unique_lock lock = lockHandle();
+        // A handle that was finalized while waiting for the lock is evaluated on its image below
+        if (!isFinalized()) {
+            ASTNode* function = getSpecialization(normalizedBinding);
+
+            if (!function) {
                 return nullopt;
             }
-            ASTOptimizerDeadCode astOptimizerDeadCode;
 
-            functionsRef.push_back(make_unique<Function>(move(function)));
-            position = functionsRef.size() - 1;
-            functionsRef[position]->optimize(astOptimizerDeadCode, functionsRef[position]);
+            // Bound parameters keep their position, only the positions after the last unbound parameter may be missing
+            size_t parameterSlots = static_cast<Function&>(*function).getSymbolTable().getParameterSlots();
+            if (parameters.size() < parameterSlots) {
+                errorParameterCount(parameterSlots, parameters.size());
+                return nullopt;
+            }
 
-            auto& function1 = static_cast<Function&>(*functionsRef[position]);
-            ASTOptimizerConstantPropagation astOptimizerConstantPropagation(function1.getSymbolTable());
-            functionsRef[position]->optimize(astOptimizerConstantPropagation, functionsRef[position]);
+            return evaluate(*function, parameters);
+        }
+    }
 
-            compiled = true;
+    // The image is not specialized, the bound values are passed as parameters instead
+    size_t arity = version->arity;
+    vector<int64_t> values(arity);
+    size_t provided = min(parameters.size(), arity);
+    copy(parameters.begin(), parameters.begin() + static_cast<ptrdiff_t>(provided), values.begin());
+    size_t boundMissing = 0;
+    for (const auto& [position, value] : normalizedBinding) {
+        if (position < arity) {
+            values[position] = value;
+            boundMissing += position >= provided;
         }
     }
+    if (provided + boundMissing < arity) {
+        errorParameterCount(arity, parameters.size());
+        return nullopt;
+    }
+    CallOutcome outcome = CallOutcome::Success;
+    return evaluateImage(*version, values, outcome);
+}
+//---------------------------------------------------------------------------
+// Replace the code of the function
+bool PljitHandle::update(string newCode) {
+    auto newCodePtr = make_shared<const string>(move(newCode));
+    unique_lock lock = lockHandle();
+    if (isFinalized()) {
+        return false;
+    }
 
-    auto& function1 = static_cast<Function&>(*functionsRef[position]);
-    EvaluationContext evaluationContext(function1.getSymbolTable(), parameters);
+    Instrumentation::TimePoint begin = Instrumentation::now();
+    unique_ptr<Function> function = incrementalCompiler.compile(newCodePtr);
+    instrumentation.recordSince(Phase::SemanticAnalysis, begin);
+
+    if (!function) {
+        return false;
+    }
+
+    size_t parameterCount = function->getSymbolTable().getParameterCount();
+    if (expectedArity && *expectedArity != parameterCount) {
+        errorParameterCount(parameterCount, *expectedArity);
+        return false;
+    }
+
+    // The passes still run over the whole function, constant propagation crosses the statements
+    unique_ptr<ASTNode> functionPtr = move(function);
+    begin = Instrumentation::now();
+    passStatistics = passManager.run(functionPtr, functionsRef.getMemoryResource());
+    instrumentation.recordSince(Phase::Optimization, begin);
+
+    // The replaced version is released once the calls that still evaluate it return
+    auto updatedVersion = createVersion(move(functionPtr), parameterCount, incrementalCompiler.getSources());
+    updatedVersion->source = newCodePtr;
+    version = move(updatedVersion);
+    specializations.clear();
+    if (profile) {
+        profile = make_shared<ExecutionProfile>();
+    }
+    if (memoization) {
+        memoization = make_shared<MemoizationCache>(parameterCount, memoization->getStatistics().memoryBudget);
+    }
+    compiled.store(true, memory_order_release);
+
+    if (shared_ptr<Recorder> recorder = functionsRef.getRecorder()) {
+        recorder->recordRegistration(id, *newCodePtr, getRecordedSettings(version.get()), true);
+    }
+    return true;
+}
+//---------------------------------------------------------------------------
+// Return whether the function has no parameters and was evaluated during the compilation
+bool PljitHandle::isConstantFolded() const {
+    unique_lock lock(uniqueMutex);
+    return version && version->constantFolded;
+}
+//---------------------------------------------------------------------------
+// Return how much of the function the last successful update analyzed again
+UpdateStatistics PljitHandle::getUpdateStatistics() const {
+    unique_lock lock(uniqueMutex);
+    return incrementalCompiler.getStatistics();
+}
+//---------------------------------------------------------------------------
+// Record an execution profile of the later calls
+void PljitHandle::enableProfiling() {
+    unique_lock lock(uniqueMutex);
+    if (isFinalized()) {
+        return;
+    }
+    if (!profile) {
+        profile = make_shared<ExecutionProfile>();
+    }
+    profiling = true;
+}
+//---------------------------------------------------------------------------
+// Stop recording the execution profile
+void PljitHandle::disableProfiling() {
+    unique_lock lock(uniqueMutex);
+    profiling = false;
+}
+//---------------------------------------------------------------------------
+// Return the recorded execution profile
+ExecutionProfile PljitHandle::getProfile() const {
+    unique_lock lock(uniqueMutex);
+    return profile ? *profile : ExecutionProfile();
+}
+//---------------------------------------------------------------------------
+// Write the recorded execution profile to a file
+bool PljitHandle::saveProfile(const string& path) const {
+    return getProfile().save(path);
+}
+//---------------------------------------------------------------------------
+// Compile a version specialized for the dominant parameter values of a profile
+bool PljitHandle::applyProfile(const ExecutionProfile& executionProfile, double minShare) {
     unique_lock lock(uniqueMutex);
-    functionsRef[position]->evaluate(evaluationContext);
 
-    if (functionsRef[position]->errorOccurred()) {
-        return nullopt;
+    if (isFinalized() || !ensureCompiled()) {
+        return false;
     }
 
-    return evaluationContext.getReturnValue();
+    ParameterBinding binding;
+    for (size_t i = 0; i < version->arity; i++) {
+        if (optional<int64_t> value = executionProfile.getDominantValue(i, minShare)) {
+            binding.emplace_back(i, *value);
+        }
+    }
+    if (binding.empty()) {
+        return false;
+    }
+
+    unique_ptr<ASTNode> function = compile(binding);
+    if (!function) {
+        return false;
+    }
+
+    // The version belongs to the current version of the function, so it is not evicted like the versions of explicit bindings
+    auto profiledVersion = make_shared<Version>(*version);
+    profiledVersion->profileSpecialization = shareFunction(move(function));
+    profiledVersion->profileBinding = move(binding);
+    version = move(profiledVersion);
+    return true;
+}
+//---------------------------------------------------------------------------
+// Apply the profile of a file
+bool PljitHandle::loadProfile(const string& path, double minShare) {
+    optional<ExecutionProfile> executionProfile = ExecutionProfile::load(path);
+    if (!executionProfile) {
+        return false;
+    }
+    return applyProfile(*executionProfile, minShare);
+}
+//---------------------------------------------------------------------------
+// Return the parameters the version chosen by the profile is specialized for
+ParameterBinding PljitHandle::getProfileBinding() const {
+    unique_lock lock(uniqueMutex);
+    return version ? version->profileBinding : ParameterBinding();
+}
+//---------------------------------------------------------------------------
+// Return whether the parameters of a call have the values the profile chose
+bool PljitHandle::Version::matchesProfileBinding(span<const int64_t> parameters) const {
+    return all_of(profileBinding.begin(), profileBinding.end(), [&](const pair<size_t, int64_t>& bound) {
+        return bound.first < parameters.size() && parameters[bound.first] == bound.second;
+    });
+}
+//---------------------------------------------------------------------------
+// Compile the version specialized for the bound parameters in advance
+bool PljitHandle::specialize(const ParameterBinding& binding) {
+    ParameterBinding normalizedBinding = SpecializationCache::normalize(binding);
+    unique_lock lock(uniqueMutex);
+    return !isFinalized() && getSpecialization(normalizedBinding) != nullptr;
+}
+//---------------------------------------------------------------------------
+// Set the maximum number of cached specialized versions
+void PljitHandle::setSpecializationCapacity(size_t capacity) {
+    unique_lock lock(uniqueMutex);
+    specializations.setCapacity(capacity);
+}
+//---------------------------------------------------------------------------
+// Memoize the results of the function
+bool PljitHandle::enableMemoization(size_t memoryBudget) {
+    unique_lock lock(uniqueMutex);
+
+    if (isFinalized() || !ensureCompiled()) {
+        return false;
+    }
+
+    memoization = make_shared<MemoizationCache>(version->arity, memoryBudget);
+    return true;
+}
+//---------------------------------------------------------------------------
+// Stop memoizing the results of the function
+void PljitHandle::disableMemoization() {
+    unique_lock lock(uniqueMutex);
+    memoization.reset();
+}
+//---------------------------------------------------------------------------
+// Return the hit and miss counters of the memoization cache
+MemoizationStatistics PljitHandle::getMemoizationStatistics() const {
+    unique_lock lock(uniqueMutex);
+
+    if (!memoization) {
+        return MemoizationStatistics();
+    }
+    return memoization->getStatistics();
+}
+//---------------------------------------------------------------------------
+// Limit the number of nodes every later call may evaluate
+void PljitHandle::setFuelLimit(uint64_t fuel) {
+    fuelLimit.store(fuel, memory_order_relaxed);
+
+    // The registration is recorded again, so a replay evaluates the later calls with the same limit
+    if (shared_ptr<Recorder> recorder = functionsRef.getRecorder()) {
+        shared_ptr<const Version> current;
+        {
+            unique_lock lock(uniqueMutex);
+            current = version;
+        }
+        recorder->recordRegistration(id, getCode(current.get()), getRecordedSettings(current.get()), true);
+    }
+}
+//---------------------------------------------------------------------------
+// Set the optimization passes
+void PljitHandle::setPassManager(PassManager passManager1) {
+    // The arithmetic mode is fixed for the lifetime of the handle
+    unique_lock lock(uniqueMutex);
+    passManager = PassManager(passManager1.getPipeline(), arithmeticMode);
+}
+//---------------------------------------------------------------------------
+// Return the measurements of the passes of the last compilation
+vector<PassStatistics> PljitHandle::getPassStatistics() const {
+    unique_lock lock(uniqueMutex);
+    return passStatistics;
+}
+//---------------------------------------------------------------------------
+// Return the measurements of the handle
+InstrumentationSnapshot PljitHandle::getInstrumentation() const {
+    return instrumentation.getSnapshot();
+}
+//---------------------------------------------------------------------------
+// Return the metrics of the handle
+MetricsSnapshot PljitHandle::getMetrics() const {
+    return metrics->getSnapshot();
+}
+//---------------------------------------------------------------------------
+// Convert the compiled function into an immutable code image
+bool PljitHandle::finalize() {
+    unique_lock lock = lockHandle();
+
+    if (!ensureCompiled()) {
+        return false;
+    }
+    if (isFinalized()) {
+        return true;
+    }
+
+    // A function without parameters keeps only its result, the ast is released once the calls that still evaluate it return
+    auto finalizedVersion = make_shared<Version>();
+    finalizedVersion->source = version->source;
+    finalizedVersion->pipeline = version->pipeline;
+    finalizedVersion->arity = version->arity;
+    finalizedVersion->constantFolded = version->constantFolded;
+    finalizedVersion->constantResult = version->constantResult;
+    finalizedVersion->constantOutcome = version->constantOutcome;
+    if (!version->constantFolded) {
+        finalizedVersion->image = make_shared<const ir::CodeImage>(ir::CodeImage::build(*version->function, arithmeticMode));
+    }
+    version = move(finalizedVersion);
+
+    specializations.clear();
+    profile.reset();
+    profiling = false;
+    memoization.reset();
+    incrementalCompiler = IncrementalCompiler();
+    passStatistics = vector<PassStatistics>();
+    finalized.store(true, memory_order_release);
+    return true;
+}
+//---------------------------------------------------------------------------
+// Return the aggregated metrics of all handles
+MetricsSnapshot Pljit::getMetrics() const {
+    return functions.getAggregateMetrics();
+}
+//---------------------------------------------------------------------------
+// Return the metrics of every handle
+vector<MetricsSnapshot> Pljit::getHandleMetrics() const {
+    vector<MetricsSnapshot> snapshots;
+    for (const auto& handleMetrics : functions.getMetrics()) {
+        snapshots.push_back(handleMetrics->getSnapshot());
+    }
+    return snapshots;
+}
+//---------------------------------------------------------------------------
+// Record all registrations and invocations in a binary file
+bool Pljit::startRecording(const string& path) {
+    auto recorder = make_shared<Recorder>(path);
+    if (!recorder->isOpen()) {
+        return false;
+    }
+    functions.setRecorder(move(recorder));
+    return true;
+}
+//---------------------------------------------------------------------------
+// Stop the recording
+void Pljit::stopRecording() {
+    functions.setRecorder(nullptr);
+}
+//---------------------------------------------------------------------------
+// Register many functions and compile them in parallel
+vector<unique_ptr<PljitHandle>> Pljit::registerFunctions(ThreadPool& pool, span<const string_view> inputs, OptimizationLevel level, ArithmeticMode mode) {
+    vector<unique_ptr<PljitHandle>> handles;
+    vector<future<bool>> compilations;
+
+    for (string_view input : inputs) {
+        handles.push_back(make_unique<PljitHandle>(functions, input, PassManager(level, mode)));
+        compilations.push_back(handles.back()->compileInBackground(pool));
+    }
+    // The handles are returned once all compilations have finished, failed ones report their errors again when called
+    for (auto& compilation : compilations) {
+        compilation.wait();
+    }
+
+    return handles;
+}
+//---------------------------------------------------------------------------
+// Register all functions of a bundle
+vector<unique_ptr<PljitHandle>> Pljit::registerBundle(ThreadPool& pool, string_view bundle, OptimizationLevel level, ArithmeticMode mode) {
+    vector<string_view> inputs = splitBundle(bundle);
+    return registerFunctions(pool, inputs, level, mode);
+}
+//---------------------------------------------------------------------------
+// Split a bundle into its functions
+vector<string_view> Pljit::splitBundle(string_view bundle) {
+    // A dot only occurs at the end of a function, so the bundle is split without lexing it
+    vector<string_view> inputs;
+    size_t begin = 0;
+    while (begin < bundle.size()) {
+        begin = bundle.find_first_not_of(" \t\n\r", begin);
+        if (begin == string_view::npos) {
+            break;
+        }
+        size_t dot = bundle.find('.', begin);
+        size_t end = dot == string_view::npos ? bundle.size() : dot + 1;
+        inputs.push_back(bundle.substr(begin, end - begin));
+        begin = end;
+    }
+    return inputs;
 }
 //---------------------------------------------------------------------------
 } // namespace pljit
@@ -1,48 +1,327 @@
 #ifndef H_PLJIT
 #define H_PLJIT
+#include "pljit/Executor.hpp"
+#include "pljit/HandleMetrics.hpp"
+#include "pljit/IncrementalCompiler.hpp"
+#include "pljit/Instrumentation.hpp"
+#include "pljit/MemoizationCache.hpp"
+#include "pljit/PassManager.hpp"
+#include "pljit/Recorder.hpp"
+#include "pljit/SpecializationCache.hpp"
+#include "pljit/Task.hpp"
+#include "pljit/ThreadPool.hpp"
+#include "pljit/ir/CodeImage.hpp"
 #include "pljit/semantic/SemanticAnalysis.hpp"
+#include <array>
+#include <concepts>
+#include <map>
 #include <mutex>
+#include <span>
 //---------------------------------------------------------------------------
 namespace pljit {
 //---------------------------------------------------------------------------
+/// Class that holds what the handles of a Pljit instance share, handles may register concurrently
+/// Every handle owns its compiled functions, they are allocated from the memory resource of the storage.
+class FunctionStorage {
+    public:
+    /// Constructor, the asts are allocated from the memory resource, it has to be thread-safe and outlive the storage
+    explicit FunctionStorage(pmr::memory_resource* resource = pmr::get_default_resource()) : resource(resource) {}
+    /// Register a handle, its code and settings are recorded if there is a recorder
+    void addHandle(uint64_t handleId, string_view code, const RecordedSettings& settings, shared_ptr<const HandleMetrics> handleMetrics);
+    /// Unregister a destroyed handle, its metrics are added to the metrics of the destroyed handles and released
+    void removeHandle(uint64_t handleId);
+    /// Set the recorder of the registrations and invocations, nullptr stops the recording
+    void setRecorder(shared_ptr<Recorder> recorder1);
+    /// Return the recorder, nullptr if nothing is recorded
+    shared_ptr<Recorder> getRecorder() const;
+    /// Return whether the registrations and invocations are recorded
+    bool isRecording() const { return recording.load(memory_order_relaxed); }
+    /// Return the metrics of all registered handles
+    vector<shared_ptr<const HandleMetrics>> getMetrics() const;
+    /// Return the metrics of all handles added up, the handles that were destroyed are included
+    MetricsSnapshot getAggregateMetrics() const;
+    /// Return the memory resource of the asts
+    pmr::memory_resource* getMemoryResource() const { return resource; }
+
+    private:
+    /// Storage of the metrics of all registered handles by their id
+    map<uint64_t, shared_ptr<const HandleMetrics>> metrics;
+    /// Storage of the metrics of the destroyed handles added up
+    MetricsSnapshot retiredMetrics;
+    /// Storage of the recorder
+    shared_ptr<Recorder> recorder;
+    /// Storage of whether there is a recorder, it is checked without the lock on every call
+    atomic<bool> recording = false;
+    /// Storage of the mutex that protects the metrics and the recorder
+    mutable mutex functionsMutex;
+    /// Storage of the memory resource of the asts
+    pmr::memory_resource* resource;
+};
 /// struct that represents a function handle
 struct PljitHandle {
     /// Constructor
-    PljitHandle(vector<unique_ptr<ASTNode>>& functionsRef, string_view code) : functionsRef(functionsRef), code(code) {}
-    /// Destructor
-    ~PljitHandle() = default;
-    /// Overloaded function call
-    optional<int64_t> operator()(const vector<int64_t>& parameters);
+    PljitHandle(FunctionStorage& functionsRef, string_view code, PassManager passManager = PassManager()) : functionsRef(functionsRef), code(code), passManager(move(passManager)) { functionsRef.addHandle(id, code, getRecordedSettings(nullptr), metrics); }
+    /// Destructor, the metrics of the handle are added to the metrics of the destroyed handles
+    ~PljitHandle();
+    /// Overloaded function call, returns nullopt if the number of parameters does not match the function
+    optional<int64_t> operator()(const vector<int64_t>& parameters) { return call(parameters, true); }
+    /// Function call without a heap allocation
+    optional<int64_t> operator()(span<const int64_t> parameters) { return call(parameters, true); }
+    /// Function call that reports its outcome, e.g. to tell an exhausted fuel from a division by zero
+    optional<int64_t> operator()(span<const int64_t> parameters, CallOutcome& outcome) { return call(parameters, true, &outcome); }
+    /// Function call with the parameters passed as arguments
+    template <typename... Args>
+        requires(convertible_to<Args, int64_t> && ...)
+    optional<int64_t> operator()(Args... args) {
+        array<int64_t, sizeof...(Args)> parameters = {static_cast<int64_t>(args)...};
+        return call(parameters, true);
+    }
+    /// Function call of the version specialized for the bound parameters, their entries in parameters are ignored
+    optional<int64_t> operator()(const ParameterBinding& binding, span<const int64_t> parameters);
+    /// Evaluate several calls at once, one evaluation context is reused for all calls and the version is evaluated without the lock
+    /// The failed calls of a batch are only counted in the metrics, they are not reported on stderr like a single call.
+    vector<optional<int64_t>> evaluateBatch(span<const vector<int64_t>> calls);
+    /// Compile the function on the pool, the future tells whether it compiled
+    future<bool> compileInBackground(ThreadPool& pool);
+    /// Evaluate many calls on the pool, every task evaluates a morsel of calls with its own evaluation context
+    /// All calls evaluate the version of the start of the batch, even if the function is updated or finalized meanwhile.
+    vector<optional<int64_t>> evaluateParallel(ThreadPool& pool, span<const vector<int64_t>> calls, size_t morselSize = 256);
+    /// Evaluate calls whose parameters are stored one after another, every call has as many parameters as the function
+    /// No memory is allocated per call and the calls are not recorded, so it can run concurrently on many threads.
+    /// All calls evaluate the version of the start of the batch.
+    /// Returns false if the function does not compile or parameters does not hold one row per result.
+    bool evaluateRows(span<const int64_t> parameters, span<optional<int64_t>> results);
+    /// Return the number of parameters of the function, compiles it if needed, returns nullopt if it does not compile
+    optional<size_t> getParameterCount();
+    /// Asynchronous function call, the compilation and evaluation run on the executor and the awaiting coroutine is resumed there
+    Task<optional<int64_t>> callAsync(Executor& executor, vector<int64_t> parameters);
+    /// Replace the code of the function, only the statements around the changed characters are analyzed again
+    /// Returns false and keeps the current version if the new code does not compile. The replaced version is released once the calls that evaluate it return.
+    bool update(string newCode);
+    /// Return how much of the function the last successful update analyzed again
+    UpdateStatistics getUpdateStatistics() const;
+    /// Record an execution profile of the later calls, it counts the executions, time and divisions by zero of every statement
+    void enableProfiling();
+    /// Stop recording the execution profile, the recorded profile is kept
+    void disableProfiling();
+    /// Return the recorded execution profile
+    ExecutionProfile getProfile() const;
+    /// Write the recorded execution profile to a file, returns false if it cannot be written
+    bool saveProfile(const string& path) const;
+    /// Compile a version specialized for the parameters that had one value in at least minShare of the profiled calls
+    /// Later calls with these values use it, returns false if the function does not compile or no parameter has a dominant value.
+    bool applyProfile(const ExecutionProfile& executionProfile, double minShare = 0.9);
+    /// Apply the profile of a file, returns false if it cannot be read or is not applied
+    bool loadProfile(const string& path, double minShare = 0.9);
+    /// Return the parameters the version chosen by the profile is specialized for
+    ParameterBinding getProfileBinding() const;
+    /// Compile the version specialized for the bound parameters in advance
+    bool specialize(const ParameterBinding& binding);
+    /// Set the maximum number of cached specialized versions
+    void setSpecializationCapacity(size_t capacity);
+    /// Memoize the results of the function within the memory budget (in bytes), returns false if it does not compile
+    bool enableMemoization(size_t memoryBudget = 1 << 20);
+    /// Stop memoizing the results of the function
+    void disableMemoization();
+    /// Return the hit and miss counters of the memoization cache
+    MemoizationStatistics getMemoizationStatistics() const;
+    /// Limit the number of nodes every later call may evaluate, 0 for no limit
+    /// The fuel is consumed per statement, a call that runs out of it fails with CallOutcome::FuelExhausted.
+    void setFuelLimit(uint64_t fuel);
+    uint64_t getFuelLimit() const { return fuelLimit.load(memory_order_relaxed); }
+    /// Set the optimization passes, they are used for all later compilations, the arithmetic mode of the handle is kept
+    void setPassManager(PassManager passManager1);
+    /// Return the measurements of the passes of the last compilation
+    vector<PassStatistics> getPassStatistics() const;
+    /// Return the per-phase measurements of the handle, they are only recorded if PLJIT_INSTRUMENTATION is defined
+    /// The phases are also written as spans to an active Tracer
+    InstrumentationSnapshot getInstrumentation() const;
+    /// Return the call counts, errors, latencies and lock waits of the handle, they are always recorded
+    MetricsSnapshot getMetrics() const;
+    /// Convert the compiled function into an immutable code image and release its ast, symbols and specialized versions
+    /// Later calls run on the image without the mutex of the handle. Afterwards the handle cannot be updated, specialized, profiled or memoized
+    /// and getFunctionRef must not be called. The code is kept for a recording that starts later. Returns false if the function does not compile.
+    bool finalize();
+    /// Return the code image, nullptr if the handle is not finalized or its function has no parameters
+    const ir::CodeImage* getImage() const { return isFinalized() ? version->image.get() : nullptr; }
+    /// Return whether the function has no parameters and was evaluated during the compilation
+    bool isConstantFolded() const;
     /// Getters
-    bool isCompiled() const { return compiled; }
-    ASTNode& getFunctionRef() const { return *functionsRef[position]; }
+    bool isCompiled() const { return compiled.load(memory_order_acquire); }
+    bool isFinalized() const { return finalized.load(memory_order_acquire); }
+    uint64_t getId() const { return id; }
+    /// Return the current compiled function, the reference is only valid until the function is updated
+    ASTNode& getFunctionRef() const { return *version->function; }
+
+    protected:
+    /// Constructor of a handle whose calls always provide the expected number of parameters, the compilation fails if the function declares a different number
+    PljitHandle(FunctionStorage& functionsRef, string_view code, PassManager passManager, size_t expectedArity) : functionsRef(functionsRef), code(code), expectedArity(expectedArity), passManager(move(passManager)) { functionsRef.addHandle(id, code, getRecordedSettings(nullptr), metrics); }
+    /// Function call, the number of parameters is only compared with the function if checkArity is set, the outcome is stored if it is not nullptr
+    optional<int64_t> call(span<const int64_t> parameters, bool checkArity, CallOutcome* outcome = nullptr);
 
     private:
+    /// Struct that represents a compiled version of the function, it is never modified once it is published
+    /// An update, an applied profile or the finalization publishes a new version. Every call keeps the version it evaluates alive,
+    /// so a replaced version is released when its last call returns.
+    struct Version {
+        /// Storage of the compiled function, nullptr if the version is finalized
+        shared_ptr<Function> function;
+        /// Storage of the codes the names of the functions refer to
+        vector<shared_ptr<const string>> sources;
+        /// Storage of the code of the update the version was compiled from, nullptr for the code of the registration
+        shared_ptr<const string> source;
+        /// Storage of the passes the version was compiled with
+        vector<Pass> pipeline;
+        /// Storage of the number of parameters
+        size_t arity = 0;
+        /// Storage of whether the function has no parameters and was evaluated during the compilation, its result and outcome
+        bool constantFolded = false;
+        optional<int64_t> constantResult;
+        CallOutcome constantOutcome = CallOutcome::Success;
+        /// Storage of the version specialized for the values chosen by the profile, nullptr if there is none
+        shared_ptr<Function> profileSpecialization;
+        /// Storage of the values chosen by the profile
+        ParameterBinding profileBinding;
+        /// Storage of the code image of a finalized version, nullptr if the function has no parameters
+        shared_ptr<const ir::CodeImage> image;
+        /// Return whether the version is finalized
+        bool isFinalized() const { return !function; }
+        /// Return whether the parameters of a call have the values the profile chose
+        bool matchesProfileBinding(span<const int64_t> parameters) const;
+    };
+    /// Struct that represents calls whose parameters are stored one after another
+    struct ParameterRows {
+        span<const int64_t> values;
+        size_t width;
+        size_t count;
+        size_t size() const { return count; }
+        span<const int64_t> operator[](size_t i) const { return values.subspan(i * width, width); }
+    };
+    /// Compile the function if needed and evaluate one call, the outcome is set for the metrics
+    /// The evaluated version is stored in current unless the handle is finalized or the function does not compile.
+    optional<int64_t> evaluateCall(span<const int64_t> parameters, bool checkArity, CallOutcome& outcome, shared_ptr<const Version>& current);
+    /// Record the invocations of a version in the recorder of the functions reference, nullptr if the function did not compile
+    void recordInvocations(Recorder::TimePoint begin, span<const vector<int64_t>> calls, span<const optional<int64_t>> results, const Version* current) const;
+    /// Return the code of a version, the code of the registration if there is no version or it was not updated
+    string_view getCode(const Version* current) const { return current && current->source ? *current->source : code; }
+    /// Return the settings of a version for a recording, the passes of the handle if there is no version
+    /// Without a version the mutex is taken, so it must not be held.
+    RecordedSettings getRecordedSettings(const Version* current) const;
+    /// Lock the mutex of the handle and record the time spent waiting for it
+    unique_lock<mutex> lockHandle();
+    /// Compile the function if it is not compiled yet, the mutex has to be held
+    bool ensureCompiled();
+    /// Compile the code of the current version with the bound parameters treated as constants, returns nullptr on error
+    unique_ptr<ASTNode> compile(const ParameterBinding& binding);
+    /// Create the version of a compiled function, a function without parameters is evaluated once
+    shared_ptr<Version> createVersion(unique_ptr<ASTNode> function, size_t parameterCount, vector<shared_ptr<const string>> sources = {});
+    /// Return the specialized version of a binding, compiles it if it is not cached
+    ASTNode* getSpecialization(const ParameterBinding& binding);
+    /// Evaluate a compiled function, the execution is recorded in the profile if it is not nullptr
+    /// The outcome of a failed evaluation is stored if it is not nullptr. The fuel limit only applies to calls, so it is not used during the compilation.
+    optional<int64_t> evaluate(ASTNode& function, span<const int64_t> parameters, ExecutionProfile* executionProfile = nullptr, CallOutcome* outcome = nullptr, bool limitFuel = true);
+    /// Evaluate a call of a finalized version, it needs no lock, an error is only reported on stderr if reportErrors is set
+    optional<int64_t> evaluateImage(const Version& current, span<const int64_t> parameters, CallOutcome& outcome, bool reportErrors = true) const;
+    /// Evaluate calls of a version with one evaluation context, it does not modify the handle and needs no lock
+    /// The errors of the calls are counted in the metrics, they are not reported on stderr
+    /// Calls is a span of vectors or ParameterRows, calls[i] has to convert to the parameters of the i-th call.
+    template <typename Calls>
+    void evaluateCalls(const Calls& calls, span<optional<int64_t>> results, const Version& current, MemoizationCache* memoizationCache, ExecutionProfile* executionProfile) const;
+    /// Report a call with the wrong number of parameters
+    static void errorParameterCount(size_t expected, size_t actual);
+    /// Storage of the number of created handles
+    static inline atomic<uint64_t> handles = 0;
     /// Storage of the functions reference
-    vector<unique_ptr<ASTNode>>& functionsRef;
-    /// Storage of the code
-    string_view code;
-    /// Storage of whether the function was already compiled
-    bool compiled = false;
+    FunctionStorage& functionsRef;
+    /// Storage of the id of the handle, it tags its spans in a trace
+    uint64_t id = handles.fetch_add(1) + 1;
+    /// Storage of the metrics, they are shared with the functions reference
+    shared_ptr<HandleMetrics> metrics = make_shared<HandleMetrics>(id);
+    /// Storage of the code of the registration, the versions of an update keep their own code
+    const string_view code;
+    /// Storage of the compiler of the updates
+    IncrementalCompiler incrementalCompiler{functionsRef.getMemoryResource()};
+    /// Storage of whether the function was already compiled, it is set after all other compilation results
+    atomic<bool> compiled = false;
     /// Storage of the mutex
-    mutex uniqueMutex;
-    /// Storage of the position of the current function
-    size_t position = 0;
+    mutable mutex uniqueMutex;
+    /// Storage of the current version, it is replaced under the mutex and only read without it once the handle is finalized
+    shared_ptr<const Version> version;
+    /// Storage of the number of parameters the calls provide, nullopt if it is checked on every call
+    optional<size_t> expectedArity;
+    /// Storage of the specialized versions of the function
+    SpecializationCache specializations;
+    /// Storage of the memoized results, nullptr if memoization is disabled
+    shared_ptr<MemoizationCache> memoization;
+    /// Storage of the recorded execution profile, nullptr if nothing was recorded
+    shared_ptr<ExecutionProfile> profile;
+    /// Storage of whether the calls are recorded in the profile
+    bool profiling = false;
+    /// Storage of whether the handle was finalized, it is set after its version was replaced by the finalized one
+    atomic<bool> finalized = false;
+    /// Storage of the fuel of every call, 0 for no limit
+    atomic<uint64_t> fuelLimit = 0;
+    /// Storage of the optimization passes
+    PassManager passManager;
+    /// Storage of the arithmetic mode, it is chosen at the registration
+    const ArithmeticMode arithmeticMode = passManager.getArithmeticMode();
+    /// Storage of the measurements of the passes of the last compilation
+    vector<PassStatistics> passStatistics;
+    /// Storage of the per-phase measurements
+    Instrumentation instrumentation{id};
+};
+/// Struct that represents a function handle with a fixed number of parameters, it is checked once during the compilation
+template <size_t N>
+struct TypedPljitHandle : PljitHandle {
+    /// Constructor
+    TypedPljitHandle(FunctionStorage& functionsRef, string_view code, PassManager passManager = PassManager()) : PljitHandle(functionsRef, code, move(passManager), N) {}
+    /// Function call with the parameters passed as arguments, their number is checked by the compiler
+    template <typename... Args>
+        requires(sizeof...(Args) == N && (convertible_to<Args, int64_t> && ...))
+    optional<int64_t> operator()(Args... args) {
+        array<int64_t, N> parameters = {static_cast<int64_t>(args)...};
+        return call(parameters, false);
+    }
+    /// Function call with the parameters passed as an array
+    optional<int64_t> operator()(const array<int64_t, N>& parameters) { return call(parameters, false); }
 };
 /// Struct that represents the Pljit compiler
 struct Pljit {
-    /// Constructor
+    /// Constructors, the ast nodes and symbol tables of all handles are allocated from the memory resource at every optimization level, e.g. a synchronized pool
+    /// The resource has to be thread-safe and outlive the compiler, the parse trees always use a buffer that is released after each compilation, the statement lists use the global allocator.
     Pljit() = default;
+    explicit Pljit(pmr::memory_resource* resource) : functions(resource) {}
     /// Destructor
     ~Pljit() = default;
-    /// Register a function from the user
-    PljitHandle registerFunction(string_view input) {
-        return PljitHandle(functions, input);
+    /// Register a function from the user, its calls wrap, trap or saturate on an overflow depending on the arithmetic mode
+    PljitHandle registerFunction(string_view input, OptimizationLevel level = OptimizationLevel::O1, ArithmeticMode mode = ArithmeticMode::Wrapping) {
+        return PljitHandle(functions, input, PassManager(level, mode));
+    }
+    /// Register a function from the user that is always called with N parameters
+    template <size_t N>
+    TypedPljitHandle<N> registerFunction(string_view input, OptimizationLevel level = OptimizationLevel::O1, ArithmeticMode mode = ArithmeticMode::Wrapping) {
+        return TypedPljitHandle<N>(functions, input, PassManager(level, mode));
     }
+    /// Return the metrics of all handles added up, the handles that were destroyed are included
+    MetricsSnapshot getMetrics() const;
+    /// Return the metrics of every handle that still exists
+    vector<MetricsSnapshot> getHandleMetrics() const;
+    /// Record all registrations and the later invocations of single calls and batches in a binary file, returns false if it cannot be opened
+    /// Handles that were registered before are recorded on their first invocation
+    bool startRecording(const string& path);
+    /// Stop the recording and write the file
+    void stopRecording();
+    /// Register many functions and compile them in parallel on the pool, the codes have to outlive the handles
+    vector<unique_ptr<PljitHandle>> registerFunctions(ThreadPool& pool, span<const string_view> inputs, OptimizationLevel level = OptimizationLevel::O1, ArithmeticMode mode = ArithmeticMode::Wrapping);
+    /// Register all functions of a bundle and compile them in parallel on the pool, the bundle has to outlive the handles
+    /// The functions are lexed in place, so the bundle may be a mapped file without a terminating NUL character.
+    vector<unique_ptr<PljitHandle>> registerBundle(ThreadPool& pool, string_view bundle, OptimizationLevel level = OptimizationLevel::O1, ArithmeticMode mode = ArithmeticMode::Wrapping);
+    /// Split a bundle into its functions, every function ends with the dot after its END, the views refer to the bundle
+    static vector<string_view> splitBundle(string_view bundle);
 
     private:
     /// Storage of the functions
-    vector<unique_ptr<ASTNode>> functions;
+    FunctionStorage functions;
 };
 //---------------------------------------------------------------------------
 } // namespace pljit
@@ -0,0 +1,244 @@
+#include "pljit/Recorder.hpp"
+#include <iterator>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+/// Magic and version of the file format
+constexpr string_view magic = "PLJT";
+constexpr uint64_t version = 2;
+//---------------------------------------------------------------------------
+/// Struct that reads the variable-length integers of a file
+struct Reader {
+    /// Storage of the unread bytes
+    string_view bytes;
+    /// Read a byte
+    optional<uint8_t> readByte() {
+        if (bytes.empty()) {
+            return nullopt;
+        }
+        auto byte = static_cast<uint8_t>(bytes.front());
+        bytes.remove_prefix(1);
+        return byte;
+    }
+    /// Read an unsigned integer
+    optional<uint64_t> readUnsigned() {
+        uint64_t value = 0;
+        for (unsigned shift = 0; shift < 64; shift += 7) {
+            optional<uint8_t> byte = readByte();
+            if (!byte) {
+                return nullopt;
+            }
+            value |= static_cast<uint64_t>(*byte & 0x7f) << shift;
+            if (!(*byte & 0x80)) {
+                return value;
+            }
+        }
+        return nullopt;
+    }
+    /// Read a signed integer
+    optional<int64_t> readSigned() {
+        optional<uint64_t> value = readUnsigned();
+        if (!value) {
+            return nullopt;
+        }
+        return static_cast<int64_t>((*value >> 1) ^ (~(*value & 1) + 1));
+    }
+};
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+// Constructor
+Recorder::Recorder(const string& path) : session(sessions.fetch_add(1) + 1), epoch(chrono::steady_clock::now()), out(path, ios::binary) {
+    buffer.append(magic);
+    writeUnsigned(version);
+}
+//---------------------------------------------------------------------------
+// Destructor
+Recorder::~Recorder() {
+    unique_lock lock(recorderMutex);
+    flush();
+}
+//---------------------------------------------------------------------------
+// Record the code of a handle
+void Recorder::recordRegistration(uint64_t handleId, string_view code, const RecordedSettings& settings, bool update) {
+    TimePoint now = chrono::steady_clock::now();
+    unique_lock lock(recorderMutex);
+
+    if (!registered.insert(handleId).second && !update) {
+        return;
+    }
+    writeRegistration(handleId, code, settings, now);
+}
+//---------------------------------------------------------------------------
+// Record an invocation
+void Recorder::recordInvocation(uint64_t handleId, string_view code, const RecordedSettings& settings, TimePoint begin, span<const int64_t> parameters, optional<int64_t> result) {
+    unique_lock lock(recorderMutex);
+
+    // The registration gets the time of the invocation, so the events of a thread stay ordered
+    if (registered.insert(handleId).second) {
+        writeRegistration(handleId, code, settings, begin);
+    }
+    writeEventHeader(RecordedEvent::Kind::Invocation, handleId, begin);
+    writeUnsigned(parameters.size());
+    for (int64_t parameter : parameters) {
+        writeSigned(parameter);
+    }
+    buffer.push_back(result ? 1 : 0);
+    if (result) {
+        writeSigned(*result);
+    }
+    if (buffer.size() >= flushSize) {
+        flush();
+    }
+}
+//---------------------------------------------------------------------------
+// Write a registration
+void Recorder::writeRegistration(uint64_t handleId, string_view code, const RecordedSettings& settings, TimePoint time) {
+    writeEventHeader(RecordedEvent::Kind::Registration, handleId, time);
+    writeUnsigned(code.size());
+    buffer.append(code);
+    writeUnsigned(settings.pipeline.size());
+    for (Pass pass : settings.pipeline) {
+        writeUnsigned(static_cast<uint64_t>(pass));
+    }
+    writeUnsigned(static_cast<uint64_t>(settings.arithmeticMode));
+    writeUnsigned(settings.fuelLimit);
+}
+//---------------------------------------------------------------------------
+// Write the header of an event
+void Recorder::writeEventHeader(RecordedEvent::Kind kind, uint64_t handleId, TimePoint time) {
+    thread_local uint64_t threadSession = 0;
+    thread_local uint32_t threadNumber = 0;
+    if (threadSession != session) {
+        threadSession = session;
+        threadNumber = threads++;
+    }
+
+    events++;
+    buffer.push_back(static_cast<char>(kind));
+    writeUnsigned(threadNumber);
+    writeUnsigned(static_cast<uint64_t>(max<int64_t>((time - epoch).count(), 0)));
+    writeUnsigned(handleId);
+}
+//---------------------------------------------------------------------------
+// Append a variable-length unsigned integer
+void Recorder::writeUnsigned(uint64_t value) {
+    while (value >= 0x80) {
+        buffer.push_back(static_cast<char>((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    buffer.push_back(static_cast<char>(value));
+}
+//---------------------------------------------------------------------------
+// Append a variable-length signed integer, small negative values stay short
+void Recorder::writeSigned(int64_t value) {
+    writeUnsigned((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+}
+//---------------------------------------------------------------------------
+// Write the buffer to the file
+void Recorder::flush() {
+    out.write(buffer.data(), static_cast<streamsize>(buffer.size()));
+    out.flush();
+    buffer.clear();
+}
+//---------------------------------------------------------------------------
+// Return the number of recorded events
+size_t Recorder::getEventCount() const {
+    unique_lock lock(recorderMutex);
+    return events;
+}
+//---------------------------------------------------------------------------
+// Read the events of a file
+optional<vector<RecordedEvent>> Recorder::read(const string& path) {
+    ifstream in(path, ios::binary);
+    if (!in) {
+        return nullopt;
+    }
+    string content((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+
+    Reader reader{content};
+    if (!reader.bytes.starts_with(magic)) {
+        return nullopt;
+    }
+    reader.bytes.remove_prefix(magic.size());
+    if (reader.readUnsigned() != version) {
+        return nullopt;
+    }
+
+    vector<RecordedEvent> events;
+    while (!reader.bytes.empty()) {
+        RecordedEvent event;
+        optional<uint8_t> kind = reader.readByte();
+        optional<uint64_t> thread = reader.readUnsigned();
+        optional<uint64_t> timestamp = reader.readUnsigned();
+        optional<uint64_t> handleId = reader.readUnsigned();
+        if (!kind || !thread || !timestamp || !handleId) {
+            return nullopt;
+        }
+        event.thread = static_cast<uint32_t>(*thread);
+        event.timestamp = chrono::nanoseconds(*timestamp);
+        event.handleId = *handleId;
+
+        if (*kind == static_cast<uint8_t>(RecordedEvent::Kind::Registration)) {
+            event.kind = RecordedEvent::Kind::Registration;
+            optional<uint64_t> length = reader.readUnsigned();
+            if (!length || *length > reader.bytes.size()) {
+                return nullopt;
+            }
+            event.code = reader.bytes.substr(0, *length);
+            reader.bytes.remove_prefix(*length);
+
+            optional<uint64_t> passCount = reader.readUnsigned();
+            if (!passCount || *passCount > reader.bytes.size()) {
+                return nullopt;
+            }
+            event.settings.pipeline.clear();
+            for (uint64_t i = 0; i < *passCount; i++) {
+                optional<uint64_t> pass = reader.readUnsigned();
+                if (!pass || *pass > static_cast<uint64_t>(Pass::SSADeadCode)) {
+                    return nullopt;
+                }
+                event.settings.pipeline.push_back(static_cast<Pass>(*pass));
+            }
+            optional<uint64_t> arithmeticMode = reader.readUnsigned();
+            optional<uint64_t> fuelLimit = reader.readUnsigned();
+            if (!arithmeticMode || *arithmeticMode > static_cast<uint64_t>(ArithmeticMode::Saturating) || !fuelLimit) {
+                return nullopt;
+            }
+            event.settings.arithmeticMode = static_cast<ArithmeticMode>(*arithmeticMode);
+            event.settings.fuelLimit = *fuelLimit;
+        } else if (*kind == static_cast<uint8_t>(RecordedEvent::Kind::Invocation)) {
+            event.kind = RecordedEvent::Kind::Invocation;
+            optional<uint64_t> count = reader.readUnsigned();
+            if (!count || *count > reader.bytes.size()) {
+                return nullopt;
+            }
+            for (uint64_t i = 0; i < *count; i++) {
+                optional<int64_t> parameter = reader.readSigned();
+                if (!parameter) {
+                    return nullopt;
+                }
+                event.parameters.push_back(*parameter);
+            }
+            optional<uint8_t> hasResult = reader.readByte();
+            if (!hasResult) {
+                return nullopt;
+            }
+            if (*hasResult) {
+                event.result = reader.readSigned();
+                if (!event.result) {
+                    return nullopt;
+                }
+            }
+        } else {
+            return nullopt;
+        }
+        events.push_back(move(event));
+    }
+    return events;
+}
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
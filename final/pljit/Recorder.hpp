@@ -0,0 +1,105 @@
+#ifndef H_PLJIT_RECORDER
+#define H_PLJIT_RECORDER
+#include "pljit/PassManager.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <span>
+#include <string>
+#include <vector>
+using namespace std;
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+/// Struct that represents the settings a handle compiles and evaluates its code with
+struct RecordedSettings {
+    /// Optimization passes
+    vector<Pass> pipeline = PassManager::getPipeline(OptimizationLevel::O1);
+    /// Arithmetic mode
+    ArithmeticMode arithmeticMode = ArithmeticMode::Wrapping;
+    /// Fuel of every call, 0 for no limit
+    uint64_t fuelLimit = 0;
+};
+/// Struct that represents a recorded registration or invocation
+struct RecordedEvent {
+    /// All possible kinds of events
+    enum class Kind : uint8_t {
+        Registration = 1,
+        Invocation = 2
+    };
+    /// Kind of the event
+    Kind kind = Kind::Invocation;
+    /// Number of the recording thread, the threads are numbered in the order of their first event
+    uint32_t thread = 0;
+    /// Time since the begin of the recording
+    chrono::nanoseconds timestamp{0};
+    /// Id of the handle
+    uint64_t handleId = 0;
+    /// Code and settings of a registration, a later registration of the same handle is an update
+    string code;
+    RecordedSettings settings;
+    /// Parameters and result of an invocation
+    vector<int64_t> parameters;
+    optional<int64_t> result;
+};
+/// Class that records registrations and invocations in a compact binary file
+/// The file starts with the magic "PLJT" and a version, every event is a kind byte followed by variable-length integers.
+/// A registration stores the code with its passes, arithmetic mode and fuel limit, so the replay compiles and evaluates it the same way.
+class Recorder {
+    public:
+    /// Type of a point in time
+    using TimePoint = chrono::steady_clock::time_point;
+    /// Constructor
+    explicit Recorder(const string& path);
+    /// Destructor, writes the buffered events
+    ~Recorder();
+    /// Return whether the file was opened
+    bool isOpen() const { return static_cast<bool>(out); }
+    /// Record the code and settings of a handle, they are only recorded once unless it is an update
+    void recordRegistration(uint64_t handleId, string_view code, const RecordedSettings& settings, bool update = false);
+    /// Record an invocation that started at begin, the code and settings are registered first if the handle was not recorded yet
+    void recordInvocation(uint64_t handleId, string_view code, const RecordedSettings& settings, TimePoint begin, span<const int64_t> parameters, optional<int64_t> result);
+    /// Return the number of recorded events
+    size_t getEventCount() const;
+    /// Read the events of a file, returns nullopt if it cannot be read or is malformed
+    static optional<vector<RecordedEvent>> read(const string& path);
+
+    private:
+    /// Write a registration, the mutex has to be held
+    void writeRegistration(uint64_t handleId, string_view code, const RecordedSettings& settings, TimePoint time);
+    /// Write the header of an event, the mutex has to be held
+    void writeEventHeader(RecordedEvent::Kind kind, uint64_t handleId, TimePoint time);
+    /// Append a variable-length unsigned and signed integer to the buffer
+    void writeUnsigned(uint64_t value);
+    void writeSigned(int64_t value);
+    /// Write the buffer to the file
+    void flush();
+    /// Size of the buffer that triggers a write to the file
+    static constexpr size_t flushSize = 1 << 16;
+    /// Storage of the number of created recorders, it tells a thread whether its number belongs to this recorder
+    static inline atomic<uint64_t> sessions = 0;
+    /// Storage of the number of this recorder
+    uint64_t session;
+    /// Storage of the begin of the recording
+    TimePoint epoch;
+    /// Storage of the file
+    ofstream out;
+    /// Storage of the encoded events that were not written yet
+    string buffer;
+    /// Storage of the handles whose code was recorded
+    set<uint64_t> registered;
+    /// Storage of the number of recorded events and threads
+    size_t events = 0;
+    uint32_t threads = 0;
+    /// Storage of the mutex that protects the buffer
+    mutable mutex recorderMutex;
+};
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
+#endif // H_PLJIT_RECORDER
+//---------------------------------------------------------------------------
@@ -0,0 +1,85 @@
+#include "pljit/Replayer.hpp"
+#include "pljit/Pljit.hpp"
+#include <thread>
+#include <unordered_map>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+// Return the number of invocations per second
+double ReplayResult::getThroughput() const {
+    if (duration.count() == 0) {
+        return 0;
+    }
+    return static_cast<double>(invocations) / chrono::duration<double>(duration).count();
+}
+//---------------------------------------------------------------------------
+// Replay the events
+ReplayResult Replayer::run(const ReplayOptions& options) const {
+    Pljit jit;
+    unordered_map<uint64_t, unique_ptr<PljitHandle>> handles;
+    vector<vector<const RecordedEvent*>> threadEvents;
+
+    // The first registration of a handle happens before the replay, so every thread finds all handles
+    for (const auto& event : events) {
+        if (event.kind == RecordedEvent::Kind::Registration && !handles.contains(event.handleId)) {
+            auto handle = unique_ptr<PljitHandle>(new PljitHandle(jit.registerFunction(event.code, OptimizationLevel::O0, event.settings.arithmeticMode)));
+            handle->setPassManager(PassManager(event.settings.pipeline));
+            handle->setFuelLimit(event.settings.fuelLimit);
+            handles.emplace(event.handleId, move(handle));
+            continue;
+        }
+        if (event.thread >= threadEvents.size()) {
+            threadEvents.resize(event.thread + 1);
+        }
+        threadEvents[event.thread].push_back(&event);
+    }
+
+    LatencyHistogram latency;
+    atomic<size_t> invocations = 0;
+    atomic<size_t> mismatches = 0;
+    vector<thread> threads;
+    auto start = chrono::steady_clock::now();
+
+    for (const auto& replayedEvents : threadEvents) {
+        threads.emplace_back([&, start] {
+            for (const RecordedEvent* event : replayedEvents) {
+                auto handle = handles.find(event->handleId);
+                if (handle == handles.end()) {
+                    continue;
+                }
+                if (options.timed) {
+                    this_thread::sleep_until(start + event->timestamp);
+                }
+                if (event->kind == RecordedEvent::Kind::Registration) {
+                    // The arithmetic mode is fixed at the registration, the passes and the fuel limit may change
+                    handle->second->setPassManager(PassManager(event->settings.pipeline));
+                    handle->second->setFuelLimit(event->settings.fuelLimit);
+                    handle->second->update(event->code);
+                    continue;
+                }
+
+                auto begin = chrono::steady_clock::now();
+                optional<int64_t> result = (*handle->second)(span<const int64_t>(event->parameters));
+                latency.record(chrono::steady_clock::now() - begin);
+                invocations.fetch_add(1, memory_order_relaxed);
+                if (result != event->result) {
+                    mismatches.fetch_add(1, memory_order_relaxed);
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    ReplayResult result;
+    result.duration = chrono::steady_clock::now() - start;
+    result.invocations = invocations.load();
+    result.mismatches = mismatches.load();
+    result.threads = threads.size();
+    result.latency = latency.getSnapshot();
+    return result;
+}
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
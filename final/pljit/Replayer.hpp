@@ -0,0 +1,46 @@
+#ifndef H_PLJIT_REPLAYER
+#define H_PLJIT_REPLAYER
+#include "pljit/HandleMetrics.hpp"
+#include "pljit/Recorder.hpp"
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+/// Struct that represents the options of a replay
+struct ReplayOptions {
+    /// Whether the invocations keep their recorded times, otherwise they run as fast as possible
+    bool timed = false;
+};
+/// Struct that represents the measurements of a replay
+struct ReplayResult {
+    /// Number of replayed invocations
+    size_t invocations = 0;
+    /// Number of invocations whose result differs from the recorded one
+    size_t mismatches = 0;
+    /// Number of replaying threads
+    size_t threads = 0;
+    /// Wall time of the replay
+    chrono::nanoseconds duration{0};
+    /// Latencies of the invocations
+    HistogramSnapshot latency;
+    /// Return the number of invocations per second
+    double getThroughput() const;
+};
+/// Class that runs recorded registrations and invocations against the current build
+/// Every recorded thread is replayed by its own thread. All handles are registered before the replay starts, later registrations of a handle update it.
+/// The handles are compiled with the recorded passes and arithmetic mode and evaluated with the recorded fuel limit.
+class Replayer {
+    public:
+    /// Constructor
+    explicit Replayer(vector<RecordedEvent> events) : events(move(events)) {}
+    /// Replay the events
+    ReplayResult run(const ReplayOptions& options = ReplayOptions()) const;
+
+    private:
+    /// Storage of the events, the codes of the handles refer to them
+    vector<RecordedEvent> events;
+};
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
+#endif // H_PLJIT_REPLAYER
+//---------------------------------------------------------------------------
@@ -0,0 +1,656 @@
+#include "pljit/Server.hpp"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+/// Size of the header of a frame
+constexpr size_t headerSize = 2 * sizeof(uint32_t) + sizeof(uint8_t);
+/// Size of a row of a batch response
+constexpr size_t batchResultSize = sizeof(uint8_t) + sizeof(int64_t);
+//---------------------------------------------------------------------------
+// Append a value in native byte order
+template <typename T>
+void append(string& out, T value) {
+    char bytes[sizeof(T)];
+    memcpy(bytes, &value, sizeof(T));
+    out.append(bytes, sizeof(T));
+}
+//---------------------------------------------------------------------------
+// Read a value in native byte order at the position, the caller checks the size
+template <typename T>
+T load(const char* data) {
+    T value;
+    memcpy(&value, data, sizeof(T));
+    return value;
+}
+//---------------------------------------------------------------------------
+// Append a frame
+void appendFrame(string& out, uint32_t requestId, uint8_t type, string_view payload) {
+    append<uint32_t>(out, static_cast<uint32_t>(payload.size()));
+    append<uint32_t>(out, requestId);
+    append<uint8_t>(out, type);
+    out.append(payload);
+}
+//---------------------------------------------------------------------------
+// Fill the address of a Unix domain socket, returns false if the path is too long
+bool makeAddress(const string& path, sockaddr_un& address) {
+    address = {};
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) {
+        return false;
+    }
+    memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    return true;
+}
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+/// Struct that represents a client connection, the socket is closed when the last request of the connection is handled
+struct Server::Connection {
+    /// Constructor
+    explicit Connection(int socket) : socket(socket) {}
+    /// Destructor
+    ~Connection() { close(socket); }
+    /// Storage of the socket
+    int socket;
+    /// Storage of the bytes of incomplete frames, only used by the event loop
+    string input;
+    /// Storage of the responses that could not be written yet
+    string output;
+    /// Storage of the number and payload bytes of the requests that are not answered yet
+    size_t pendingRequests = 0;
+    size_t pendingBytes = 0;
+    /// Storage of the events that the event loop waits for
+    uint32_t events = EPOLLIN;
+    /// Storage of whether the client shut down its sending side
+    bool inputClosed = false;
+    /// Storage of whether the connection was closed by the event loop
+    bool closed = false;
+    /// Storage of the mutex that protects the output, the pending requests and the events
+    mutex outputMutex;
+};
+//---------------------------------------------------------------------------
+// Constructor
+Server::Server(ServerOptions options) : options(options), pool(max<size_t>(options.workers, 1)) {
+}
+//---------------------------------------------------------------------------
+// Destructor
+Server::~Server() {
+    if (listenSocket >= 0) {
+        close(listenSocket);
+        unlink(path.c_str());
+    }
+    if (epoll >= 0) {
+        close(epoll);
+    }
+    if (stopEvent >= 0) {
+        close(stopEvent);
+    }
+}
+//---------------------------------------------------------------------------
+// Bind the socket to the path
+bool Server::listen(const string& path1) {
+    sockaddr_un address;
+    if (listenSocket >= 0 || !makeAddress(path1, address)) {
+        return false;
+    }
+
+    int newSocket = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (newSocket < 0) {
+        return false;
+    }
+    unlink(path1.c_str());
+    if (bind(newSocket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || ::listen(newSocket, SOMAXCONN) != 0) {
+        close(newSocket);
+        return false;
+    }
+
+    epoll = epoll_create1(EPOLL_CLOEXEC);
+    stopEvent = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epoll < 0 || stopEvent < 0) {
+        close(newSocket);
+        unlink(path1.c_str());
+        return false;
+    }
+    epoll_event listenEvent{};
+    listenEvent.events = EPOLLIN;
+    listenEvent.data.fd = newSocket;
+    epoll_ctl(epoll, EPOLL_CTL_ADD, newSocket, &listenEvent);
+    epoll_event stopEventRegistration{};
+    stopEventRegistration.events = EPOLLIN;
+    stopEventRegistration.data.fd = stopEvent;
+    epoll_ctl(epoll, EPOLL_CTL_ADD, stopEvent, &stopEventRegistration);
+
+    listenSocket = newSocket;
+    path = path1;
+    return true;
+}
+//---------------------------------------------------------------------------
+// Serve the connections until stop is called
+bool Server::run() {
+    if (listenSocket < 0) {
+        return false;
+    }
+
+    unordered_map<int, shared_ptr<Connection>> connections;
+    array<epoll_event, 64> events;
+    bool stopping = false;
+    while (!stopping) {
+        int count = epoll_wait(epoll, events.data(), static_cast<int>(events.size()), -1);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+
+        for (int i = 0; i < count; i++) {
+            int descriptor = events[i].data.fd;
+            if (descriptor == stopEvent) {
+                stopping = true;
+                continue;
+            }
+            if (descriptor == listenSocket) {
+                acceptConnections(connections);
+                continue;
+            }
+
+            auto it = connections.find(descriptor);
+            if (it == connections.end()) {
+                continue;
+            }
+            shared_ptr<Connection> connection = it->second;
+            bool open = !(events[i].events & (EPOLLERR | EPOLLHUP));
+            if (open && (events[i].events & EPOLLIN)) {
+                open = readConnection(connection);
+            }
+            if (open && (events[i].events & EPOLLOUT)) {
+                unique_lock lock(connection->outputMutex);
+                flushLocked(*connection);
+            }
+            if (!open) {
+                // The socket is closed by the last request that still refers to the connection, so its descriptor is not reused before
+                epoll_ctl(epoll, EPOLL_CTL_DEL, descriptor, nullptr);
+                {
+                    unique_lock lock(connection->outputMutex);
+                    connection->closed = true;
+                }
+                connections.erase(it);
+            }
+        }
+    }
+
+    for (auto& [descriptor, connection] : connections) {
+        epoll_ctl(epoll, EPOLL_CTL_DEL, descriptor, nullptr);
+        unique_lock lock(connection->outputMutex);
+        connection->closed = true;
+    }
+    uint64_t value = 0;
+    while (read(stopEvent, &value, sizeof(value)) > 0) {
+    }
+    return true;
+}
+//---------------------------------------------------------------------------
+// Stop the event loop
+void Server::stop() {
+    uint64_t value = 1;
+    if (stopEvent >= 0) {
+        [[maybe_unused]] ssize_t written = write(stopEvent, &value, sizeof(value));
+    }
+}
+//---------------------------------------------------------------------------
+// Accept the pending connections
+void Server::acceptConnections(unordered_map<int, shared_ptr<Connection>>& connections) {
+    while (true) {
+        int descriptor = accept4(listenSocket, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (descriptor < 0) {
+            return;
+        }
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = descriptor;
+        if (epoll_ctl(epoll, EPOLL_CTL_ADD, descriptor, &event) != 0) {
+            close(descriptor);
+            continue;
+        }
+        connections[descriptor] = make_shared<Connection>(descriptor);
+        connectionCount.fetch_add(1, memory_order_relaxed);
+    }
+}
+//---------------------------------------------------------------------------
+// Read the available bytes of a connection until it has too many pending requests
+bool Server::readConnection(const shared_ptr<Connection>& connection) {
+    char buffer[64 << 10];
+    while (true) {
+        {
+            // The workers read the connection again once they have answered enough requests
+            unique_lock lock(connection->outputMutex);
+            if (!isReadingLocked(*connection)) {
+                updateEventsLocked(*connection);
+                return true;
+            }
+        }
+        ssize_t received = read(connection->socket, buffer, sizeof(buffer));
+        if (received == 0) {
+            // The pending requests are still answered, the connection is shut down after the last response
+            unique_lock lock(connection->outputMutex);
+            connection->inputClosed = true;
+            flushLocked(*connection);
+            return true;
+        }
+        if (received < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+        connection->input.append(buffer, static_cast<size_t>(received));
+        if (!dispatchRequests(connection)) {
+            return false;
+        }
+    }
+}
+//---------------------------------------------------------------------------
+// Hand the complete frames of the input of a connection to the workers
+bool Server::dispatchRequests(const shared_ptr<Connection>& connection) {
+    string& input = connection->input;
+    vector<Request> complete;
+    size_t position = 0;
+    bool valid = true;
+    while (input.size() - position >= headerSize) {
+        uint32_t length = load<uint32_t>(input.data() + position);
+        if (length > options.maxFrameSize) {
+            valid = false;
+            break;
+        }
+        if (input.size() - position < headerSize + length) {
+            break;
+        }
+        Request& request = complete.emplace_back();
+        request.id = load<uint32_t>(input.data() + position + sizeof(uint32_t));
+        request.type = load<uint8_t>(input.data() + position + 2 * sizeof(uint32_t));
+        request.payload.assign(input, position + headerSize, length);
+        position += headerSize + length;
+    }
+    input.erase(0, position);
+    if (complete.empty()) {
+        return valid;
+    }
+
+    // The requests are counted before a worker can answer them
+    {
+        unique_lock lock(connection->outputMutex);
+        connection->pendingRequests += complete.size();
+        for (const auto& request : complete) {
+            connection->pendingBytes += request.payload.size();
+        }
+    }
+    // Every complete frame is a task of its own, so the requests of one connection are handled in parallel
+    for (auto& request : complete) {
+        pool.execute([this, connection, request = move(request)] { handleRequest(connection, request); });
+    }
+    return valid;
+}
+//---------------------------------------------------------------------------
+// Handle a request on a worker
+void Server::handleRequest(const shared_ptr<Connection>& connection, const Request& request) {
+    requests.fetch_add(1, memory_order_relaxed);
+    string_view payload = request.payload;
+    string response;
+
+    switch (static_cast<RequestType>(request.type)) {
+        case RequestType::Register: {
+            optional<pair<uint64_t, size_t>> function = registerFunction(payload);
+            if (!function) {
+                sendResponse(*connection, request, ResponseStatus::CompileError, {});
+                return;
+            }
+            append<uint64_t>(response, function->first);
+            append<uint32_t>(response, static_cast<uint32_t>(function->second));
+            sendResponse(*connection, request, ResponseStatus::Ok, response);
+            return;
+        }
+        case RequestType::Evaluate: {
+            if (payload.size() < sizeof(uint64_t) || (payload.size() - sizeof(uint64_t)) % sizeof(int64_t) != 0) {
+                break;
+            }
+            shared_ptr<PljitHandle> handle = findFunction(load<uint64_t>(payload.data()));
+            if (!handle) {
+                sendResponse(*connection, request, ResponseStatus::UnknownFunction, {});
+                return;
+            }
+            vector<int64_t> parameters((payload.size() - sizeof(uint64_t)) / sizeof(int64_t));
+            memcpy(parameters.data(), payload.data() + sizeof(uint64_t), parameters.size() * sizeof(int64_t));
+            CallOutcome outcome = CallOutcome::Success;
+            optional<int64_t> result = (*handle)(span<const int64_t>(parameters), outcome);
+            if (!result) {
+                sendResponse(*connection, request, outcome == CallOutcome::FuelExhausted ? ResponseStatus::FuelExhausted : ResponseStatus::EvaluationError, {});
+                return;
+            }
+            append<int64_t>(response, *result);
+            sendResponse(*connection, request, ResponseStatus::Ok, response);
+            return;
+        }
+        case RequestType::EvaluateBatch: {
+            size_t prefix = sizeof(uint64_t) + sizeof(uint32_t);
+            if (payload.size() < prefix || (payload.size() - prefix) % sizeof(int64_t) != 0) {
+                break;
+            }
+            shared_ptr<PljitHandle> handle = findFunction(load<uint64_t>(payload.data()));
+            if (!handle) {
+                sendResponse(*connection, request, ResponseStatus::UnknownFunction, {});
+                return;
+            }
+            size_t width = load<uint32_t>(payload.data() + sizeof(uint64_t));
+            vector<int64_t> parameters((payload.size() - prefix) / sizeof(int64_t));
+            if (width == 0 || parameters.size() % width != 0) {
+                break;
+            }
+            memcpy(parameters.data(), payload.data() + prefix, parameters.size() * sizeof(int64_t));
+
+            // The rows are evaluated in one batch, a wrong width fails all of them
+            vector<optional<int64_t>> results(parameters.size() / width);
+            if (!handle->evaluateRows(parameters, results)) {
+                sendResponse(*connection, request, ResponseStatus::EvaluationError, {});
+                return;
+            }
+            response.reserve(results.size() * batchResultSize);
+            for (const auto& result : results) {
+                append<uint8_t>(response, result.has_value());
+                append<int64_t>(response, result.value_or(0));
+            }
+            sendResponse(*connection, request, ResponseStatus::Ok, response);
+            return;
+        }
+    }
+    sendResponse(*connection, request, ResponseStatus::Malformed, {});
+}
+//---------------------------------------------------------------------------
+// Append a response to the output of a connection
+void Server::sendResponse(Connection& connection, const Request& request, ResponseStatus status, string_view payload) {
+    unique_lock lock(connection.outputMutex);
+    connection.pendingRequests--;
+    connection.pendingBytes -= request.payload.size();
+    if (connection.closed) {
+        return;
+    }
+    append<uint32_t>(connection.output, static_cast<uint32_t>(sizeof(uint8_t) + payload.size()));
+    append<uint32_t>(connection.output, request.id);
+    append<uint8_t>(connection.output, request.type);
+    append<uint8_t>(connection.output, static_cast<uint8_t>(status));
+    connection.output.append(payload);
+    flushLocked(connection);
+}
+//---------------------------------------------------------------------------
+// Write the buffered output of a connection
+void Server::flushLocked(Connection& connection) {
+    size_t written = 0;
+    while (written < connection.output.size()) {
+        ssize_t sent = ::send(connection.socket, connection.output.data() + written, connection.output.size() - written, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                // The event loop notices the broken connection by its hang up
+                connection.output.clear();
+                written = 0;
+            }
+            break;
+        }
+        written += static_cast<size_t>(sent);
+    }
+    connection.output.erase(0, written);
+    updateEventsLocked(connection);
+
+    // A client that finished sending sees the end of the connection after its last response, the event loop then removes it by its hang up
+    if (connection.inputClosed && !connection.pendingRequests && connection.output.empty() && !connection.closed) {
+        shutdown(connection.socket, SHUT_WR);
+    }
+}
+//---------------------------------------------------------------------------
+// Return whether a connection is read
+bool Server::isReadingLocked(const Connection& connection) const {
+    return !connection.inputClosed && connection.pendingRequests < options.maxPendingRequests && connection.pendingBytes + connection.output.size() < options.maxPendingBytes;
+}
+//---------------------------------------------------------------------------
+// Register the events of a connection that the event loop waits for
+void Server::updateEventsLocked(Connection& connection) {
+    // The event loop writes the rest of the output when the socket becomes writable
+    uint32_t events = 0;
+    if (isReadingLocked(connection)) {
+        events |= EPOLLIN;
+    }
+    if (!connection.output.empty()) {
+        events |= EPOLLOUT;
+    }
+    if (events != connection.events && !connection.closed) {
+        epoll_event event{};
+        event.events = events;
+        event.data.fd = connection.socket;
+        epoll_ctl(epoll, EPOLL_CTL_MOD, connection.socket, &event);
+        connection.events = events;
+    }
+}
+//---------------------------------------------------------------------------
+// Register a function directly
+optional<pair<uint64_t, size_t>> Server::registerFunction(string_view code) {
+    registrations.fetch_add(1, memory_order_relaxed);
+    shared_ptr<RegisteredFunction> function;
+    {
+        unique_lock lock(functionsMutex);
+        auto it = functionsByCode.find(code);
+        if (it != functionsByCode.end()) {
+            sharedRegistrations.fetch_add(1, memory_order_relaxed);
+            functions.splice(functions.begin(), functions, it->second);
+            function = *it->second;
+            if (function->failed) {
+                return nullopt;
+            }
+        } else {
+            // The handle refers to the code of the function, which keeps its address
+            function = make_shared<RegisteredFunction>();
+            function->code = code;
+            function->handle.reset(new PljitHandle(jit.registerFunction(function->code, options.level, options.arithmetic)));
+            function->handle->setFuelLimit(options.fuel);
+            functions.push_front(function);
+            functionsByCode.emplace(function->code, functions.begin());
+            evictFunctionsLocked();
+        }
+    }
+
+    // The compilation runs without the lock of the functions, concurrent registrations of the same code wait on the handle
+    // A registered function is never updated, so it is finalized into its image
+    PljitHandle& handle = *function->handle;
+    optional<size_t> parameterCount = handle.getParameterCount();
+    if (!parameterCount || !handle.finalize()) {
+        unique_lock lock(functionsMutex);
+        function->failed = true;
+        return nullopt;
+    }
+
+    // The id is only published once the function is finalized, so no request can evaluate it during the finalization
+    // A function that was removed during its compilation is not published, its id is unknown like the one of a function removed later
+    {
+        unique_lock lock(functionsMutex);
+        auto it = functionsByCode.find(function->code);
+        if (it != functionsByCode.end() && *it->second == function) {
+            functionsById.emplace(handle.getId(), it->second);
+        }
+    }
+    return pair(handle.getId(), *parameterCount);
+}
+//---------------------------------------------------------------------------
+// Return the handle of a function id
+shared_ptr<PljitHandle> Server::findFunction(uint64_t functionId) {
+    unique_lock lock(functionsMutex);
+    auto it = functionsById.find(functionId);
+    if (it == functionsById.end()) {
+        return nullptr;
+    }
+    functions.splice(functions.begin(), functions, it->second);
+    const shared_ptr<RegisteredFunction>& function = *it->second;
+    return shared_ptr<PljitHandle>(function, function->handle.get());
+}
+//---------------------------------------------------------------------------
+// Remove the least recently used functions
+void Server::evictFunctionsLocked() {
+    // The requests that still evaluate a removed function keep it alive
+    while (functions.size() > max<size_t>(options.maxFunctions, 1)) {
+        const RegisteredFunction& function = *functions.back();
+        functionsByCode.erase(function.code);
+        functionsById.erase(function.handle->getId());
+        functions.pop_back();
+    }
+}
+//---------------------------------------------------------------------------
+// Return the statistics of the server
+ServerStatistics Server::getStatistics() const {
+    ServerStatistics statistics;
+    statistics.connections = connectionCount.load(memory_order_relaxed);
+    statistics.requests = requests.load(memory_order_relaxed);
+    statistics.registrations = registrations.load(memory_order_relaxed);
+    statistics.sharedRegistrations = sharedRegistrations.load(memory_order_relaxed);
+    unique_lock lock(functionsMutex);
+    statistics.functions = functions.size();
+    return statistics;
+}
+//---------------------------------------------------------------------------
+// Destructor
+ServerClient::~ServerClient() {
+    if (socket >= 0) {
+        close(socket);
+    }
+}
+//---------------------------------------------------------------------------
+// Connect to the server at the path
+bool ServerClient::connect(const string& path) {
+    sockaddr_un address;
+    if (socket >= 0 || !makeAddress(path, address)) {
+        return false;
+    }
+    int newSocket = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (newSocket < 0) {
+        return false;
+    }
+    if (::connect(newSocket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        close(newSocket);
+        return false;
+    }
+    socket = newSocket;
+    return true;
+}
+//---------------------------------------------------------------------------
+// Send a register request
+bool ServerClient::sendRegister(uint32_t requestId, string_view code) {
+    return send(requestId, RequestType::Register, code);
+}
+//---------------------------------------------------------------------------
+// Send an evaluate request
+bool ServerClient::sendEvaluate(uint32_t requestId, uint64_t functionId, span<const int64_t> parameters) {
+    string payload;
+    append<uint64_t>(payload, functionId);
+    payload.append(reinterpret_cast<const char*>(parameters.data()), parameters.size_bytes());
+    return send(requestId, RequestType::Evaluate, payload);
+}
+//---------------------------------------------------------------------------
+// Send a batch request
+bool ServerClient::sendEvaluateBatch(uint32_t requestId, uint64_t functionId, size_t width, span<const int64_t> parameters) {
+    string payload;
+    append<uint64_t>(payload, functionId);
+    append<uint32_t>(payload, static_cast<uint32_t>(width));
+    payload.append(reinterpret_cast<const char*>(parameters.data()), parameters.size_bytes());
+    return send(requestId, RequestType::EvaluateBatch, payload);
+}
+//---------------------------------------------------------------------------
+// Send a frame
+bool ServerClient::send(uint32_t requestId, RequestType type, string_view payload) {
+    string frame;
+    frame.reserve(headerSize + payload.size());
+    appendFrame(frame, requestId, static_cast<uint8_t>(type), payload);
+    string_view remaining = frame;
+    while (!remaining.empty()) {
+        ssize_t sent = ::send(socket, remaining.data(), remaining.size(), MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        remaining.remove_prefix(static_cast<size_t>(sent));
+    }
+    return true;
+}
+//---------------------------------------------------------------------------
+// Shut down the sending side
+bool ServerClient::finishSending() {
+    return shutdown(socket, SHUT_WR) == 0;
+}
+//---------------------------------------------------------------------------
+// Wait for the next response
+optional<ServerClient::Response> ServerClient::receive() {
+    auto readAll = [this](char* data, size_t size) {
+        while (size > 0) {
+            ssize_t received = read(socket, data, size);
+            if (received < 0 && errno == EINTR) {
+                continue;
+            }
+            if (received <= 0) {
+                return false;
+            }
+            data += received;
+            size -= static_cast<size_t>(received);
+        }
+        return true;
+    };
+
+    char header[headerSize];
+    if (!readAll(header, headerSize)) {
+        return nullopt;
+    }
+    string payload(load<uint32_t>(header), '\0');
+    if (payload.empty() || !readAll(payload.data(), payload.size())) {
+        return nullopt;
+    }
+
+    Response response;
+    response.requestId = load<uint32_t>(header + sizeof(uint32_t));
+    response.type = static_cast<RequestType>(load<uint8_t>(header + 2 * sizeof(uint32_t)));
+    response.status = static_cast<ResponseStatus>(payload[0]);
+    string_view body = string_view(payload).substr(1);
+    if (response.status != ResponseStatus::Ok) {
+        return response;
+    }
+    switch (response.type) {
+        case RequestType::Register:
+            if (body.size() == sizeof(uint64_t) + sizeof(uint32_t)) {
+                response.functionId = load<uint64_t>(body.data());
+                response.parameterCount = load<uint32_t>(body.data() + sizeof(uint64_t));
+            }
+            break;
+        case RequestType::Evaluate:
+            if (body.size() == sizeof(int64_t)) {
+                response.results.emplace_back(load<int64_t>(body.data()));
+            }
+            break;
+        case RequestType::EvaluateBatch:
+            for (size_t position = 0; position + batchResultSize <= body.size(); position += batchResultSize) {
+                int64_t value = load<int64_t>(body.data() + position + sizeof(uint8_t));
+                response.results.push_back(body[position] ? optional<int64_t>(value) : nullopt);
+            }
+            break;
+    }
+    return response;
+}
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
@@ -0,0 +1,204 @@
+#ifndef H_PLJIT_SERVER
+#define H_PLJIT_SERVER
+#include "pljit/Pljit.hpp"
+#include <list>
+#include <map>
+#include <unordered_map>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+/// The protocol of the server consists of frames, all integers are native and unaligned.
+/// A frame starts with a header of 9 bytes: the uint32 length of the payload, the uint32 id of the request and the uint8 type of the request.
+/// Requests:
+///   Register:      the code of the function
+///   Evaluate:      uint64 function id, int64 parameters
+///   EvaluateBatch: uint64 function id, uint32 number of parameters per row, int64 parameters of all rows
+/// A response has the id and type of its request, its payload starts with a uint8 status:
+///   Register:      uint64 function id, uint32 number of parameters
+///   Evaluate:      int64 result
+///   EvaluateBatch: per row a uint8 that is 1 for a result and 0 for an error, and the int64 result
+/// A client may send many requests without waiting, the responses may arrive in a different order than the requests.
+/// A client that shuts down its sending side still receives the responses of its requests, then the server shuts down its side.
+enum class RequestType : uint8_t {
+    Register = 1,
+    Evaluate = 2,
+    EvaluateBatch = 3
+};
+/// Enum that represents the status of a response
+enum class ResponseStatus : uint8_t {
+    Ok = 0,
+    /// The evaluation failed, e.g. with a division by zero, an overflow in the trapping mode or a wrong number of parameters
+    EvaluationError = 1,
+    /// The function id is not registered
+    UnknownFunction = 2,
+    /// The registered code does not compile
+    CompileError = 3,
+    /// The request cannot be decoded
+    Malformed = 4,
+    /// The evaluation ran out of fuel
+    FuelExhausted = 5
+};
+/// Struct that represents the options of a server
+struct ServerOptions {
+    /// Number of worker threads
+    size_t workers = ThreadPool::defaultWorkerCount();
+    /// Optimization level of the registered functions
+    OptimizationLevel level = OptimizationLevel::O1;
+    /// Arithmetic mode of the registered functions
+    ArithmeticMode arithmetic = ArithmeticMode::Wrapping;
+    /// Maximum payload size of a request, a connection that sends a larger one is closed
+    size_t maxFrameSize = 64 << 20;
+    /// Fuel of every evaluation, it bounds the time one request occupies a worker, 0 for no limit
+    uint64_t fuel = 0;
+    /// Maximum number of requests of a connection that are not answered yet, the connection is not read while it has more
+    size_t maxPendingRequests = 1024;
+    /// Maximum number of bytes of the unanswered requests and unwritten responses of a connection, the connection is not read while it has more
+    size_t maxPendingBytes = 64 << 20;
+    /// Maximum number of kept functions, the least recently registered or evaluated one is removed for a new code and its id becomes unknown
+    size_t maxFunctions = 4096;
+};
+/// Struct that represents the statistics of a server
+struct ServerStatistics {
+    /// Number of accepted connections
+    size_t connections = 0;
+    /// Number of handled requests
+    size_t requests = 0;
+    /// Number of registrations and how many of them found the function already compiled
+    size_t registrations = 0;
+    size_t sharedRegistrations = 0;
+    /// Number of kept functions, the codes that do not compile included
+    size_t functions = 0;
+};
+/// Class that serves register and evaluate requests over a Unix domain socket
+/// One thread runs an epoll loop that reads the frames of all connections, the requests are handled on the workers.
+/// The functions are finalized and kept in a bounded LRU cache, a code that is registered again gets the same function while it is kept.
+/// A code that does not compile is kept as well, so registering it again fails without compiling it and reporting its errors again.
+class Server {
+    public:
+    /// Constructor
+    explicit Server(ServerOptions options = ServerOptions());
+    /// Destructor, closes the socket and removes its path
+    ~Server();
+    /// Servers are not copyable
+    Server(const Server&) = delete;
+    Server& operator=(const Server&) = delete;
+    /// Bind the socket to the path, an existing file at the path is replaced, returns false on error
+    bool listen(const string& path);
+    /// Serve the connections until stop is called, returns false if the server does not listen
+    bool run();
+    /// Stop the event loop, it may be called from any thread or a signal handler
+    void stop();
+    /// Register a function directly, returns its id and the number of its parameters, or nullopt if it does not compile
+    optional<pair<uint64_t, size_t>> registerFunction(string_view code);
+    /// Return the statistics of the server
+    ServerStatistics getStatistics() const;
+
+    private:
+    /// Struct that represents a client connection
+    struct Connection;
+    /// Struct that represents a registered function
+    struct RegisteredFunction {
+        /// Storage of the code, the handle refers to it
+        string code;
+        /// Storage of the handle
+        unique_ptr<PljitHandle> handle;
+        /// Storage of whether the code does not compile, it is protected by the mutex of the functions
+        bool failed = false;
+    };
+    /// Type of the position of a function in the LRU order
+    using FunctionPosition = list<shared_ptr<RegisteredFunction>>::iterator;
+    /// Struct that represents a received request
+    struct Request {
+        uint32_t id = 0;
+        uint8_t type = 0;
+        string payload;
+    };
+    /// Accept the pending connections
+    void acceptConnections(unordered_map<int, shared_ptr<Connection>>& connections);
+    /// Read the available bytes of a connection until it has too many pending requests, returns false if it has to be closed
+    bool readConnection(const shared_ptr<Connection>& connection);
+    /// Hand the complete frames of the input of a connection to the workers, returns false if a frame is too large
+    bool dispatchRequests(const shared_ptr<Connection>& connection);
+    /// Handle a request on a worker
+    void handleRequest(const shared_ptr<Connection>& connection, const Request& request);
+    /// Append a response to the output of a connection and write as much as possible
+    void sendResponse(Connection& connection, const Request& request, ResponseStatus status, string_view payload);
+    /// Write the buffered output of a connection, the mutex of the connection has to be held
+    void flushLocked(Connection& connection);
+    /// Return whether a connection is read, the mutex of the connection has to be held
+    bool isReadingLocked(const Connection& connection) const;
+    /// Register the events of a connection that the event loop waits for, the mutex of the connection has to be held
+    void updateEventsLocked(Connection& connection);
+    /// Return the handle of a function id and mark the function as recently used, nullptr if it is unknown
+    /// The handle stays valid while it is used, even if the function is removed meanwhile.
+    shared_ptr<PljitHandle> findFunction(uint64_t functionId);
+    /// Remove the least recently used functions until at most maxFunctions are kept, the mutex of the functions has to be held
+    void evictFunctionsLocked();
+    /// Storage of the options
+    ServerOptions options;
+    /// Storage of the compiler
+    Pljit jit;
+    /// Storage of the kept functions, the most recently used one comes first
+    list<shared_ptr<RegisteredFunction>> functions;
+    /// Storage of the position of a function given its code, the keys refer to the codes of the functions
+    map<string_view, FunctionPosition, less<>> functionsByCode;
+    /// Storage of the position of a function given its id, a function is only added once it is finalized
+    unordered_map<uint64_t, FunctionPosition> functionsById;
+    /// Storage of the mutex that protects the registered functions
+    mutable mutex functionsMutex;
+    /// Storage of the path, socket, epoll instance and the event that stops the loop
+    string path;
+    int listenSocket = -1;
+    int epoll = -1;
+    int stopEvent = -1;
+    /// Storage of the counters
+    atomic<size_t> connectionCount = 0;
+    atomic<size_t> requests = 0;
+    atomic<size_t> registrations = 0;
+    atomic<size_t> sharedRegistrations = 0;
+    /// Storage of the workers, they are destroyed first, so their remaining requests still find the functions
+    ThreadPool pool;
+};
+/// Class that represents a blocking client of a server, the requests can be pipelined
+class ServerClient {
+    public:
+    /// Struct that represents a decoded response
+    struct Response {
+        uint32_t requestId = 0;
+        RequestType type = RequestType::Register;
+        ResponseStatus status = ResponseStatus::Ok;
+        /// Id and number of parameters of a registered function
+        uint64_t functionId = 0;
+        size_t parameterCount = 0;
+        /// Results of an evaluation, one per row of a batch
+        vector<optional<int64_t>> results;
+    };
+    /// Constructor
+    ServerClient() = default;
+    /// Destructor, closes the connection
+    ~ServerClient();
+    /// Clients are not copyable
+    ServerClient(const ServerClient&) = delete;
+    ServerClient& operator=(const ServerClient&) = delete;
+    /// Connect to the server at the path, returns false on error
+    bool connect(const string& path);
+    /// Send a request without waiting for its response, returns false on error
+    bool sendRegister(uint32_t requestId, string_view code);
+    bool sendEvaluate(uint32_t requestId, uint64_t functionId, span<const int64_t> parameters);
+    bool sendEvaluateBatch(uint32_t requestId, uint64_t functionId, size_t width, span<const int64_t> parameters);
+    /// Shut down the sending side, the responses of the sent requests can still be received, returns false on error
+    bool finishSending();
+    /// Wait for the next response, returns nullopt if the connection is closed
+    optional<Response> receive();
+
+    private:
+    /// Send a frame
+    bool send(uint32_t requestId, RequestType type, string_view payload);
+    /// Storage of the socket
+    int socket = -1;
+};
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
+#endif // H_PLJIT_SERVER
+//---------------------------------------------------------------------------
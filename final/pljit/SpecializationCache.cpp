@@ -0,0 +1,59 @@
+#include "pljit/SpecializationCache.hpp"
+#include <algorithm>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+// Return the specialized function of a binding
+ASTNode* SpecializationCache::find(const ParameterBinding& binding) {
+    auto lookupIterator = lookup.find(binding);
+    if (lookupIterator == lookup.end()) {
+        return nullptr;
+    }
+    entries.splice(entries.begin(), entries, lookupIterator->second);
+    return lookupIterator->second->second.get();
+}
+//---------------------------------------------------------------------------
+// Insert a specialized function
+ASTNode& SpecializationCache::insert(const ParameterBinding& binding, unique_ptr<ASTNode> function) {
+    auto lookupIterator = lookup.find(binding);
+    if (lookupIterator != lookup.end()) {
+        entries.splice(entries.begin(), entries, lookupIterator->second);
+        lookupIterator->second->second = move(function);
+        return *lookupIterator->second->second;
+    }
+    entries.emplace_front(binding, move(function));
+    lookup.insert({binding, entries.begin()});
+    evict();
+    return *entries.front().second;
+}
+//---------------------------------------------------------------------------
+// Set the maximum number of cached specializations
+void SpecializationCache::setCapacity(size_t newCapacity) {
+    capacity = newCapacity > 0 ? newCapacity : 1;
+    evict();
+}
+//---------------------------------------------------------------------------
+// Remove all specialized functions
+void SpecializationCache::clear() {
+    lookup.clear();
+    entries.clear();
+}
+//---------------------------------------------------------------------------
+// Evict the least recently used entries
+void SpecializationCache::evict() {
+    while (entries.size() > capacity) {
+        lookup.erase(entries.back().first);
+        entries.pop_back();
+    }
+}
+//---------------------------------------------------------------------------
+// Sort a binding by the parameter position and remove duplicate positions
+ParameterBinding SpecializationCache::normalize(ParameterBinding binding) {
+    stable_sort(binding.begin(), binding.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+    auto last = unique(binding.begin(), binding.end(), [](const auto& a, const auto& b) { return a.first == b.first; });
+    binding.erase(last, binding.end());
+    return binding;
+}
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
@@ -0,0 +1,46 @@
+#ifndef H_PLJIT_SPECIALIZATIONCACHE
+#define H_PLJIT_SPECIALIZATIONCACHE
+#include "pljit/ast/AST.hpp"
+#include <list>
+#include <map>
+using namespace pljit::ast;
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+/// Binding of parameter positions to fixed values
+using ParameterBinding = vector<pair<size_t, int64_t>>;
+/// Class that stores the specialized versions of a function in a bounded LRU cache
+class SpecializationCache {
+    public:
+    /// Constructor
+    explicit SpecializationCache(size_t capacity = 16) : capacity(capacity > 0 ? capacity : 1) {}
+    /// Return the specialized function of a binding or nullptr if it is not cached
+    ASTNode* find(const ParameterBinding& binding);
+    /// Insert a specialized function, evicts the least recently used one if the cache is full
+    ASTNode& insert(const ParameterBinding& binding, unique_ptr<ASTNode> function);
+    /// Set the maximum number of cached specializations
+    void setCapacity(size_t newCapacity);
+    /// Remove all specialized functions
+    void clear();
+    /// Getters
+    size_t size() const { return entries.size(); }
+    size_t getCapacity() const { return capacity; }
+    /// Sort a binding by the parameter position and remove duplicate positions
+    static ParameterBinding normalize(ParameterBinding binding);
+
+    private:
+    /// Type of an entry in the cache
+    using Entry = pair<ParameterBinding, unique_ptr<ASTNode>>;
+    /// Evict the least recently used entries until the capacity is respected
+    void evict();
+    /// Storage of the entries, the most recently used one comes first
+    list<Entry> entries;
+    /// Storage of the position of an entry given its binding
+    map<ParameterBinding, list<Entry>::iterator> lookup;
+    /// Storage of the capacity
+    size_t capacity;
+};
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
+#endif // H_PLJIT_SPECIALIZATIONCACHE
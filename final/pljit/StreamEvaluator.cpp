@@ -0,0 +1,213 @@
+#include "pljit/StreamEvaluator.hpp"
+#include <charconv>
+#include <cstring>
+#include <deque>
+#include <fcntl.h>
+#include <unistd.h>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+// Write all bytes to the file, returns false on error
+bool writeAll(int file, string_view bytes) {
+    while (!bytes.empty()) {
+        ssize_t written = ::write(file, bytes.data(), bytes.size());
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        bytes.remove_prefix(static_cast<size_t>(written));
+    }
+    return true;
+}
+//---------------------------------------------------------------------------
+// Return whether the character separates two values of a text row
+bool isSeparator(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == ',';
+}
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+// Return the number of rows per second
+double StreamResult::getThroughput() const {
+    double seconds = chrono::duration<double>(duration).count();
+    return seconds > 0 ? static_cast<double>(rows) / seconds : 0;
+}
+//---------------------------------------------------------------------------
+// Evaluate the rows of the input file
+optional<StreamResult> StreamEvaluator::run(const string& inputPath, const string& outputPath, const StreamOptions& options) const {
+    auto begin = chrono::steady_clock::now();
+    MappedFile input(inputPath);
+    optional<size_t> arity = handle.getParameterCount();
+    if (!input.isOpen() || !arity) {
+        return nullopt;
+    }
+
+    // Binary morsels consist of whole rows, so their values can be evaluated in place
+    string_view contents = input.getContents();
+    size_t morselSize = max<size_t>(options.morselSize, 1);
+    if (options.inputFormat == StreamFormat::Binary) {
+        size_t rowSize = *arity * sizeof(int64_t);
+        if (rowSize == 0 || contents.size() % rowSize != 0) {
+            return nullopt;
+        }
+        morselSize = max<size_t>(morselSize / rowSize, 1) * rowSize;
+    }
+
+    int output = ::open(outputPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (output < 0) {
+        return nullopt;
+    }
+
+    StreamResult result;
+    size_t window = options.window ? options.window : 2 * pool.getWorkerCount();
+    deque<future<Morsel>> pending;
+    size_t offset = 0;
+    bool failed = false;
+    while (true) {
+        // Keep the window filled, the morsels that are submitted next are read ahead
+        while (offset < contents.size() && pending.size() < window) {
+            size_t end = min(offset + morselSize, contents.size());
+            if (options.inputFormat == StreamFormat::Text && end < contents.size() && contents[end - 1] != '\n') {
+                size_t newline = contents.find('\n', end);
+                end = newline == string_view::npos ? contents.size() : newline + 1;
+            }
+            size_t length = end - offset;
+            input.prefetch(offset, length);
+            pending.push_back(pool.submit([this, contents, offset, length, arity = *arity, &options] {
+                if (options.inputFormat == StreamFormat::Binary) {
+                    return evaluateBinary(contents, offset, length, arity, options.outputFormat);
+                }
+                return evaluateText(contents, offset, length, arity, options.outputFormat);
+            }));
+            offset = end;
+        }
+        if (pending.empty()) {
+            break;
+        }
+
+        // The morsels are written in order, the pending ones still refer to the mapped file, so they are awaited after an error as well
+        Morsel morsel = pending.front().get();
+        pending.pop_front();
+        if (failed) {
+            continue;
+        }
+        if (!writeAll(output, morsel.output)) {
+            failed = true;
+            offset = contents.size();
+            continue;
+        }
+        input.release(morsel.offset, morsel.length);
+        result.rows += morsel.rows;
+        result.errors += morsel.errors;
+        result.malformed += morsel.malformed;
+        result.bytesRead += morsel.length;
+        result.bytesWritten += morsel.output.size();
+    }
+
+    if (close(output) != 0 || failed) {
+        return nullopt;
+    }
+    result.duration = chrono::steady_clock::now() - begin;
+    return result;
+}
+//---------------------------------------------------------------------------
+// Evaluate a morsel of a binary file
+StreamEvaluator::Morsel StreamEvaluator::evaluateBinary(string_view input, size_t offset, size_t length, size_t arity, StreamFormat outputFormat) const {
+    Morsel morsel;
+    morsel.offset = offset;
+    morsel.length = length;
+    morsel.rows = length / (arity * sizeof(int64_t));
+
+    // The mapping is page aligned and the morsels start at whole rows, so the values are aligned
+    span<const int64_t> values(reinterpret_cast<const int64_t*>(input.data() + offset), morsel.rows * arity);
+    vector<optional<int64_t>> results(morsel.rows);
+    handle.evaluateRows(values, results);
+    formatResults(results, outputFormat, morsel);
+    return morsel;
+}
+//---------------------------------------------------------------------------
+// Evaluate a morsel of a text file
+StreamEvaluator::Morsel StreamEvaluator::evaluateText(string_view input, size_t offset, size_t length, size_t arity, StreamFormat outputFormat) const {
+    Morsel morsel;
+    morsel.offset = offset;
+    morsel.length = length;
+
+    // The values of all rows are parsed into one buffer, a malformed row is padded to the arity and its result is discarded
+    vector<int64_t> values;
+    vector<size_t> malformedRows;
+    const char* current = input.data() + offset;
+    const char* end = current + length;
+    while (current != end) {
+        const char* lineEnd = static_cast<const char*>(memchr(current, '\n', static_cast<size_t>(end - current)));
+        if (!lineEnd) {
+            lineEnd = end;
+        }
+
+        size_t rowBegin = values.size();
+        bool blank = true;
+        bool valid = true;
+        while (current != lineEnd) {
+            if (isSeparator(*current)) {
+                current++;
+                continue;
+            }
+            blank = false;
+            int64_t value = 0;
+            auto [next, error] = from_chars(current, lineEnd, value);
+            if (error != errc()) {
+                valid = false;
+                break;
+            }
+            values.push_back(value);
+            current = next;
+        }
+        current = lineEnd == end ? end : lineEnd + 1;
+        if (blank) {
+            continue;
+        }
+
+        if (!valid || values.size() - rowBegin != arity) {
+            values.resize(rowBegin + arity);
+            malformedRows.push_back(morsel.rows);
+        }
+        morsel.rows++;
+    }
+
+    vector<optional<int64_t>> results(morsel.rows);
+    handle.evaluateRows(values, results);
+    for (size_t row : malformedRows) {
+        results[row] = nullopt;
+    }
+    morsel.malformed = malformedRows.size();
+    formatResults(results, outputFormat, morsel);
+    return morsel;
+}
+//---------------------------------------------------------------------------
+// Format the results of a morsel
+void StreamEvaluator::formatResults(span<const optional<int64_t>> results, StreamFormat outputFormat, Morsel& morsel) {
+    morsel.output.reserve(results.size() * (outputFormat == StreamFormat::Binary ? 1 + sizeof(int64_t) : 8));
+    for (const auto& result : results) {
+        morsel.errors += !result.has_value();
+        if (outputFormat == StreamFormat::Binary) {
+            int64_t value = result.value_or(0);
+            char record[1 + sizeof(int64_t)];
+            record[0] = result.has_value();
+            memcpy(record + 1, &value, sizeof(value));
+            morsel.output.append(record, sizeof(record));
+        } else if (result) {
+            char digits[24];
+            auto [digitsEnd, error] = to_chars(digits, digits + sizeof(digits), *result);
+            morsel.output.append(digits, digitsEnd);
+            morsel.output.push_back('\n');
+        } else {
+            morsel.output.append("error\n");
+        }
+    }
+}
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
@@ -0,0 +1,84 @@
+#ifndef H_PLJIT_STREAMEVALUATOR
+#define H_PLJIT_STREAMEVALUATOR
+#include "pljit/MappedFile.hpp"
+#include "pljit/Pljit.hpp"
+#include <chrono>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+/// Enum that represents the format of a streamed file
+enum class StreamFormat {
+    /// One row per line, the values are decimal integers separated by spaces, tabs or commas, blank lines are skipped
+    /// A result is written as its decimal value or error.
+    Text,
+    /// One row after another, every value is a native 64-bit integer
+    /// A result is written as one status byte (1 for a value, 0 for an error) and the native 64-bit value.
+    Binary
+};
+/// Struct that represents the options of a stream evaluation
+struct StreamOptions {
+    /// Format of the input file
+    StreamFormat inputFormat = StreamFormat::Text;
+    /// Format of the output file
+    StreamFormat outputFormat = StreamFormat::Text;
+    /// Number of input bytes a task evaluates, a text morsel is extended to the end of its last line
+    size_t morselSize = 1 << 20;
+    /// Maximum number of morsels that are evaluated or waiting to be written, 0 for twice the number of workers
+    size_t window = 0;
+};
+/// Struct that represents the measurements of a stream evaluation
+struct StreamResult {
+    /// Number of evaluated rows
+    size_t rows = 0;
+    /// Number of rows whose evaluation failed or that could not be parsed
+    size_t errors = 0;
+    /// Number of rows that could not be parsed
+    size_t malformed = 0;
+    /// Number of read and written bytes
+    size_t bytesRead = 0;
+    size_t bytesWritten = 0;
+    /// Wall time of the evaluation
+    chrono::nanoseconds duration{0};
+    /// Return the number of rows per second
+    double getThroughput() const;
+};
+/// Class that evaluates one function on every row of a mapped parameter file, which may be larger than the memory
+/// The file is split into morsels that are evaluated on the pool. The results are written to the output file in the order of the rows,
+/// at most window morsels are in memory at once. No memory is allocated per row, binary rows are evaluated in place.
+class StreamEvaluator {
+    public:
+    /// Constructor
+    StreamEvaluator(PljitHandle& handle, ThreadPool& pool) : handle(handle), pool(pool) {}
+    /// Evaluate the rows of the input file, returns nullopt if a file cannot be opened or written,
+    /// the function does not compile, or a binary file does not consist of whole rows
+    optional<StreamResult> run(const string& inputPath, const string& outputPath, const StreamOptions& options = StreamOptions()) const;
+
+    private:
+    /// Struct that represents the evaluated rows of a morsel
+    struct Morsel {
+        /// Range of the morsel in the input file
+        size_t offset = 0;
+        size_t length = 0;
+        /// Formatted results
+        string output;
+        /// Counters of the rows
+        size_t rows = 0;
+        size_t errors = 0;
+        size_t malformed = 0;
+    };
+    /// Evaluate a morsel of a binary file
+    Morsel evaluateBinary(string_view input, size_t offset, size_t length, size_t arity, StreamFormat outputFormat) const;
+    /// Evaluate a morsel of a text file
+    Morsel evaluateText(string_view input, size_t offset, size_t length, size_t arity, StreamFormat outputFormat) const;
+    /// Format the results of a morsel
+    static void formatResults(span<const optional<int64_t>> results, StreamFormat outputFormat, Morsel& morsel);
+    /// Storage of the evaluated function
+    PljitHandle& handle;
+    /// Storage of the pool
+    ThreadPool& pool;
+};
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
+#endif // H_PLJIT_STREAMEVALUATOR
+//---------------------------------------------------------------------------
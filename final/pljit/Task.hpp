@@ -0,0 +1,115 @@
+#ifndef H_PLJIT_TASK
+#define H_PLJIT_TASK
+#include <condition_variable>
+#include <coroutine>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <utility>
+using namespace std;
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+/// Class that represents a lazily started coroutine that produces a value, awaiting it starts the coroutine
+template <typename T>
+class Task {
+    public:
+    /// Struct that represents the state of the coroutine
+    struct promise_type {
+        /// Awaitable that resumes the awaiting coroutine when the task finishes
+        struct FinalAwaiter {
+            bool await_ready() const noexcept { return false; }
+            coroutine_handle<> await_suspend(coroutine_handle<promise_type> handle) noexcept {
+                coroutine_handle<> continuation = handle.promise().continuation;
+                return continuation ? continuation : noop_coroutine();
+            }
+            void await_resume() const noexcept {}
+        };
+        Task get_return_object() { return Task(coroutine_handle<promise_type>::from_promise(*this)); }
+        suspend_always initial_suspend() const noexcept { return {}; }
+        FinalAwaiter final_suspend() const noexcept { return {}; }
+        void return_value(T result) { value = move(result); }
+        void unhandled_exception() const noexcept { terminate(); }
+        /// Storage of the produced value
+        optional<T> value;
+        /// Storage of the coroutine that awaits the task
+        coroutine_handle<> continuation;
+    };
+    /// Constructors
+    Task(const Task&) = delete;
+    Task(Task&& other) noexcept : handle(exchange(other.handle, {})) {}
+    /// Destructor
+    ~Task() {
+        if (handle) {
+            handle.destroy();
+        }
+    }
+    /// Assignment operators
+    Task& operator=(const Task&) = delete;
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            if (handle) {
+                handle.destroy();
+            }
+            handle = exchange(other.handle, {});
+        }
+        return *this;
+    }
+    /// Awaitable interface, the awaiting coroutine is resumed on the thread that finishes the task
+    bool await_ready() const noexcept { return false; }
+    coroutine_handle<> await_suspend(coroutine_handle<> continuation) noexcept {
+        handle.promise().continuation = continuation;
+        return handle;
+    }
+    T await_resume() { return move(*handle.promise().value); }
+
+    private:
+    /// Constructor
+    explicit Task(coroutine_handle<promise_type> handle) : handle(handle) {}
+    /// Storage of the coroutine
+    coroutine_handle<promise_type> handle;
+};
+//---------------------------------------------------------------------------
+namespace detail {
+//---------------------------------------------------------------------------
+/// Struct that represents an eagerly started coroutine that destroys itself when it finishes
+struct DetachedTask {
+    struct promise_type {
+        DetachedTask get_return_object() const noexcept { return {}; }
+        suspend_never initial_suspend() const noexcept { return {}; }
+        suspend_never final_suspend() const noexcept { return {}; }
+        void return_void() const noexcept {}
+        void unhandled_exception() const noexcept { terminate(); }
+    };
+};
+/// Struct that represents a one-shot completion signal
+struct Completion {
+    mutex completionMutex;
+    condition_variable completionCondition;
+    bool done = false;
+};
+/// Await the task and signal its completion
+template <typename T>
+DetachedTask awaitAndSignal(Task<T>& task, optional<T>& result, Completion& completion) {
+    result = co_await task;
+    unique_lock lock(completion.completionMutex);
+    completion.done = true;
+    completion.completionCondition.notify_one();
+}
+//---------------------------------------------------------------------------
+} // namespace detail
+//---------------------------------------------------------------------------
+/// Block the calling thread until the task has finished and return its value, for code that is not a coroutine
+template <typename T>
+T syncWait(Task<T> task) {
+    optional<T> result;
+    detail::Completion completion;
+    detail::awaitAndSignal(task, result, completion);
+    unique_lock lock(completion.completionMutex);
+    completion.completionCondition.wait(lock, [&] { return completion.done; });
+    return move(*result);
+}
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
+#endif // H_PLJIT_TASK
@@ -0,0 +1,135 @@
+#include "pljit/ThreadPool.hpp"
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+// The pool and the index of the worker that runs on the current thread
+thread_local const ThreadPool* currentPool = nullptr;
+thread_local size_t currentWorker = 0;
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+// Constructor
+ThreadPool::ThreadPool(size_t workerCount, size_t globalCapacity) : globalCapacity(max<size_t>(globalCapacity, 1)) {
+    workerCount = max<size_t>(workerCount, 1);
+    for (size_t i = 0; i < workerCount; i++) {
+        workers.push_back(make_unique<Worker>());
+    }
+    // The workers are started after all deques exist, since they steal from each other
+    for (size_t i = 0; i < workerCount; i++) {
+        workers[i]->worker = thread([this, i] { run(i); });
+    }
+}
+//---------------------------------------------------------------------------
+// Destructor
+ThreadPool::~ThreadPool() {
+    {
+        unique_lock lock(sleepMutex);
+        stopping = true;
+    }
+    sleepCondition.notify_all();
+    for (auto& worker : workers) {
+        worker->worker.join();
+    }
+}
+//---------------------------------------------------------------------------
+// Return the number of hardware threads
+size_t ThreadPool::defaultWorkerCount() {
+    return max<size_t>(thread::hardware_concurrency(), 1);
+}
+//---------------------------------------------------------------------------
+// Queue a task
+void ThreadPool::execute(function<void()> work) {
+    // The counter is raised before the task is visible, so it never drops below the number of queued tasks
+    queuedTasks.fetch_add(1);
+
+    if (currentPool == this) {
+        Worker& worker = *workers[currentWorker];
+        unique_lock lock(worker.tasksMutex);
+        worker.tasks.push_back(move(work));
+    } else {
+        unique_lock lock(globalMutex);
+        if (globalTasks.size() >= globalCapacity) {
+            // The caller is producing faster than the workers consume, it helps instead of queueing
+            lock.unlock();
+            queuedTasks.fetch_sub(1);
+            inlined.fetch_add(1, memory_order_relaxed);
+            work();
+            return;
+        }
+        globalTasks.push_back(move(work));
+    }
+
+    {
+        // Taking the mutex orders the increment with the check of a worker that is about to sleep
+        unique_lock lock(sleepMutex);
+    }
+    sleepCondition.notify_one();
+}
+//---------------------------------------------------------------------------
+// Take the next task for the worker
+bool ThreadPool::takeTask(size_t index, function<void()>& task) {
+    {
+        Worker& worker = *workers[index];
+        unique_lock lock(worker.tasksMutex);
+        if (!worker.tasks.empty()) {
+            task = move(worker.tasks.back());
+            worker.tasks.pop_back();
+            return true;
+        }
+    }
+    {
+        unique_lock lock(globalMutex);
+        if (!globalTasks.empty()) {
+            task = move(globalTasks.front());
+            globalTasks.pop_front();
+            return true;
+        }
+    }
+    for (size_t i = 1; i < workers.size(); i++) {
+        Worker& victim = *workers[(index + i) % workers.size()];
+        unique_lock lock(victim.tasksMutex);
+        if (!victim.tasks.empty()) {
+            task = move(victim.tasks.front());
+            victim.tasks.pop_front();
+            stolen.fetch_add(1, memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+//---------------------------------------------------------------------------
+// Run tasks until the pool is destroyed
+void ThreadPool::run(size_t index) {
+    currentPool = this;
+    currentWorker = index;
+
+    while (true) {
+        function<void()> task;
+        if (takeTask(index, task)) {
+            queuedTasks.fetch_sub(1);
+            task();
+            executed.fetch_add(1, memory_order_relaxed);
+            continue;
+        }
+
+        unique_lock lock(sleepMutex);
+        sleepCondition.wait(lock, [this] { return stopping || queuedTasks.load() > 0; });
+        if (stopping && queuedTasks.load() == 0) {
+            return;
+        }
+    }
+}
+//---------------------------------------------------------------------------
+// Return the statistics of the pool
+ThreadPoolStatistics ThreadPool::getStatistics() const {
+    ThreadPoolStatistics statistics;
+    statistics.executed = executed.load(memory_order_relaxed);
+    statistics.stolen = stolen.load(memory_order_relaxed);
+    statistics.inlined = inlined.load(memory_order_relaxed);
+    return statistics;
+}
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
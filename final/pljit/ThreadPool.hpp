@@ -0,0 +1,81 @@
+#ifndef H_PLJIT_THREADPOOL
+#define H_PLJIT_THREADPOOL
+#include "pljit/Executor.hpp"
+#include <atomic>
+#include <future>
+#include <memory>
+#include <type_traits>
+#include <vector>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+/// Struct that represents the statistics of a thread pool
+struct ThreadPoolStatistics {
+    /// Number of executed tasks
+    size_t executed = 0;
+    /// Number of tasks a worker took from the deque of another worker
+    size_t stolen = 0;
+    /// Number of tasks that ran on the submitting thread because the global queue was full
+    size_t inlined = 0;
+};
+/// Class that represents a work-stealing thread pool
+/// Tasks submitted by a worker go to the back of its own deque, other tasks go to the bounded global queue.
+/// An idle worker takes the newest task of its own deque, then the oldest of the global queue, then the oldest of another worker.
+class ThreadPool : public Executor {
+    public:
+    /// Constructor, uses one worker per hardware thread by default
+    explicit ThreadPool(size_t workerCount = defaultWorkerCount(), size_t globalCapacity = 4096);
+    /// Destructor, runs the remaining tasks before the workers are joined
+    ~ThreadPool() override;
+    /// Queue a task, it runs on the calling thread if the global queue is full
+    void execute(function<void()> work) override;
+    /// Queue a task and return a future of its result, the future must not be waited on by a task of the same pool
+    template <typename F>
+    future<invoke_result_t<F>> submit(F&& work) {
+        auto task = make_shared<packaged_task<invoke_result_t<F>()>>(forward<F>(work));
+        future<invoke_result_t<F>> result = task->get_future();
+        execute([task] { (*task)(); });
+        return result;
+    }
+    /// Return the number of workers
+    size_t getWorkerCount() const { return workers.size(); }
+    /// Return the statistics of the pool
+    ThreadPoolStatistics getStatistics() const;
+    /// Return the number of hardware threads, at least one
+    static size_t defaultWorkerCount();
+
+    private:
+    /// Struct that represents a worker with its own deque
+    struct Worker {
+        deque<function<void()>> tasks;
+        mutex tasksMutex;
+        thread worker;
+    };
+    /// Run tasks until the pool is destroyed
+    void run(size_t index);
+    /// Take the next task for the worker, returns false if there is none
+    bool takeTask(size_t index, function<void()>& task);
+    /// Storage of the workers
+    vector<unique_ptr<Worker>> workers;
+    /// Storage of the global queue
+    deque<function<void()>> globalTasks;
+    /// Storage of the mutex that protects the global queue
+    mutex globalMutex;
+    /// Storage of the capacity of the global queue
+    size_t globalCapacity;
+    /// Storage of the number of queued tasks, used to put idle workers to sleep
+    atomic<size_t> queuedTasks = 0;
+    /// Storage of the mutex and condition variable idle workers sleep on
+    mutex sleepMutex;
+    condition_variable sleepCondition;
+    /// Storage of whether the pool is destroyed
+    atomic<bool> stopping = false;
+    /// Storage of the counters
+    atomic<size_t> executed = 0;
+    atomic<size_t> stolen = 0;
+    atomic<size_t> inlined = 0;
+};
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
+#endif // H_PLJIT_THREADPOOL
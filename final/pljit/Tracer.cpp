@@ -0,0 +1,148 @@
+#include "pljit/Tracer.hpp"
+#include <algorithm>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+// Constructor
+Tracer::Tracer(const string& path, TraceOptions options) : options(options), session(sessions.fetch_add(1) + 1), epoch(chrono::steady_clock::now()) {
+    this->options.bufferCapacity = max<size_t>(this->options.bufferCapacity, 1);
+
+    Tracer* expected = nullptr;
+    if (!active.compare_exchange_strong(expected, this)) {
+        return;
+    }
+
+    out.open(path);
+    if (!out) {
+        active.store(nullptr);
+        while (writers.load() != 0) {
+            this_thread::yield();
+        }
+        return;
+    }
+
+    open = true;
+    out << "{\"traceEvents\":[\n";
+    flusher = thread([this] { run(); });
+}
+//---------------------------------------------------------------------------
+// Destructor
+Tracer::~Tracer() {
+    if (!open) {
+        return;
+    }
+
+    // No thread records into the tracer anymore once it is inactive and the writers have left
+    active.store(nullptr);
+    while (writers.load() != 0) {
+        this_thread::yield();
+    }
+
+    {
+        unique_lock lock(flusherMutex);
+        stopping = true;
+    }
+    flusherCondition.notify_one();
+    flusher.join();
+
+    out << "\n]}\n";
+}
+//---------------------------------------------------------------------------
+// Record a span of the current thread in the active tracer
+void Tracer::record(string_view name, uint64_t functionId, TimePoint begin, chrono::nanoseconds duration) {
+    // A begin without a time was taken before the tracer was active
+    if (begin == TimePoint()) {
+        return;
+    }
+
+    writers.fetch_add(1);
+    if (Tracer* tracer = active.load()) {
+        int64_t offset = max<int64_t>((begin - tracer->epoch).count(), 0);
+        tracer->push(Event{name, functionId, offset, duration.count()});
+    }
+    writers.fetch_sub(1);
+}
+//---------------------------------------------------------------------------
+// Return the buffer of the current thread
+Tracer::Buffer& Tracer::getBuffer() {
+    thread_local shared_ptr<Buffer> buffer;
+    thread_local uint64_t bufferSession = 0;
+
+    if (bufferSession != session) {
+        unique_lock lock(buffersMutex);
+        buffer = make_shared<Buffer>(options.bufferCapacity, buffers.size() + 1);
+        buffers.push_back(buffer);
+        bufferSession = session;
+    }
+    return *buffer;
+}
+//---------------------------------------------------------------------------
+// Append an event to the buffer of the current thread
+void Tracer::push(const Event& event) {
+    Buffer& buffer = getBuffer();
+    size_t head = buffer.head.load(memory_order_relaxed);
+
+    // A full buffer drops the event instead of waiting for the flushing thread
+    if (head - buffer.tail.load(memory_order_acquire) == buffer.events.size()) {
+        dropped.fetch_add(1, memory_order_relaxed);
+        return;
+    }
+    buffer.events[head % buffer.events.size()] = event;
+    buffer.head.store(head + 1, memory_order_release);
+}
+//---------------------------------------------------------------------------
+// Flush the buffers until the tracer is destroyed
+void Tracer::run() {
+    unique_lock lock(flusherMutex);
+    while (!stopping) {
+        flusherCondition.wait_for(lock, options.flushInterval, [this] { return stopping; });
+        lock.unlock();
+        flush();
+        lock.lock();
+    }
+}
+//---------------------------------------------------------------------------
+// Write the events of all buffers to the file
+void Tracer::flush() {
+    vector<shared_ptr<Buffer>> current;
+    {
+        unique_lock lock(buffersMutex);
+        current = buffers;
+    }
+
+    for (const auto& buffer : current) {
+        size_t tail = buffer->tail.load(memory_order_relaxed);
+        size_t head = buffer->head.load(memory_order_acquire);
+        for (; tail != head; tail++) {
+            const Event& event = buffer->events[tail % buffer->events.size()];
+            out << (firstEvent ? "" : ",\n") << "{\"name\":\"" << event.name << "\",\"cat\":\"pljit\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->threadId << ",\"ts\":";
+            writeMicroseconds(event.begin);
+            out << ",\"dur\":";
+            writeMicroseconds(event.duration);
+            out << ",\"args\":{\"function\":" << event.functionId << "}}";
+            firstEvent = false;
+        }
+        written.fetch_add(head - buffer->tail.load(memory_order_relaxed), memory_order_relaxed);
+        buffer->tail.store(head, memory_order_release);
+    }
+    out.flush();
+}
+//---------------------------------------------------------------------------
+// Write a duration in microseconds
+void Tracer::writeMicroseconds(int64_t nanoseconds) {
+    int64_t fraction = nanoseconds % 1000;
+    out << nanoseconds / 1000 << "." << (fraction < 100 ? "0" : "") << (fraction < 10 ? "0" : "") << fraction;
+}
+//---------------------------------------------------------------------------
+// Return the statistics of the tracer
+TraceStatistics Tracer::getStatistics() const {
+    TraceStatistics statistics;
+    statistics.written = written.load(memory_order_relaxed);
+    statistics.dropped = dropped.load(memory_order_relaxed);
+    unique_lock lock(buffersMutex);
+    statistics.threads = buffers.size();
+    return statistics;
+}
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
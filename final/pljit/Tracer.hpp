@@ -0,0 +1,122 @@
+#ifndef H_PLJIT_TRACER
+#define H_PLJIT_TRACER
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+using namespace std;
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+/// Struct that represents the options of a tracer
+struct TraceOptions {
+    /// Number of events every thread can buffer before new events are dropped
+    size_t bufferCapacity = 4096;
+    /// Time between two flushes of the buffers
+    chrono::milliseconds flushInterval{10};
+};
+/// Struct that represents the statistics of a tracer
+struct TraceStatistics {
+    /// Number of written events
+    size_t written = 0;
+    /// Number of events that were dropped because the buffer of their thread was full
+    size_t dropped = 0;
+    /// Number of threads that recorded events
+    size_t threads = 0;
+};
+/// Class that writes spans in the Chrome trace event format, it can be opened with chrome://tracing or Perfetto
+/// While a tracer exists it is active, every thread records into its own ring buffer and a background thread flushes them.
+/// Only one tracer is active at a time, a tracer that is created while another one exists records nothing.
+class Tracer {
+    public:
+    /// Type of a point in time
+    using TimePoint = chrono::steady_clock::time_point;
+    /// Constructor, the trace is written to the file at the given path
+    explicit Tracer(const string& path, TraceOptions options = TraceOptions());
+    /// Destructor, flushes the remaining events and completes the file
+    ~Tracer();
+    /// Tracers are not copyable
+    Tracer(const Tracer&) = delete;
+    Tracer& operator=(const Tracer&) = delete;
+    /// Return whether the file was opened and the tracer is the active one
+    bool isOpen() const { return open; }
+    /// Return the statistics of the tracer
+    TraceStatistics getStatistics() const;
+    /// Return whether a tracer is active
+    static bool isActive() { return active.load(memory_order_relaxed) != nullptr; }
+    /// Record a span of the current thread in the active tracer, the name has to outlive the tracer
+    static void record(string_view name, uint64_t functionId, TimePoint begin, chrono::nanoseconds duration);
+
+    private:
+    /// Struct that represents a recorded span
+    struct Event {
+        string_view name;
+        uint64_t functionId = 0;
+        int64_t begin = 0;
+        int64_t duration = 0;
+    };
+    /// Class that represents the ring buffer of one thread, the thread is the only producer and the flushing thread the only consumer
+    struct Buffer {
+        /// Constructor
+        Buffer(size_t capacity, size_t threadId) : events(capacity), threadId(threadId) {}
+        /// Storage of the events
+        vector<Event> events;
+        /// Storage of the number of the thread in the trace
+        size_t threadId;
+        /// Storage of the number of recorded and flushed events
+        atomic<size_t> head = 0;
+        atomic<size_t> tail = 0;
+    };
+    /// Return the buffer of the current thread, it is created on the first event
+    Buffer& getBuffer();
+    /// Append an event to the buffer of the current thread
+    void push(const Event& event);
+    /// Flush the buffers until the tracer is destroyed
+    void run();
+    /// Write the events of all buffers to the file
+    void flush();
+    /// Write a duration in microseconds
+    void writeMicroseconds(int64_t nanoseconds);
+    /// Storage of the active tracer
+    static inline atomic<Tracer*> active = nullptr;
+    /// Storage of the number of threads recording into the active tracer
+    static inline atomic<size_t> writers = 0;
+    /// Storage of the number of created tracers, it tells a thread whether its buffer belongs to the current tracer
+    static inline atomic<uint64_t> sessions = 0;
+    /// Storage of the options
+    TraceOptions options;
+    /// Storage of the number of this tracer
+    uint64_t session;
+    /// Storage of the begin of the trace
+    TimePoint epoch;
+    /// Storage of the file
+    ofstream out;
+    /// Storage of whether the file was opened and the tracer is active
+    bool open = false;
+    /// Storage of whether an event was written
+    bool firstEvent = true;
+    /// Storage of the buffers of all threads
+    vector<shared_ptr<Buffer>> buffers;
+    /// Storage of the mutex that protects the buffers
+    mutable mutex buffersMutex;
+    /// Storage of the flushing thread and its wake-up
+    thread flusher;
+    mutex flusherMutex;
+    condition_variable flusherCondition;
+    bool stopping = false;
+    /// Storage of the counters
+    atomic<size_t> written = 0;
+    atomic<size_t> dropped = 0;
+};
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
+#endif // H_PLJIT_TRACER
+//---------------------------------------------------------------------------
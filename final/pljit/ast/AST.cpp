@@ -1,7 +1,48 @@
 #include "pljit/ast/AST.hpp"
+#include "pljit/ast/ASTNodeCounter.hpp"
 //---------------------------------------------------------------------------
 namespace pljit::ast {
 //---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+// Header in front of every node of a memory resource, it tells where the memory of the node has to be returned to
+struct alignas(max_align_t) NodeHeader {
+    pmr::memory_resource* resource;
+    size_t size;
+};
+//---------------------------------------------------------------------------
+// Return the memory of a node with a header to its resource
+void deallocateWithHeader(void* node) {
+    NodeHeader* header = static_cast<NodeHeader*>(node) - 1;
+    header->resource->deallocate(header, sizeof(NodeHeader) + header->size, alignof(NodeHeader));
+}
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+// Allocate a node from a memory resource
+void* ASTNode::operator new(size_t size, pmr::memory_resource* resource) {
+    void* memory = resource->allocate(sizeof(NodeHeader) + size, alignof(NodeHeader));
+    return new (memory) NodeHeader{resource, size} + 1;
+}
+//---------------------------------------------------------------------------
+// Return the memory of a node whose construction failed to its resource
+void ASTNode::operator delete(void* node, pmr::memory_resource*) {
+    deallocateWithHeader(node);
+}
+//---------------------------------------------------------------------------
+// Destroy a node and return its memory
+void ASTNode::operator delete(ASTNode* node, destroying_delete_t) {
+    // The flag and the address of the complete node are read before the node is destroyed
+    bool header = node->hasHeader;
+    void* memory = dynamic_cast<void*>(node);
+    node->~ASTNode();
+    if (header) {
+        deallocateWithHeader(memory);
+    } else {
+        ::operator delete(memory);
+    }
+}
+//---------------------------------------------------------------------------
 // Overridden accept function
 void Constant::accept(ASTVisitor& visitor) const {
     visitor.visit(*this);
@@ -59,7 +100,7 @@ void UnaryMinus::optimize(ASTOptimizer& astOptimizer, unique_ptr<ASTNode>& thisR
 //---------------------------------------------------------------------------
 // Overridden evaluate function
 int64_t UnaryMinus::evaluate(EvaluationContext& evaluationContext) {
-    return -child->evaluate(evaluationContext);
+    return evaluationContext.apply(checkedNegate(child->evaluate(evaluationContext)));
 }
 //---------------------------------------------------------------------------
 // Overridden accept function
@@ -69,12 +110,13 @@ void DivExpr::accept(ASTVisitor& visitor) const {
 //---------------------------------------------------------------------------
 // Overridden evaluate function
 int64_t DivExpr::evaluate(EvaluationContext& evaluationContext) {
-    if (right->evaluate(evaluationContext) == 0) {
+    int64_t divisor = right->evaluate(evaluationContext);
+    if (divisor == 0) {
         evaluationContext.setError();
         evaluationContext.errorDivisionByZero();
         return 0;
     }
-    return left->evaluate(evaluationContext) / right->evaluate(evaluationContext);
+    return evaluationContext.apply(checkedDiv(left->evaluate(evaluationContext), divisor));
 }
 //---------------------------------------------------------------------------
 // Overridden optimize function
@@ -89,7 +131,7 @@ void MulExpr::accept(ASTVisitor& visitor) const {
 //---------------------------------------------------------------------------
 // Overridden evaluate function
 int64_t MulExpr::evaluate(EvaluationContext& evaluationContext) {
-    return left->evaluate(evaluationContext) * right->evaluate(evaluationContext);
+    return evaluationContext.apply(checkedMul(left->evaluate(evaluationContext), right->evaluate(evaluationContext)));
 }
 //---------------------------------------------------------------------------
 // Overridden optimize function
@@ -104,7 +146,7 @@ void SubtractExpr::accept(ASTVisitor& visitor) const {
 //---------------------------------------------------------------------------
 // Overridden evaluate function
 int64_t SubtractExpr::evaluate(EvaluationContext& evaluationContext) {
-    return left->evaluate(evaluationContext) - right->evaluate(evaluationContext);
+    return evaluationContext.apply(checkedSubtract(left->evaluate(evaluationContext), right->evaluate(evaluationContext)));
 }
 //---------------------------------------------------------------------------
 // Overridden optimize function
@@ -124,7 +166,7 @@ void AddExpr::optimize(ASTOptimizer& astOptimizer, unique_ptr<ASTNode>& thisRef)
 //---------------------------------------------------------------------------
 // Overridden evaluate function
 int64_t AddExpr::evaluate(EvaluationContext& evaluationContext) {
-    return left->evaluate(evaluationContext) + right->evaluate(evaluationContext);
+    return evaluationContext.apply(checkedAdd(left->evaluate(evaluationContext), right->evaluate(evaluationContext)));
 }
 //---------------------------------------------------------------------------
 // Overridden accept function
@@ -184,16 +226,62 @@ void Function::accept(ASTVisitor& visitor) const {
 // Overridden optimize function
 void Function::optimize(ASTOptimizer& astOptimizer, unique_ptr<ASTNode>& thisRef) {
     thisRef = astOptimizer.visit(*this);
+    if (thisRef && thisRef->getType() == ASTNode::Type::Function) {
+        static_cast<Function&>(*thisRef).computeCosts();
+    }
 }
 //---------------------------------------------------------------------------
 // Overridden evaluate function
 int64_t Function::evaluate(EvaluationContext& evaluationContext) {
+    int64_t value = execute(evaluationContext);
+    if (evaluationContext.errorOccurred()) {
+        error = true;
+    }
+    return value;
+}
+//---------------------------------------------------------------------------
+// Evaluate the function without modifying it
+int64_t Function::execute(EvaluationContext& evaluationContext) const {
+    if (evaluationContext.getProfile()) {
+        return executeProfiled(evaluationContext);
+    }
+
     int64_t value = 0;
-    for (auto& i : statements) {
-        auto& statement = static_cast<ASTStatement&>(*i);
+    for (size_t i = 0; i < statements.size(); i++) {
+        // The fuel is checked once per statement, which bounds the evaluated nodes without a check per node
+        if (!evaluationContext.consumeFuel(getCost(i))) {
+            return 0;
+        }
+        auto& statement = static_cast<ASTStatement&>(*statements[i]);
+        value = statement.evaluate(evaluationContext);
+        // An overflow is only checked once per statement, the nodes just remember it
+        if (evaluationContext.errorOccurred() || !evaluationContext.checkOverflow()) {
+            return 0;
+        }
+        if (statement.getExpression().getType() == ASTNode::Type::ReturnExpr) {
+            return value;
+        }
+    }
+    return value;
+}
+//---------------------------------------------------------------------------
+// Evaluate the function and record every statement in the profile of the context
+int64_t Function::executeProfiled(EvaluationContext& evaluationContext) const {
+    ExecutionProfile& profile = *evaluationContext.getProfile();
+    int64_t value = 0;
+    for (size_t i = 0; i < statements.size(); i++) {
+        if (!evaluationContext.consumeFuel(getCost(i))) {
+            return 0;
+        }
+        // The profile counts the statements of the code, an optimized function may have removed, merged or split some
+        auto& statement = static_cast<ASTStatement&>(*statements[i]);
+        size_t sourceIndex = statement.getSourceIndex();
+        bool split = i > 0 && static_cast<const ASTStatement&>(*statements[i - 1]).getSourceIndex() == sourceIndex;
+        evaluationContext.setCurrentStatement(sourceIndex);
+        auto begin = chrono::steady_clock::now();
         value = statement.evaluate(evaluationContext);
-        if (evaluationContext.errorOccurred()) {
-            error = true;
+        profile.recordStatement(sourceIndex, chrono::steady_clock::now() - begin, !split);
+        if (evaluationContext.errorOccurred() || !evaluationContext.checkOverflow()) {
             return 0;
         }
         if (statement.getExpression().getType() == ASTNode::Type::ReturnExpr) {
@@ -203,5 +291,14 @@ int64_t Function::evaluate(EvaluationContext& evaluationContext) {
     return value;
 }
 //---------------------------------------------------------------------------
+// Compute the fuel of every statement
+void Function::computeCosts() {
+    ASTNodeCounter astNodeCounter;
+    statementCosts.clear();
+    for (const auto& statement : statements) {
+        statementCosts.push_back(statement ? astNodeCounter.count(*statement) : 1);
+    }
+}
+//---------------------------------------------------------------------------
 } // namespace pljit::ast
 //---------------------------------------------------------------------------
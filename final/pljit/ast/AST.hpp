@@ -3,6 +3,8 @@
 #include "pljit/ast/ASTOptimizer.hpp"
 #include "pljit/ast/ASTVisitor.hpp"
 #include "pljit/evaluation/EvaluationContext.hpp"
+#include <memory_resource>
+#include <new>
 using namespace pljit::evaluation;
 //---------------------------------------------------------------------------
 namespace pljit::ast {
@@ -28,8 +30,20 @@ class ASTNode {
     /// Constructors
     ASTNode() = default;
     explicit ASTNode(bool error) : error(error) {}
+    /// Copy constructor and assignment, a copy knows nothing about the memory of the original
+    ASTNode(const ASTNode& other) : error(other.error) {}
+    ASTNode& operator=(const ASTNode& other) {
+        error = other.error;
+        return *this;
+    }
     /// Destructor
     virtual ~ASTNode() = default;
+    /// Allocate a node from the global allocator, it has no header
+    static void* operator new(size_t size) { return ::operator new(size); }
+    /// Destroy a node and return its memory to where it was allocated from, so every node can be deleted through a unique_ptr
+    static void operator delete(ASTNode* node, destroying_delete_t);
+    /// Return the memory of a node whose construction failed
+    static void operator delete(void* node) { ::operator delete(node); }
     /// Get the type of the ast node
     virtual ASTNode::Type getType() const = 0;
     /// Accept a visitor
@@ -44,8 +58,30 @@ class ASTNode {
     protected:
     /// Storage of the error
     bool error = false;
+
+    private:
+    /// Allocate a node from a memory resource, the resource is stored in a header in front of the node
+    static void* operator new(size_t size, pmr::memory_resource* resource);
+    static void operator delete(void* node, pmr::memory_resource*);
+    /// Storage of whether the node has a header, it fits into the padding of the node
+    bool hasHeader = false;
+
+    template <typename T, typename... Args>
+    friend unique_ptr<T> allocateNode(pmr::memory_resource* resource, Args&&... args);
 };
 //---------------------------------------------------------------------------
+/// Create a node from a memory resource, the resource has to outlive the node
+template <typename T, typename... Args>
+unique_ptr<T> allocateNode(pmr::memory_resource* resource, Args&&... args) {
+    // The global allocator needs no header to find its memory again
+    if (resource == pmr::new_delete_resource()) {
+        return unique_ptr<T>(new T(forward<Args>(args)...));
+    }
+    unique_ptr<T> node(new (resource) T(forward<Args>(args)...));
+    node->hasHeader = true;
+    return node;
+}
+//---------------------------------------------------------------------------
 class Constant : public ASTNode {
     public:
     /// Constructors
@@ -227,6 +263,8 @@ class AssignmentExpr : public BinaryExpr {
     explicit AssignmentExpr(bool error) : BinaryExpr(error) {}
     /// Overridden getType function
     ASTNode::Type getType() const override { return ASTNode::Type::AssignmentExpr; }
+    /// Getter
+    string_view getName() const { return nameLeft; }
     /// Overridden accept function
     void accept(ASTVisitor& visitor) const override;
     /// Overridden optimize function
@@ -259,13 +297,16 @@ class ASTStatement : public ASTNode {
     public:
     /// Constructors
     ASTStatement() = default;
-    explicit ASTStatement(unique_ptr<ASTNode> expression) : expression(move(expression)) {}
+    explicit ASTStatement(unique_ptr<ASTNode> expression, size_t sourceIndex = 0) : expression(move(expression)), sourceIndex(sourceIndex) {}
     explicit ASTStatement(bool error) : ASTNode(error) {}
     /// Overridden getType function
     ASTNode::Type getType() const override { return ASTNode::Type::ASTStatement; }
     /// Getters
     const ASTNode& getExpression() const { return *expression; }
     unique_ptr<ASTNode> releaseInput() { return move(expression); }
+    /// Return the position of the statement in the statement list of the code, the optimizations keep it
+    size_t getSourceIndex() const { return sourceIndex; }
+    void setSourceIndex(size_t sourceIndex1) { sourceIndex = sourceIndex1; }
     /// Overridden accept function
     void accept(ASTVisitor& visitor) const override;
     /// Overridden evaluate function
@@ -276,13 +317,15 @@ class ASTStatement : public ASTNode {
     private:
     /// Storage of the expression
     unique_ptr<ASTNode> expression;
+    /// Storage of the position of the statement in the code
+    size_t sourceIndex = 0;
 };
 //---------------------------------------------------------------------------
 class Function : public ASTNode {
     public:
     /// Constructors
     Function() = default;
-    Function(vector<unique_ptr<ASTNode>> statements, OptimizationTable optimizationTable) : statements(move(statements)), optimizationTable(move(optimizationTable)) {}
+    Function(vector<unique_ptr<ASTNode>> statements, OptimizationTable optimizationTable) : statements(move(statements)), optimizationTable(move(optimizationTable)) { computeCosts(); }
     explicit Function(bool error) : ASTNode(error) {}
     /// Overridden getType function
     ASTNode::Type getType() const override { return ASTNode::Type::Function; }
@@ -290,16 +333,28 @@ class Function : public ASTNode {
     const vector<unique_ptr<ASTNode>>& getStatements() const { return statements; }
     vector<unique_ptr<ASTNode>>& getStatements() { return statements; }
     OptimizationTable& getSymbolTable() { return optimizationTable; }
+    const OptimizationTable& getSymbolTable() const { return optimizationTable; }
     /// Overridden accept function
     void accept(ASTVisitor& visitor) const override;
     /// Overridden optimize function
     void optimize(ASTOptimizer& astOptimizer, unique_ptr<ASTNode>& thisRef) override;
-    /// Overridden evaluate function
+    /// Overridden evaluate function, remembers an error in the function
     int64_t evaluate(EvaluationContext& evaluationContext) override;
+    /// Evaluate the function without modifying it, errors are only reported in the context, it can run concurrently
+    /// Every statement consumes the number of its nodes from the fuel of the context before it is evaluated.
+    int64_t execute(EvaluationContext& evaluationContext) const;
+    /// Compute the fuel of every statement again, it has to be called after the statements were modified
+    void computeCosts();
+    /// Return the fuel a statement consumes
+    uint64_t getCost(size_t statement) const { return statement < statementCosts.size() ? statementCosts[statement] : 1; }
 
     private:
+    /// Evaluate the function and record every statement in the profile of the context
+    int64_t executeProfiled(EvaluationContext& evaluationContext) const;
     /// Storage of the statements
     vector<unique_ptr<ASTNode>> statements;
+    /// Storage of the fuel of every statement
+    vector<uint64_t> statementCosts;
     /// Storage of the symbol table
     OptimizationTable optimizationTable;
 };
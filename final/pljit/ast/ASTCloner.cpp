@@ -0,0 +1,81 @@
+#include "pljit/ast/ASTCloner.hpp"
+//---------------------------------------------------------------------------
+namespace pljit::ast {
+//---------------------------------------------------------------------------
+// Return a copy of the subtree
+unique_ptr<ASTNode> ASTCloner::clone(const ASTNode& node) {
+    node.accept(*this);
+    return move(result);
+}
+//---------------------------------------------------------------------------
+// Copy a constant
+void ASTCloner::visit(const Constant& constant) {
+    result = allocateNode<Constant>(resource, constant.getValue());
+}
+//---------------------------------------------------------------------------
+// Copy a parameter
+void ASTCloner::visit(const Parameter& parameter) {
+    result = allocateNode<Parameter>(resource, parameter.getName());
+}
+//---------------------------------------------------------------------------
+// Copy a function
+void ASTCloner::visit(const Function& function) {
+    vector<unique_ptr<ASTNode>> statements;
+    for (const auto& statement : function.getStatements()) {
+        statements.push_back(clone(*statement));
+    }
+    result = allocateNode<Function>(resource, move(statements), OptimizationTable(function.getSymbolTable(), resource));
+}
+//---------------------------------------------------------------------------
+// Copy a statement
+void ASTCloner::visit(const ASTStatement& astStatement) {
+    result = allocateNode<ASTStatement>(resource, clone(astStatement.getExpression()), astStatement.getSourceIndex());
+}
+//---------------------------------------------------------------------------
+// Copy an assignment
+void ASTCloner::visit(const AssignmentExpr& assignmentExpr) {
+    unique_ptr<ASTNode> left = clone(assignmentExpr.getLeft());
+    result = allocateNode<AssignmentExpr>(resource, move(left), clone(assignmentExpr.getRight()), assignmentExpr.getName());
+}
+//---------------------------------------------------------------------------
+// Copy a return statement
+void ASTCloner::visit(const ReturnExpr& returnExpr) {
+    result = allocateNode<ReturnExpr>(resource, clone(returnExpr.getChild()));
+}
+//---------------------------------------------------------------------------
+// Copy a multiplication
+void ASTCloner::visit(const MulExpr& mulExpr) {
+    unique_ptr<ASTNode> left = clone(mulExpr.getLeft());
+    result = allocateNode<MulExpr>(resource, move(left), clone(mulExpr.getRight()));
+}
+//---------------------------------------------------------------------------
+// Copy a division
+void ASTCloner::visit(const DivExpr& divExpr) {
+    unique_ptr<ASTNode> left = clone(divExpr.getLeft());
+    result = allocateNode<DivExpr>(resource, move(left), clone(divExpr.getRight()));
+}
+//---------------------------------------------------------------------------
+// Copy an addition
+void ASTCloner::visit(const AddExpr& addExpr) {
+    unique_ptr<ASTNode> left = clone(addExpr.getLeft());
+    result = allocateNode<AddExpr>(resource, move(left), clone(addExpr.getRight()));
+}
+//---------------------------------------------------------------------------
+// Copy a subtraction
+void ASTCloner::visit(const SubtractExpr& subtractExpr) {
+    unique_ptr<ASTNode> left = clone(subtractExpr.getLeft());
+    result = allocateNode<SubtractExpr>(resource, move(left), clone(subtractExpr.getRight()));
+}
+//---------------------------------------------------------------------------
+// Copy a unary plus
+void ASTCloner::visit(const UnaryPlus& unaryPlus) {
+    result = allocateNode<UnaryPlus>(resource, clone(unaryPlus.getChild()));
+}
+//---------------------------------------------------------------------------
+// Copy a unary minus
+void ASTCloner::visit(const UnaryMinus& unaryMinus) {
+    result = allocateNode<UnaryMinus>(resource, clone(unaryMinus.getChild()));
+}
+//---------------------------------------------------------------------------
+} // namespace pljit::ast
+//---------------------------------------------------------------------------
@@ -0,0 +1,39 @@
+#ifndef H_PLJIT_ASTCLONER
+#define H_PLJIT_ASTCLONER
+#include "pljit/ast/AST.hpp"
+//---------------------------------------------------------------------------
+namespace pljit::ast {
+//---------------------------------------------------------------------------
+/// Struct that implements a visitor that copies an ast, the names still refer to the code of the original
+struct ASTCloner : ASTVisitor {
+    /// Constructor, the copies are allocated from the memory resource
+    explicit ASTCloner(pmr::memory_resource* resource = pmr::get_default_resource()) : resource(resource) {}
+    /// Destructor
+    ~ASTCloner() override = default;
+    /// Return a copy of the subtree
+    unique_ptr<ASTNode> clone(const ASTNode& node);
+    /// Visit functions
+    void visit(const Constant&) override;
+    void visit(const Parameter&) override;
+    void visit(const Function&) override;
+    void visit(const ASTStatement&) override;
+    void visit(const AssignmentExpr&) override;
+    void visit(const ReturnExpr&) override;
+    void visit(const MulExpr&) override;
+    void visit(const DivExpr&) override;
+    void visit(const AddExpr&) override;
+    void visit(const SubtractExpr&) override;
+    void visit(const UnaryPlus&) override;
+    void visit(const UnaryMinus&) override;
+
+    private:
+    /// Storage of the memory resource of the copies
+    pmr::memory_resource* resource;
+    /// Storage of the copy of the last visited node
+    unique_ptr<ASTNode> result;
+};
+//---------------------------------------------------------------------------
+} // namespace pljit::ast
+//---------------------------------------------------------------------------
+#endif // H_PLJIT_ASTCLONER
+//---------------------------------------------------------------------------
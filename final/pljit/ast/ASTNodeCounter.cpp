@@ -0,0 +1,90 @@
+#include "pljit/ast/ASTNodeCounter.hpp"
+//---------------------------------------------------------------------------
+namespace pljit::ast {
+//---------------------------------------------------------------------------
+// Return the number of nodes of the subtree
+size_t ASTNodeCounter::count(const ASTNode& node) {
+    nodes = 0;
+    node.accept(*this);
+    return nodes;
+}
+//---------------------------------------------------------------------------
+// Count a binary expression
+void ASTNodeCounter::visitBinary(const BinaryExpr& binaryExpr) {
+    nodes++;
+    binaryExpr.getLeft().accept(*this);
+    binaryExpr.getRight().accept(*this);
+}
+//---------------------------------------------------------------------------
+// Count a unary expression
+void ASTNodeCounter::visitUnary(const UnaryExpr& unaryExpr) {
+    nodes++;
+    unaryExpr.getChild().accept(*this);
+}
+//---------------------------------------------------------------------------
+// Count a constant
+void ASTNodeCounter::visit(const Constant&) {
+    nodes++;
+}
+//---------------------------------------------------------------------------
+// Count a parameter
+void ASTNodeCounter::visit(const Parameter&) {
+    nodes++;
+}
+//---------------------------------------------------------------------------
+// Count a function
+void ASTNodeCounter::visit(const Function& function) {
+    nodes++;
+    for (const auto& statement : function.getStatements()) {
+        statement->accept(*this);
+    }
+}
+//---------------------------------------------------------------------------
+// Count a statement
+void ASTNodeCounter::visit(const ASTStatement& astStatement) {
+    nodes++;
+    astStatement.getExpression().accept(*this);
+}
+//---------------------------------------------------------------------------
+// Count an assignment
+void ASTNodeCounter::visit(const AssignmentExpr& assignmentExpr) {
+    visitBinary(assignmentExpr);
+}
+//---------------------------------------------------------------------------
+// Count a return statement
+void ASTNodeCounter::visit(const ReturnExpr& returnExpr) {
+    visitUnary(returnExpr);
+}
+//---------------------------------------------------------------------------
+// Count a multiplication
+void ASTNodeCounter::visit(const MulExpr& mulExpr) {
+    visitBinary(mulExpr);
+}
+//---------------------------------------------------------------------------
+// Count a division
+void ASTNodeCounter::visit(const DivExpr& divExpr) {
+    visitBinary(divExpr);
+}
+//---------------------------------------------------------------------------
+// Count an addition
+void ASTNodeCounter::visit(const AddExpr& addExpr) {
+    visitBinary(addExpr);
+}
+//---------------------------------------------------------------------------
+// Count a subtraction
+void ASTNodeCounter::visit(const SubtractExpr& subtractExpr) {
+    visitBinary(subtractExpr);
+}
+//---------------------------------------------------------------------------
+// Count a unary plus
+void ASTNodeCounter::visit(const UnaryPlus& unaryPlus) {
+    visitUnary(unaryPlus);
+}
+//---------------------------------------------------------------------------
+// Count a unary minus
+void ASTNodeCounter::visit(const UnaryMinus& unaryMinus) {
+    visitUnary(unaryMinus);
+}
+//---------------------------------------------------------------------------
+} // namespace pljit::ast
+//---------------------------------------------------------------------------
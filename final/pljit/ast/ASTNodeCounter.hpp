@@ -0,0 +1,41 @@
+#ifndef H_PLJIT_ASTNODECOUNTER
+#define H_PLJIT_ASTNODECOUNTER
+#include "pljit/ast/AST.hpp"
+//---------------------------------------------------------------------------
+namespace pljit::ast {
+//---------------------------------------------------------------------------
+/// Struct that implements a visitor that counts the nodes of an ast
+struct ASTNodeCounter : ASTVisitor {
+    /// Constructor
+    ASTNodeCounter() = default;
+    /// Destructor
+    ~ASTNodeCounter() override = default;
+    /// Return the number of nodes of the subtree
+    size_t count(const ASTNode& node);
+    /// Visit functions
+    void visit(const Constant&) override;
+    void visit(const Parameter&) override;
+    void visit(const Function&) override;
+    void visit(const ASTStatement&) override;
+    void visit(const AssignmentExpr&) override;
+    void visit(const ReturnExpr&) override;
+    void visit(const MulExpr&) override;
+    void visit(const DivExpr&) override;
+    void visit(const AddExpr&) override;
+    void visit(const SubtractExpr&) override;
+    void visit(const UnaryPlus&) override;
+    void visit(const UnaryMinus&) override;
+
+    private:
+    /// Count a binary expression
+    void visitBinary(const BinaryExpr& binaryExpr);
+    /// Count a unary expression
+    void visitUnary(const UnaryExpr& unaryExpr);
+    /// Storage of the number of visited nodes
+    size_t nodes = 0;
+};
+//---------------------------------------------------------------------------
+} // namespace pljit::ast
+//---------------------------------------------------------------------------
+#endif // H_PLJIT_ASTNODECOUNTER
+//---------------------------------------------------------------------------
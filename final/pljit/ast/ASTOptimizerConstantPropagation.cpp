@@ -4,15 +4,15 @@ namespace pljit::ast {
 //---------------------------------------------------------------------------
 // Optimize a constant
 unique_ptr<ASTNode> ASTOptimizerConstantPropagation::visit(Constant& constant) {
-    return make_unique<Constant>(move(constant));
+    return allocateNode<Constant>(resource, move(constant));
 }
 //---------------------------------------------------------------------------
 // Optimize a parameter
 unique_ptr<ASTNode> ASTOptimizerConstantPropagation::visit(Parameter& parameter) {
     if (optimizationTable.isConstant(parameter.getName())) {
-        return make_unique<Constant>(optimizationTable.getValue(parameter.getName()));
+        return allocateNode<Constant>(resource, optimizationTable.getValue(parameter.getName()));
     }
-    return make_unique<Parameter>(move(parameter));
+    return allocateNode<Parameter>(resource, move(parameter));
 }
 //---------------------------------------------------------------------------
 // Optimize a function
@@ -22,14 +22,14 @@ unique_ptr<ASTNode> ASTOptimizerConstantPropagation::visit(Function& function) {
     for (auto& functionStatement : functionStatements) {
         functionStatement->optimize(*this, functionStatement);
     }
-    return make_unique<Function>(move(functionStatements), move(optimizationTable));
+    return allocateNode<Function>(resource, move(functionStatements), move(optimizationTable));
 }
 //---------------------------------------------------------------------------
 // Optimize a statement
 unique_ptr<ASTNode> ASTOptimizerConstantPropagation::visit(ASTStatement& astStatement) {
     auto expr = astStatement.releaseInput();
     expr->optimize(*this, expr);
-    return make_unique<ASTStatement>(move(expr));
+    return allocateNode<ASTStatement>(resource, move(expr), astStatement.getSourceIndex());
 }
 //---------------------------------------------------------------------------
 // Optimize an assignment
@@ -50,14 +50,14 @@ unique_ptr<ASTNode> ASTOptimizerConstantPropagation::visit(AssignmentExpr& assig
         optimizationTable.setConstant(leftRef.getName(), false);
     }
     string_view nameLeft = leftRef.getName();
-    return make_unique<AssignmentExpr>(move(left), move(right), nameLeft);
+    return allocateNode<AssignmentExpr>(resource, move(left), move(right), nameLeft);
 }
 //---------------------------------------------------------------------------
 // Optimize a return statement
 unique_ptr<ASTNode> ASTOptimizerConstantPropagation::visit(ReturnExpr& returnExpr) {
     auto childNode = returnExpr.releaseInput();
     childNode->optimize(*this, childNode);
-    return make_unique<ReturnExpr>(move(childNode));
+    return allocateNode<ReturnExpr>(resource, move(childNode));
 }
 //---------------------------------------------------------------------------
 // Optimize a multiplication
@@ -73,7 +73,7 @@ unique_ptr<ASTNode> ASTOptimizerConstantPropagation::visit(MulExpr& mulExpr) {
     }
 
     if (checkValueZero(left.get()) || checkValueZero(right.get())) {
-        return make_unique<Constant>(0);
+        return allocateNode<Constant>(resource, 0);
     }
 
     if (checkValueOne(right.get())) {
@@ -81,21 +81,22 @@ unique_ptr<ASTNode> ASTOptimizerConstantPropagation::visit(MulExpr& mulExpr) {
     }
 
     if (left->getType() == ASTNode::Type::Constant && right->getType() == ASTNode::Type::Constant) {
-        EvaluationContext evaluationContext(optimizationTable);
-        MulExpr mulExpr1 = MulExpr(move(left), move(right));
-        int64_t value = mulExpr1.evaluate(evaluationContext);
-        return make_unique<Constant>(value);
+        int64_t leftValue = static_cast<Constant&>(*left).getValue();
+        int64_t rightValue = static_cast<Constant&>(*right).getValue();
+        if (unique_ptr<ASTNode> constant = fold(checkedMul(leftValue, rightValue))) {
+            return constant;
+        }
     }
 
-    if (left->getType() == ASTNode::Type::UnaryMinus && right->getType() == ASTNode::Type::UnaryMinus) {
-        left = make_unique<UnaryMinus>(move(left));
-        right = make_unique<UnaryMinus>(move(right));
+    if (canMoveNegation() && left->getType() == ASTNode::Type::UnaryMinus && right->getType() == ASTNode::Type::UnaryMinus) {
+        left = allocateNode<UnaryMinus>(resource, move(left));
+        right = allocateNode<UnaryMinus>(resource, move(right));
         left->optimize(*this, left);
         right->optimize(*this, right);
-        return make_unique<MulExpr>(move(left), move(right));
+        return allocateNode<MulExpr>(resource, move(left), move(right));
     }
 
-    return make_unique<MulExpr>(move(left), move(right));
+    return allocateNode<MulExpr>(resource, move(left), move(right));
 }
 //---------------------------------------------------------------------------
 // Optimize a division
@@ -107,11 +108,11 @@ unique_ptr<ASTNode> ASTOptimizerConstantPropagation::visit(DivExpr& divExpr) {
     right->optimize(*this, right);
 
     if (checkValueZero(right.get())) {
-        return make_unique<DivExpr>(move(left), move(right));
+        return allocateNode<DivExpr>(resource, move(left), move(right));
     }
 
     if (checkValueZero(left.get())) {
-        return make_unique<Constant>(0);
+        return allocateNode<Constant>(resource, 0);
     }
 
     if (checkValueOne(right.get())) {
@@ -119,21 +120,22 @@ unique_ptr<ASTNode> ASTOptimizerConstantPropagation::visit(DivExpr& divExpr) {
     }
 
     if (left->getType() == ASTNode::Type::Constant && right->getType() == ASTNode::Type::Constant) {
-        EvaluationContext evaluationContext(optimizationTable);
-        DivExpr divExpr1 = DivExpr(move(left), move(right));
-        int64_t value = divExpr1.evaluate(evaluationContext);
-        return make_unique<Constant>(value);
+        int64_t leftValue = static_cast<Constant&>(*left).getValue();
+        int64_t rightValue = static_cast<Constant&>(*right).getValue();
+        if (unique_ptr<ASTNode> constant = fold(checkedDiv(leftValue, rightValue))) {
+            return constant;
+        }
     }
 
-    if (left->getType() == ASTNode::Type::UnaryMinus && right->getType() == ASTNode::Type::UnaryMinus) {
-        left = make_unique<UnaryMinus>(move(left));
-        right = make_unique<UnaryMinus>(move(right));
+    if (canMoveNegation() && left->getType() == ASTNode::Type::UnaryMinus && right->getType() == ASTNode::Type::UnaryMinus) {
+        left = allocateNode<UnaryMinus>(resource, move(left));
+        right = allocateNode<UnaryMinus>(resource, move(right));
         left->optimize(*this, left);
         right->optimize(*this, right);
-        return make_unique<DivExpr>(move(left), move(right));
+        return allocateNode<DivExpr>(resource, move(left), move(right));
     }
 
-    return make_unique<DivExpr>(move(left), move(right));
+    return allocateNode<DivExpr>(resource, move(left), move(right));
 }
 //---------------------------------------------------------------------------
 // Optimize an addition
@@ -152,28 +154,29 @@ unique_ptr<ASTNode> ASTOptimizerConstantPropagation::visit(AddExpr& addExpr) {
         return left;
     }
 
-    if (left->getType() == ASTNode::Type::UnaryMinus) {
-        left = make_unique<UnaryMinus>(move(left));
-        unique_ptr<ASTNode> expr = make_unique<SubtractExpr>(move(right), move(left));
+    if (canMoveNegation() && left->getType() == ASTNode::Type::UnaryMinus) {
+        left = allocateNode<UnaryMinus>(resource, move(left));
+        unique_ptr<ASTNode> expr = allocateNode<SubtractExpr>(resource, move(right), move(left));
         expr->optimize(*this, expr);
         return expr;
     }
 
-    if (right->getType() == ASTNode::Type::UnaryMinus) {
-        right = make_unique<UnaryMinus>(move(right));
-        unique_ptr<ASTNode> expr = make_unique<SubtractExpr>(move(left), move(right));
+    if (canMoveNegation() && right->getType() == ASTNode::Type::UnaryMinus) {
+        right = allocateNode<UnaryMinus>(resource, move(right));
+        unique_ptr<ASTNode> expr = allocateNode<SubtractExpr>(resource, move(left), move(right));
         expr->optimize(*this, expr);
         return expr;
     }
 
     if (left->getType() == ASTNode::Type::Constant && right->getType() == ASTNode::Type::Constant) {
-        EvaluationContext evaluationContext(optimizationTable);
-        AddExpr addExpr1 = AddExpr(move(left), move(right));
-        int64_t value = addExpr1.evaluate(evaluationContext);
-        return make_unique<Constant>(value);
+        int64_t leftValue = static_cast<Constant&>(*left).getValue();
+        int64_t rightValue = static_cast<Constant&>(*right).getValue();
+        if (unique_ptr<ASTNode> constant = fold(checkedAdd(leftValue, rightValue))) {
+            return constant;
+        }
     }
 
-    return make_unique<AddExpr>(move(left), move(right));
+    return allocateNode<AddExpr>(resource, move(left), move(right));
 }
 //---------------------------------------------------------------------------
 // Optimize a subtraction
@@ -189,27 +192,30 @@ unique_ptr<ASTNode> ASTOptimizerConstantPropagation::visit(SubtractExpr& subtrac
     }
 
     if (checkValueZero(left.get())) {
-        return make_unique<UnaryMinus>(move(right));
+        return allocateNode<UnaryMinus>(resource, move(right));
     }
 
-    if (right->getType() == ASTNode::Type::UnaryMinus) {
-        right = make_unique<UnaryMinus>(move(right));
-        unique_ptr<ASTNode> expr = make_unique<AddExpr>(move(left), move(right));
+    if (canMoveNegation() && right->getType() == ASTNode::Type::UnaryMinus) {
+        right = allocateNode<UnaryMinus>(resource, move(right));
+        unique_ptr<ASTNode> expr = allocateNode<AddExpr>(resource, move(left), move(right));
         expr->optimize(*this, expr);
         return expr;
     }
 
     if (left->getType() == ASTNode::Type::Constant && right->getType() == ASTNode::Type::Constant) {
-        EvaluationContext evaluationContext(optimizationTable);
-        SubtractExpr subtractExpr1 = SubtractExpr(move(left), move(right));
-        int64_t value = subtractExpr1.evaluate(evaluationContext);
-        if (value < 0) {
-            return make_unique<UnaryMinus>(make_unique<Constant>(-value));
+        int64_t leftValue = static_cast<Constant&>(*left).getValue();
+        int64_t rightValue = static_cast<Constant&>(*right).getValue();
+        if (unique_ptr<ASTNode> constant = fold(checkedSubtract(leftValue, rightValue))) {
+            // The smallest value has no positive counterpart, so it stays a constant
+            int64_t value = static_cast<Constant&>(*constant).getValue();
+            if (value < 0 && value != numeric_limits<int64_t>::min()) {
+                return allocateNode<UnaryMinus>(resource, allocateNode<Constant>(resource, -value));
+            }
+            return constant;
         }
-        return make_unique<Constant>(value);
     }
 
-    return make_unique<SubtractExpr>(move(left), move(right));
+    return allocateNode<SubtractExpr>(resource, move(left), move(right));
 }
 //---------------------------------------------------------------------------
 // Optimize a unary plus
@@ -226,7 +232,13 @@ unique_ptr<ASTNode> ASTOptimizerConstantPropagation::visit(UnaryMinus& unaryMinu
 
     if (childNode->getType() == ASTNode::Type::Constant) {
         auto& constant = static_cast<Constant&>(*childNode);
-        return make_unique<Constant>(-constant.getValue());
+        if (unique_ptr<ASTNode> folded = fold(checkedNegate(constant.getValue()))) {
+            return folded;
+        }
+    }
+
+    if (!canMoveNegation()) {
+        return allocateNode<UnaryMinus>(resource, move(childNode));
     }
 
     if (childNode->getType() == ASTNode::Type::UnaryMinus) {
@@ -239,10 +251,18 @@ unique_ptr<ASTNode> ASTOptimizerConstantPropagation::visit(UnaryMinus& unaryMinu
         auto& subtractExpr = static_cast<SubtractExpr&>(*childNode);
         auto left = subtractExpr.releaseLeft();
         auto right = subtractExpr.releaseRight();
-        return make_unique<SubtractExpr>(move(right), move(left));
+        return allocateNode<SubtractExpr>(resource, move(right), move(left));
     }
 
-    return make_unique<UnaryMinus>(move(childNode));
+    return allocateNode<UnaryMinus>(resource, move(childNode));
+}
+//---------------------------------------------------------------------------
+// Return the constant of a folded operation
+unique_ptr<ASTNode> ASTOptimizerConstantPropagation::fold(const CheckedResult& result) const {
+    if (result.overflow && arithmeticMode == ArithmeticMode::Trapping) {
+        return nullptr;
+    }
+    return allocateNode<Constant>(resource, result.get(arithmeticMode == ArithmeticMode::Saturating));
 }
 //---------------------------------------------------------------------------
 // Helper function to check whether a node value evaluates to zero
@@ -6,8 +6,9 @@ namespace pljit::ast {
 //---------------------------------------------------------------------------
 /// Struct that represents a constant propagation pass (MILESTONE 5)
 struct ASTOptimizerConstantPropagation : ASTOptimizer {
-    /// Constructors
-    explicit ASTOptimizerConstantPropagation(OptimizationTable& optimizationTable) : optimizationTable(optimizationTable){};
+    /// Constructors, the folded constants follow the arithmetic mode of the evaluation, the optimized nodes are allocated from the memory resource
+    explicit ASTOptimizerConstantPropagation(OptimizationTable& optimizationTable, ArithmeticMode arithmeticMode = ArithmeticMode::Wrapping, pmr::memory_resource* resource = pmr::get_default_resource())
+        : optimizationTable(optimizationTable, resource), arithmeticMode(arithmeticMode), resource(resource){};
     ASTOptimizerConstantPropagation() = default;
     /// Destructor
     ~ASTOptimizerConstantPropagation() override = default;
@@ -28,6 +29,14 @@ struct ASTOptimizerConstantPropagation : ASTOptimizer {
     private:
     /// Storage of the symboltable
     OptimizationTable optimizationTable;
+    /// Storage of the arithmetic mode
+    ArithmeticMode arithmeticMode = ArithmeticMode::Wrapping;
+    /// Storage of the memory resource of the nodes
+    pmr::memory_resource* resource = pmr::get_default_resource();
+    /// Return the constant of a folded operation, nullptr if it overflows in the trapping mode, which has to fail at runtime
+    unique_ptr<ASTNode> fold(const CheckedResult& result) const;
+    /// Return whether a negation may be moved, it changes the result of an overflow unless the arithmetic wraps around
+    bool canMoveNegation() const { return arithmeticMode == ArithmeticMode::Wrapping; }
     /// Helper function to check whether a node value evaluates to zero
     static bool checkValueZero(ASTNode* node);
     /// Helper function to check whether a node value evaluates to one
@@ -4,12 +4,12 @@ namespace pljit::ast {
 //---------------------------------------------------------------------------
 // Optimize a constant
 unique_ptr<ASTNode> ASTOptimizerDeadCode::visit(Constant& constant) {
-    return make_unique<Constant>(move(constant));
+    return allocateNode<Constant>(resource, move(constant));
 }
 //---------------------------------------------------------------------------
 // Optimize a parameter
 unique_ptr<ASTNode> ASTOptimizerDeadCode::visit(Parameter& parameter) {
-    return make_unique<Parameter>(move(parameter));
+    return allocateNode<Parameter>(resource, move(parameter));
 }
 //---------------------------------------------------------------------------
 // Optimize a function
@@ -23,55 +23,55 @@ unique_ptr<ASTNode> ASTOptimizerDeadCode::visit(Function& function) {
             break;
         }
     }
-    return make_unique<Function>(move(optimizedStatements), move(function.getSymbolTable()));
+    return allocateNode<Function>(resource, move(optimizedStatements), move(function.getSymbolTable()));
 }
 //---------------------------------------------------------------------------
 // Optimize a statement
 unique_ptr<ASTNode> ASTOptimizerDeadCode::visit(ASTStatement& astStatement) {
     unique_ptr<ASTNode> expr = astStatement.releaseInput();
     expr->optimize(*this, expr);
-    return make_unique<ASTStatement>(move(expr));
+    return allocateNode<ASTStatement>(resource, move(expr), astStatement.getSourceIndex());
 }
 //---------------------------------------------------------------------------
 // Optimize an assignment
 unique_ptr<ASTNode> ASTOptimizerDeadCode::visit(AssignmentExpr& assignmentExpr) {
-    return make_unique<AssignmentExpr>(move(assignmentExpr));
+    return allocateNode<AssignmentExpr>(resource, move(assignmentExpr));
 }
 //---------------------------------------------------------------------------
 // Optimize a return statement
 unique_ptr<ASTNode> ASTOptimizerDeadCode::visit(ReturnExpr& returnExpr) {
     countReturnStatement++;
-    return make_unique<ReturnExpr>(move(returnExpr));
+    return allocateNode<ReturnExpr>(resource, move(returnExpr));
 }
 //---------------------------------------------------------------------------
 // Optimize a multiplication
 unique_ptr<ASTNode> ASTOptimizerDeadCode::visit(MulExpr& mulExpr) {
-    return make_unique<MulExpr>(move(mulExpr));
+    return allocateNode<MulExpr>(resource, move(mulExpr));
 }
 //---------------------------------------------------------------------------
 // Optimize a division
 unique_ptr<ASTNode> ASTOptimizerDeadCode::visit(DivExpr& divExpr) {
-    return make_unique<DivExpr>(move(divExpr));
+    return allocateNode<DivExpr>(resource, move(divExpr));
 }
 //---------------------------------------------------------------------------
 // Optimize an addition
 unique_ptr<ASTNode> ASTOptimizerDeadCode::visit(AddExpr& addExpr) {
-    return make_unique<AddExpr>(move(addExpr));
+    return allocateNode<AddExpr>(resource, move(addExpr));
 }
 //---------------------------------------------------------------------------
 // Optimize a subtraction
 unique_ptr<ASTNode> ASTOptimizerDeadCode::visit(SubtractExpr& subtractExpr) {
-    return make_unique<SubtractExpr>(move(subtractExpr));
+    return allocateNode<SubtractExpr>(resource, move(subtractExpr));
 }
 //---------------------------------------------------------------------------
 // Optimize a unary plus
 unique_ptr<ASTNode> ASTOptimizerDeadCode::visit(UnaryPlus& unaryPlus) {
-    return make_unique<UnaryPlus>(move(unaryPlus));
+    return allocateNode<UnaryPlus>(resource, move(unaryPlus));
 }
 //---------------------------------------------------------------------------
 // Optimize a unary minus
 unique_ptr<ASTNode> ASTOptimizerDeadCode::visit(UnaryMinus& unaryMinus) {
-    return make_unique<UnaryMinus>(move(unaryMinus));
+    return allocateNode<UnaryMinus>(resource, move(unaryMinus));
 }
 //---------------------------------------------------------------------------
 } // namespace pljit::ast
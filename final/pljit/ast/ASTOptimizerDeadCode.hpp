@@ -6,8 +6,8 @@ namespace pljit::ast {
 //---------------------------------------------------------------------------
 /// Struct that represents the dead code elimination (MILESTONE 5)
 struct ASTOptimizerDeadCode : ASTOptimizer {
-    /// Constructor
-    ASTOptimizerDeadCode() = default;
+    /// Constructor, the optimized nodes are allocated from the memory resource
+    explicit ASTOptimizerDeadCode(pmr::memory_resource* resource = pmr::get_default_resource()) : resource(resource) {}
     /// Destructor
     ~ASTOptimizerDeadCode() override = default;
     /// Visit functions for each node type
@@ -25,6 +25,8 @@ struct ASTOptimizerDeadCode : ASTOptimizer {
     unique_ptr<ASTNode> visit(UnaryMinus&) override;
 
     private:
+    /// Storage of the memory resource of the nodes
+    pmr::memory_resource* resource;
     /// Storage of how many return statements were visited so far
     size_t countReturnStatement = 0;
 };
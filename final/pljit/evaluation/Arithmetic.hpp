@@ -0,0 +1,68 @@
+#ifndef H_PLJIT_ARITHMETIC
+#define H_PLJIT_ARITHMETIC
+#include <cstdint>
+#include <limits>
+using namespace std;
+//---------------------------------------------------------------------------
+namespace pljit::evaluation {
+//---------------------------------------------------------------------------
+/// All ways to handle a result that does not fit into an int64_t
+enum class ArithmeticMode : uint8_t {
+    /// The result wraps around in two's complement
+    Wrapping,
+    /// The evaluation fails with an overflow error at the end of the statement
+    Trapping,
+    /// The result is clamped to the smallest or largest value
+    Saturating
+};
+/// Struct that represents the result of a checked operation
+struct CheckedResult {
+    /// The wrapped result
+    int64_t value;
+    /// The clamped result, it is only meaningful if the operation overflowed
+    int64_t saturated;
+    /// Whether the result does not fit
+    bool overflow;
+    /// Return the result in the given mode, it does not branch on the mode or the overflow
+    int64_t get(bool saturating) const { return (overflow & saturating) ? saturated : value; }
+};
+/// Checked operations, they compute the wrapped and the clamped result without a branch
+/// The sign of the clamped result is the sign of the exact result.
+inline CheckedResult checkedAdd(int64_t left, int64_t right) {
+    CheckedResult result;
+    result.overflow = __builtin_add_overflow(left, right, &result.value);
+    result.saturated = (left >> 63) ^ numeric_limits<int64_t>::max();
+    return result;
+}
+inline CheckedResult checkedSubtract(int64_t left, int64_t right) {
+    CheckedResult result;
+    result.overflow = __builtin_sub_overflow(left, right, &result.value);
+    result.saturated = (left >> 63) ^ numeric_limits<int64_t>::max();
+    return result;
+}
+inline CheckedResult checkedMul(int64_t left, int64_t right) {
+    CheckedResult result;
+    result.overflow = __builtin_mul_overflow(left, right, &result.value);
+    result.saturated = ((left ^ right) >> 63) ^ numeric_limits<int64_t>::max();
+    return result;
+}
+inline CheckedResult checkedNegate(int64_t value) {
+    CheckedResult result;
+    result.overflow = __builtin_sub_overflow(int64_t(0), value, &result.value);
+    result.saturated = numeric_limits<int64_t>::max();
+    return result;
+}
+/// The divisor must not be 0, the smallest value divided by -1 is the only division that overflows
+inline CheckedResult checkedDiv(int64_t left, int64_t right) {
+    CheckedResult result;
+    result.overflow = (left == numeric_limits<int64_t>::min()) & (right == -1);
+    // The overflowing division is replaced by a division by 1, which yields the wrapped result
+    result.value = left / (result.overflow ? 1 : right);
+    result.saturated = numeric_limits<int64_t>::max();
+    return result;
+}
+//---------------------------------------------------------------------------
+} // namespace pljit::evaluation
+//---------------------------------------------------------------------------
+#endif // H_PLJIT_ARITHMETIC
+//---------------------------------------------------------------------------
@@ -19,7 +19,43 @@ void EvaluationContext::setReturnValue(int64_t value) {
 //---------------------------------------------------------------------------
 // Runtime error
 void EvaluationContext::errorDivisionByZero() {
-    cerr << "runtime error : division by zero" << endl;
+    if (profile) {
+        profile->recordZeroDivisor(currentStatement);
+    }
+    if (reportErrors) {
+        cerr << "runtime error : division by zero" << endl;
+    }
+}
+//---------------------------------------------------------------------------
+// Set the fuel of every evaluation
+void EvaluationContext::setFuel(uint64_t fuel1) {
+    fuel = fuel1 == 0 ? numeric_limits<uint64_t>::max() : fuel1;
+    remainingFuel = fuel;
+}
+//---------------------------------------------------------------------------
+// Runtime error, the evaluation ran out of fuel
+void EvaluationContext::errorFuelExhausted() {
+    setError();
+    exhausted = true;
+    if (reportErrors) {
+        cerr << "runtime error : fuel exhausted" << endl;
+    }
+}
+//---------------------------------------------------------------------------
+// Set how an overflow is handled
+void EvaluationContext::setArithmeticMode(ArithmeticMode mode) {
+    arithmeticMode = mode;
+    saturating = mode == ArithmeticMode::Saturating;
+    trapping = mode == ArithmeticMode::Trapping;
+}
+//---------------------------------------------------------------------------
+// Runtime error, an operation overflowed in the trapping mode
+void EvaluationContext::errorOverflow() {
+    setError();
+    overflowed = true;
+    if (reportErrors) {
+        cerr << "runtime error : arithmetic overflow" << endl;
+    }
 }
 //---------------------------------------------------------------------------
 // Indicate that an error occurred
@@ -38,8 +74,19 @@ int64_t EvaluationContext::getReturnValue() const {
 }
 //---------------------------------------------------------------------------
 // Constructor
-EvaluationContext::EvaluationContext(OptimizationTable& optimizationTable1, const vector<int64_t>& parameters) : optimizationTable(optimizationTable1) {
+EvaluationContext::EvaluationContext(const OptimizationTable& optimizationTable1, span<const int64_t> parameters) : optimizationTable(optimizationTable1) {
+    optimizationTable.setParameterValues(parameters);
+}
+//---------------------------------------------------------------------------
+// Prepare the context for the next evaluation
+void EvaluationContext::reset(span<const int64_t> parameters) {
     optimizationTable.setParameterValues(parameters);
+    returnValue = 0;
+    error = false;
+    remainingFuel = fuel;
+    exhausted = false;
+    overflow = false;
+    overflowed = false;
 }
 //---------------------------------------------------------------------------
 } // namespace pljit::evaluation
@@ -1,6 +1,9 @@
 #ifndef H_PLJIT_EVALUATIONCONTEXT
 #define H_PLJIT_EVALUATIONCONTEXT
+#include "pljit/evaluation/Arithmetic.hpp"
+#include "pljit/evaluation/ExecutionProfile.hpp"
 #include "pljit/evaluation/OptimizationTable.hpp"
+#include <limits>
 //---------------------------------------------------------------------------
 namespace pljit::evaluation {
 //---------------------------------------------------------------------------
@@ -8,16 +11,56 @@ namespace pljit::evaluation {
 class EvaluationContext {
     public:
     /// Constructors
-    explicit EvaluationContext(OptimizationTable& optimizationTable) : optimizationTable(optimizationTable) {}
-    EvaluationContext(OptimizationTable& optimizationTable1, const vector<int64_t>& parameters);
+    explicit EvaluationContext(const OptimizationTable& optimizationTable) : optimizationTable(optimizationTable) {}
+    EvaluationContext(const OptimizationTable& optimizationTable1, span<const int64_t> parameters);
+    /// Prepare the context for the next evaluation with other parameters, the symbol table is reused
+    void reset(span<const int64_t> parameters);
     /// Get the value of a constant
     int64_t getValue(string_view name) const;
     /// Set the value of a constant
     void setValue(string_view name, int64_t val);
     /// Set the return value of a program
     void setReturnValue(int64_t value);
-    /// Runtime error
+    /// Runtime error, it is counted for the current statement if a profile is recorded
     void errorDivisionByZero();
+    /// Set the fuel of every evaluation, 0 for no limit
+    void setFuel(uint64_t fuel1);
+    /// Consume the fuel of a statement, returns false and sets the error if not enough is left
+    bool consumeFuel(uint64_t cost) {
+        if (cost <= remainingFuel) {
+            remainingFuel -= cost;
+            return true;
+        }
+        errorFuelExhausted();
+        return false;
+    }
+    /// Return whether the evaluation was aborted because the fuel was exhausted
+    bool fuelExhausted() const { return exhausted; }
+    /// Set how an overflow is handled
+    void setArithmeticMode(ArithmeticMode mode);
+    ArithmeticMode getArithmeticMode() const { return arithmeticMode; }
+    /// Return the result of a checked operation in the arithmetic mode, an overflow is only remembered until checkOverflow
+    int64_t apply(const CheckedResult& result) {
+        overflow |= result.overflow;
+        return result.get(saturating);
+    }
+    /// Report an overflow of the current statement in the trapping mode, returns false and sets the error if there was one
+    bool checkOverflow() {
+        if (!(overflow & trapping)) {
+            return true;
+        }
+        errorOverflow();
+        return false;
+    }
+    /// Return whether the evaluation was aborted because of an overflow
+    bool overflowOccurred() const { return overflowed; }
+    /// Set whether the runtime errors are reported on stderr, the rows of a batch are only counted
+    void setReportErrors(bool reportErrors1) { reportErrors = reportErrors1; }
+    /// Record the execution in a profile, nullptr stops recording
+    void setProfile(ExecutionProfile* profile1) { profile = profile1; }
+    ExecutionProfile* getProfile() const { return profile; }
+    /// Set the number of the statement that is executed
+    void setCurrentStatement(size_t statement) { currentStatement = statement; }
     /// Set the error
     void setError();
     /// Return whether an error occurred
@@ -32,6 +75,28 @@ class EvaluationContext {
     int64_t returnValue = 0;
     /// Storage of the error
     bool error = false;
+    /// Storage of whether the runtime errors are reported on stderr
+    bool reportErrors = true;
+    /// Storage of the recorded profile, nullptr if no profile is recorded
+    ExecutionProfile* profile = nullptr;
+    /// Storage of the number of the executed statement
+    size_t currentStatement = 0;
+    /// Storage of the fuel of every evaluation and the fuel that is left in the current one
+    uint64_t fuel = numeric_limits<uint64_t>::max();
+    uint64_t remainingFuel = numeric_limits<uint64_t>::max();
+    /// Storage of whether the fuel was exhausted
+    bool exhausted = false;
+    /// Storage of the arithmetic mode and whether it saturates or traps
+    ArithmeticMode arithmeticMode = ArithmeticMode::Wrapping;
+    bool saturating = false;
+    bool trapping = false;
+    /// Storage of whether an operation overflowed and whether the evaluation was aborted because of it
+    bool overflow = false;
+    bool overflowed = false;
+    /// Runtime error, the evaluation ran out of fuel
+    void errorFuelExhausted();
+    /// Runtime error, an operation overflowed in the trapping mode
+    void errorOverflow();
 };
 //---------------------------------------------------------------------------
 } // namespace pljit::evaluation
@@ -0,0 +1,165 @@
+#include "pljit/evaluation/ExecutionProfile.hpp"
+#include <algorithm>
+#include <fstream>
+//---------------------------------------------------------------------------
+namespace pljit::evaluation {
+//---------------------------------------------------------------------------
+// Record a call with its parameters
+void ExecutionProfile::recordCall(span<const int64_t> parameters) {
+    calls++;
+    for (size_t i = 0; i < parameters.size(); i++) {
+        countValue(i, parameters[i], 1);
+    }
+}
+//---------------------------------------------------------------------------
+// Record the time of a statement
+void ExecutionProfile::recordStatement(size_t statement, chrono::nanoseconds time, bool countExecution) {
+    if (statement >= statements.size()) {
+        statements.resize(statement + 1);
+    }
+    statements[statement].executions += countExecution;
+    statements[statement].time += time;
+}
+//---------------------------------------------------------------------------
+// Record a division by zero in a statement
+void ExecutionProfile::recordZeroDivisor(size_t statement) {
+    if (statement >= statements.size()) {
+        statements.resize(statement + 1);
+    }
+    statements[statement].zeroDivisors++;
+}
+//---------------------------------------------------------------------------
+// Count a value of a parameter
+void ExecutionProfile::countValue(size_t parameterPos, int64_t value, uint64_t count) {
+    if (parameterPos >= parameterValues.size()) {
+        parameterValues.resize(parameterPos + 1);
+    }
+    map<int64_t, uint64_t>& values = parameterValues[parameterPos];
+    auto it = values.find(value);
+    if (it != values.end()) {
+        it->second += count;
+    } else if (values.size() < maxTrackedValues) {
+        values.emplace(value, count);
+    } else {
+        // The new value replaces the least counted one and takes over its count (space-saving), so a frequent value that occurs late is still tracked
+        auto minimum = min_element(values.begin(), values.end(), [](const pair<const int64_t, uint64_t>& left, const pair<const int64_t, uint64_t>& right) {
+            return left.second < right.second;
+        });
+        uint64_t inherited = minimum->second;
+        values.erase(minimum);
+        values.emplace(value, inherited + count);
+    }
+}
+//---------------------------------------------------------------------------
+// Add the measurements of another profile
+void ExecutionProfile::merge(const ExecutionProfile& other) {
+    calls += other.calls;
+    if (other.statements.size() > statements.size()) {
+        statements.resize(other.statements.size());
+    }
+    for (size_t i = 0; i < other.statements.size(); i++) {
+        statements[i].executions += other.statements[i].executions;
+        statements[i].time += other.statements[i].time;
+        statements[i].zeroDivisors += other.statements[i].zeroDivisors;
+    }
+    for (size_t i = 0; i < other.parameterValues.size(); i++) {
+        for (const auto& [value, count] : other.parameterValues[i]) {
+            countValue(i, value, count);
+        }
+    }
+}
+//---------------------------------------------------------------------------
+// Return the most frequent value of a parameter
+optional<int64_t> ExecutionProfile::getDominantValue(size_t parameterPos, double minShare) const {
+    if (calls == 0 || parameterPos >= parameterValues.size()) {
+        return nullopt;
+    }
+
+    optional<pair<int64_t, uint64_t>> best;
+    for (const auto& [value, count] : parameterValues[parameterPos]) {
+        if (!best || count > best->second) {
+            best = {value, count};
+        }
+    }
+    if (!best || static_cast<double>(best->second) < minShare * static_cast<double>(calls)) {
+        return nullopt;
+    }
+    return best->first;
+}
+//---------------------------------------------------------------------------
+// Write the profile in its text format
+void ExecutionProfile::write(ostream& out) const {
+    out << "pljit-profile 1\n";
+    out << "calls " << calls << "\n";
+    for (size_t i = 0; i < statements.size(); i++) {
+        out << "statement " << i << " " << statements[i].executions << " " << statements[i].time.count() << " " << statements[i].zeroDivisors << "\n";
+    }
+    for (size_t i = 0; i < parameterValues.size(); i++) {
+        for (const auto& [value, count] : parameterValues[i]) {
+            out << "parameter " << i << " " << value << " " << count << "\n";
+        }
+    }
+}
+//---------------------------------------------------------------------------
+// Read a profile in its text format
+optional<ExecutionProfile> ExecutionProfile::read(istream& in) {
+    string header;
+    int version = 0;
+    if (!(in >> header >> version) || header != "pljit-profile" || version != 1) {
+        return nullopt;
+    }
+
+    ExecutionProfile profile;
+    for (string kind; in >> kind;) {
+        if (kind == "calls") {
+            if (!(in >> profile.calls)) {
+                return nullopt;
+            }
+        } else if (kind == "statement") {
+            size_t statement = 0;
+            StatementProfile statementProfile;
+            int64_t nanoseconds = 0;
+            if (!(in >> statement >> statementProfile.executions >> nanoseconds >> statementProfile.zeroDivisors) || statement >= maxPosition) {
+                return nullopt;
+            }
+            statementProfile.time = chrono::nanoseconds(nanoseconds);
+            if (statement >= profile.statements.size()) {
+                profile.statements.resize(statement + 1);
+            }
+            profile.statements[statement] = statementProfile;
+        } else if (kind == "parameter") {
+            size_t parameterPos = 0;
+            int64_t value = 0;
+            uint64_t count = 0;
+            if (!(in >> parameterPos >> value >> count) || parameterPos >= maxPosition) {
+                return nullopt;
+            }
+            profile.countValue(parameterPos, value, count);
+        } else {
+            return nullopt;
+        }
+    }
+    return profile;
+}
+//---------------------------------------------------------------------------
+// Write the profile to a file
+bool ExecutionProfile::save(const string& path) const {
+    ofstream out(path);
+    if (!out) {
+        return false;
+    }
+    write(out);
+    return static_cast<bool>(out);
+}
+//---------------------------------------------------------------------------
+// Read a profile from a file
+optional<ExecutionProfile> ExecutionProfile::load(const string& path) {
+    ifstream in(path);
+    if (!in) {
+        return nullopt;
+    }
+    return read(in);
+}
+//---------------------------------------------------------------------------
+} // namespace pljit::evaluation
+//---------------------------------------------------------------------------
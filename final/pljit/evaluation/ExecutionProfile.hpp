@@ -0,0 +1,72 @@
+#ifndef H_PLJIT_EXECUTIONPROFILE
+#define H_PLJIT_EXECUTIONPROFILE
+#include <chrono>
+#include <cstdint>
+#include <istream>
+#include <map>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <string>
+#include <vector>
+using namespace std;
+//---------------------------------------------------------------------------
+namespace pljit::evaluation {
+//---------------------------------------------------------------------------
+/// Struct that represents the measurements of one statement
+struct StatementProfile {
+    /// Number of times the statement was executed
+    uint64_t executions = 0;
+    /// Accumulated time spent in the statement
+    chrono::nanoseconds time{0};
+    /// Number of divisions by zero in the statement
+    uint64_t zeroDivisors = 0;
+};
+/// Class that represents the execution profile of a function, the statements are numbered as in the code, so the profiles of all optimization levels agree
+class ExecutionProfile {
+    public:
+    /// Constructor
+    ExecutionProfile() = default;
+    /// Record a call with its parameters
+    void recordCall(span<const int64_t> parameters);
+    /// Record the time of a statement, it only counts as an execution if countExecution is set
+    /// An optimization may split a statement of the code into several, only the first of them counts.
+    void recordStatement(size_t statement, chrono::nanoseconds time, bool countExecution = true);
+    /// Record a division by zero in a statement
+    void recordZeroDivisor(size_t statement);
+    /// Add the measurements of another profile
+    void merge(const ExecutionProfile& other);
+    /// Return the most frequent value of a parameter if it occurred in at least the given share of the calls
+    optional<int64_t> getDominantValue(size_t parameterPos, double minShare) const;
+    /// Getters
+    uint64_t getCalls() const { return calls; }
+    const vector<StatementProfile>& getStatements() const { return statements; }
+    /// Write the profile in its text format
+    void write(ostream& out) const;
+    /// Read a profile in its text format, returns nullopt if it is malformed
+    static optional<ExecutionProfile> read(istream& in);
+    /// Write the profile to a file, returns false if it cannot be written
+    bool save(const string& path) const;
+    /// Read a profile from a file, returns nullopt if it cannot be read
+    static optional<ExecutionProfile> load(const string& path);
+    /// Maximum number of distinct values that are counted per parameter, a new value replaces the least counted one and takes over its count
+    /// The count of a value may therefore be overestimated by at most the count of the least counted value.
+    static constexpr size_t maxTrackedValues = 16;
+    /// Maximum statement and parameter position accepted when reading a profile
+    static constexpr size_t maxPosition = 1 << 20;
+
+    private:
+    /// Count a value of a parameter
+    void countValue(size_t parameterPos, int64_t value, uint64_t count);
+    /// Storage of the number of calls
+    uint64_t calls = 0;
+    /// Storage of the measurements of the statements
+    vector<StatementProfile> statements;
+    /// Storage of the counted values of every parameter
+    vector<map<int64_t, uint64_t>> parameterValues;
+};
+//---------------------------------------------------------------------------
+} // namespace pljit::evaluation
+//---------------------------------------------------------------------------
+#endif // H_PLJIT_EXECUTIONPROFILE
+//---------------------------------------------------------------------------
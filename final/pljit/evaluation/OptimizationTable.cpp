@@ -1,4 +1,5 @@
 #include "pljit/evaluation/OptimizationTable.hpp"
+#include <algorithm>
 //---------------------------------------------------------------------------
 namespace pljit::evaluation {
 //---------------------------------------------------------------------------
@@ -21,10 +22,21 @@ void OptimizationTable::setConstant(string_view name, bool set) {
 }
 //---------------------------------------------------------------------------
 // Set the parameter values for the respective symbols
-void OptimizationTable::setParameterValues(const vector<int64_t>& parameters) {
-    for (auto symbol : optimizationTable) {
+void OptimizationTable::setParameterValues(span<const int64_t> parameters) {
+    for (auto& symbol : optimizationTable) {
         if (static_cast<int>(symbol.second.parameterPos) != -1) {
-            setValue(symbol.first, parameters[symbol.second.parameterPos]);
+            symbol.second.value = parameters[symbol.second.parameterPos];
+        }
+    }
+}
+//---------------------------------------------------------------------------
+// Bind a parameter to a constant value, it is no longer read from the parameter list
+void OptimizationTable::bindParameter(size_t parameterPos, int64_t val) {
+    for (auto& symbol : optimizationTable) {
+        if (symbol.second.parameterPos == parameterPos) {
+            symbol.second.value = val;
+            symbol.second.isConstant = true;
+            symbol.second.parameterPos = -1;
         }
     }
 }
@@ -35,5 +47,42 @@ bool OptimizationTable::isConstant(string_view name) const {
     return symbolIterator->second.isConstant;
 }
 //---------------------------------------------------------------------------
+// Return the number of parameters
+size_t OptimizationTable::getParameterCount() const {
+    size_t count = 0;
+    for (const auto& symbol : optimizationTable) {
+        if (static_cast<int>(symbol.second.parameterPos) != -1) {
+            count++;
+        }
+    }
+    return count;
+}
+//---------------------------------------------------------------------------
+// Return the number of values a call has to provide
+size_t OptimizationTable::getParameterSlots() const {
+    size_t slots = 0;
+    for (const auto& symbol : optimizationTable) {
+        if (static_cast<int>(symbol.second.parameterPos) != -1) {
+            slots = max(slots, symbol.second.parameterPos + 1);
+        }
+    }
+    return slots;
+}
+//---------------------------------------------------------------------------
+// Return the names of the parameters ordered by their position, bound parameters leave an empty name
+vector<string_view> OptimizationTable::getParameters() const {
+    vector<string_view> parameters;
+    for (const auto& symbol : optimizationTable) {
+        size_t parameterPos = symbol.second.parameterPos;
+        if (static_cast<int>(parameterPos) != -1) {
+            if (parameters.size() <= parameterPos) {
+                parameters.resize(parameterPos + 1);
+            }
+            parameters[parameterPos] = symbol.first;
+        }
+    }
+    return parameters;
+}
+//---------------------------------------------------------------------------
 } // namespace pljit::evaluation
 //---------------------------------------------------------------------------
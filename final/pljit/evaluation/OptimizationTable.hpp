@@ -1,29 +1,41 @@
 #ifndef H_PLJIT_OPTIMIZATIONTABLE
 #define H_PLJIT_OPTIMIZATIONTABLE
 #include "pljit/evaluation/SymbolTable.hpp"
+#include <span>
 //---------------------------------------------------------------------------
 namespace pljit::evaluation {
 //---------------------------------------------------------------------------
 /// A symbol table class for the constant propagation pass and evaluation context (MILESTONE 5)
 class OptimizationTable {
     public:
-    /// Constructors
+    /// Constructors, the table keeps the memory resource of the symbol table
+    /// A copy, e.g. the one of an evaluation context, uses the default memory resource, so it may be used by another thread.
     OptimizationTable() = default;
     explicit OptimizationTable(SymbolTable symbolTable) : optimizationTable(move(symbolTable.symbolTable)) {}
+    /// Copy a table into a memory resource, e.g. the one of the optimized ast
+    OptimizationTable(const OptimizationTable& other, pmr::memory_resource* resource) : optimizationTable(other.optimizationTable, resource) {}
     /// Get the value of a symbol
     int64_t getValue(string_view name) const;
     /// Set the value of a symbol
     void setValue(string_view name, int64_t val);
     /// Mark the symbol as constant
     void setConstant(string_view name, bool set);
-    /// Set the values of the parameters
-    void setParameterValues(const vector<int64_t>& parameters);
+    /// Set the values of the parameters, the caller guarantees that there is a value for every parameter position
+    void setParameterValues(span<const int64_t> parameters);
+    /// Bind the parameter at the given position to a constant value
+    void bindParameter(size_t parameterPos, int64_t val);
     /// Check whether the symbol is a constant
     bool isConstant(string_view name) const;
+    /// Return the number of parameters
+    size_t getParameterCount() const;
+    /// Return the number of values a call has to provide, bound parameters keep their position
+    size_t getParameterSlots() const;
+    /// Return the names of the parameters ordered by their position
+    vector<string_view> getParameters() const;
 
     private:
     /// Storage of the table
-    unordered_map<string_view, Symbol> optimizationTable;
+    pmr::unordered_map<string_view, Symbol> optimizationTable;
 };
 //---------------------------------------------------------------------------
 } // namespace pljit::evaluation
@@ -1,6 +1,8 @@
 #ifndef H_PLJIT_SYMBOLTABLE
 #define H_PLJIT_SYMBOLTABLE
 #include "pljit/evaluation/Symbol.hpp"
+#include <memory_resource>
+#include <optional>
 #include <unordered_map>
 #include <vector>
 //---------------------------------------------------------------------------
@@ -11,8 +13,14 @@ class SymbolTable {
     friend class OptimizationTable;
 
     public:
-    /// Constructor
+    /// Constructors
     SymbolTable() = default;
+    explicit SymbolTable(pmr::memory_resource* resource) : symbolTable(resource) {}
+    /// A copy keeps the memory resource of the table, it is only used during the semantic analysis
+    SymbolTable(const SymbolTable& other) : symbolTable(other.symbolTable, other.symbolTable.get_allocator()) {}
+    SymbolTable(SymbolTable&&) = default;
+    SymbolTable& operator=(const SymbolTable&) = default;
+    SymbolTable& operator=(SymbolTable&&) = default;
     /// Insert a symbol in the table
     bool insert(string_view name, Reference ref, bool isConstant = false, bool isInitialized = true, int64_t value = 0, size_t parameterPos = -1);
     /// Initialize a symbol
@@ -28,7 +36,7 @@ class SymbolTable {
 
     private:
     /// Storage of the symboltable
-    unordered_map<string_view, Symbol> symbolTable;
+    pmr::unordered_map<string_view, Symbol> symbolTable;
 };
 //---------------------------------------------------------------------------
 } // namespace pljit::evaluation
@@ -0,0 +1,108 @@
+#include "pljit/ir/ASTBuilder.hpp"
+#include <array>
+#include <atomic>
+#include <bit>
+#include <string>
+//---------------------------------------------------------------------------
+namespace pljit::ir {
+//---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+// Number of names in the first chunk, every later chunk holds twice as many names as the one before
+constexpr size_t firstChunkSize = 64;
+// Storage of the chunks of names, a chunk is published once and never modified or released
+array<atomic<const string*>, 64> nameChunks{};
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+// Return the name of a temporary variable
+string_view ASTBuilder::getTemporaryName(size_t index) {
+    // The ast only stores views of the names, so they are kept for the lifetime of the program
+    // Chunk k starts at the name firstChunkSize * (2^k - 1), so the names of a chunk never move and need no lock
+    size_t chunk = bit_width(index / firstChunkSize + 1) - 1;
+    size_t chunkBegin = firstChunkSize * ((size_t(1) << chunk) - 1);
+    const string* names = nameChunks[chunk].load(memory_order_acquire);
+    if (!names) {
+        size_t chunkSize = firstChunkSize << chunk;
+        auto created = make_unique<string[]>(chunkSize);
+        for (size_t i = 0; i < chunkSize; i++) {
+            created[i].push_back('$');
+            created[i].append(to_string(chunkBegin + i));
+        }
+        // A concurrent builder may have published the chunk first, its names are used then
+        if (nameChunks[chunk].compare_exchange_strong(names, created.get(), memory_order_acq_rel)) {
+            names = created.release();
+        }
+    }
+    return names[index - chunkBegin];
+}
+//---------------------------------------------------------------------------
+// Build the expression that computes a value
+unique_ptr<ASTNode> ASTBuilder::buildExpression(ValueId value, bool inlineValue) {
+    const Instruction& instruction = (*irFunction)[value];
+    const auto [left, right] = instruction.operands;
+
+    if (!inlineValue && !temporaries[value].empty()) {
+        return allocateNode<Parameter>(resource, temporaries[value]);
+    }
+
+    switch (instruction.opcode) {
+        case Instruction::Opcode::Constant: return allocateNode<Constant>(resource, instruction.value);
+        case Instruction::Opcode::Parameter: return allocateNode<Parameter>(resource, instruction.name);
+        case Instruction::Opcode::Add: return allocateNode<AddExpr>(resource, buildExpression(left), buildExpression(right));
+        case Instruction::Opcode::Subtract: return allocateNode<SubtractExpr>(resource, buildExpression(left), buildExpression(right));
+        case Instruction::Opcode::Mul: return allocateNode<MulExpr>(resource, buildExpression(left), buildExpression(right));
+        case Instruction::Opcode::Div: return allocateNode<DivExpr>(resource, buildExpression(left), buildExpression(right));
+        case Instruction::Opcode::Negate: return allocateNode<UnaryMinus>(resource, buildExpression(left));
+        default: return nullptr;
+    }
+}
+//---------------------------------------------------------------------------
+// Build the ast
+unique_ptr<ASTNode> ASTBuilder::build(IRFunction& irFunction1) {
+    irFunction = &irFunction1;
+    irFunction1.computeUsers();
+    const auto& instructions = irFunction1.getInstructions();
+
+    SymbolTable symbolTable(resource);
+    const auto& parameters = irFunction1.getParameters();
+    for (size_t i = 0; i < parameters.size(); i++) {
+        if (!parameters[i].empty()) {
+            symbolTable.insert(parameters[i], Reference(), false, true, 0, i);
+        }
+    }
+
+    temporaries.assign(instructions.size(), string_view());
+    size_t temporaryCount = 0;
+    vector<unique_ptr<ASTNode>> statements;
+
+    for (size_t i = 0; i < instructions.size(); i++) {
+        const Instruction& instruction = instructions[i];
+        auto valueId = static_cast<ValueId>(i);
+
+        if (instruction.opcode == Instruction::Opcode::Return) {
+            statements.push_back(allocateNode<ASTStatement>(resource, allocateNode<ReturnExpr>(resource, buildExpression(instruction.operands[0])), instruction.sourceStatement));
+            break;
+        }
+
+        bool leaf = instruction.operandCount() == 0;
+        bool shared = irFunction1.getUsers(valueId).size() > 1;
+        bool unused = irFunction1.getUsers(valueId).empty();
+        if (instruction.opcode == Instruction::Opcode::Nop || leaf || !(shared || unused || instruction.mayTrap(instructions, arithmeticMode))) {
+            continue;
+        }
+
+        // Values that are used several times or may fail are computed once in their own statement
+        string_view name = getTemporaryName(temporaryCount++);
+        symbolTable.insert(name, Reference());
+        auto assignment = allocateNode<AssignmentExpr>(resource, allocateNode<Parameter>(resource, name), buildExpression(valueId, true), name);
+        statements.push_back(allocateNode<ASTStatement>(resource, move(assignment), instruction.sourceStatement));
+        temporaries[i] = name;
+    }
+
+    irFunction = nullptr;
+    return allocateNode<Function>(resource, move(statements), OptimizationTable(move(symbolTable)));
+}
+//---------------------------------------------------------------------------
+} // namespace pljit::ir
+//---------------------------------------------------------------------------
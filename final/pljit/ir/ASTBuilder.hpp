@@ -0,0 +1,35 @@
+#ifndef H_PLJIT_ASTBUILDER
+#define H_PLJIT_ASTBUILDER
+#include "pljit/ast/AST.hpp"
+#include "pljit/ir/IR.hpp"
+using namespace pljit::ast;
+//---------------------------------------------------------------------------
+namespace pljit::ir {
+//---------------------------------------------------------------------------
+/// Class that lowers a function in ssa form back to an ast that can be evaluated by the interpreter
+class ASTBuilder {
+    public:
+    /// Constructor, values that overflow in the trapping mode may fail as well, the nodes are allocated from the memory resource
+    explicit ASTBuilder(ArithmeticMode arithmeticMode = ArithmeticMode::Wrapping, pmr::memory_resource* resource = pmr::get_default_resource()) : arithmeticMode(arithmeticMode), resource(resource) {}
+    /// Build the ast, values that are used several times or may fail are assigned to temporary variables
+    unique_ptr<ASTNode> build(IRFunction& irFunction);
+    /// Return the name of a temporary variable, the names live until the end of the program and are found without a lock
+    static string_view getTemporaryName(size_t index);
+
+    private:
+    /// Build the expression that computes a value
+    unique_ptr<ASTNode> buildExpression(ValueId value, bool inlineValue = false);
+    /// Storage of the function that is lowered
+    const IRFunction* irFunction = nullptr;
+    /// Storage of the temporary variable of every value, empty if the value is computed inline
+    vector<string_view> temporaries;
+    /// Storage of the arithmetic mode
+    ArithmeticMode arithmeticMode;
+    /// Storage of the memory resource of the nodes
+    pmr::memory_resource* resource;
+};
+//---------------------------------------------------------------------------
+} // namespace pljit::ir
+//---------------------------------------------------------------------------
+#endif // H_PLJIT_ASTBUILDER
+//---------------------------------------------------------------------------
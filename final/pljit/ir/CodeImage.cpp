@@ -0,0 +1,170 @@
+#include "pljit/ir/CodeImage.hpp"
+#include "pljit/ir/IRBuilder.hpp"
+#include <iostream>
+#include <optional>
+//---------------------------------------------------------------------------
+namespace pljit::ir {
+//---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+// Return the operation of an instruction, nullopt if the instruction occupies no operation
+optional<CodeImage::Opcode> lowerOpcode(Instruction::Opcode opcode) {
+    switch (opcode) {
+        case Instruction::Opcode::Add: return CodeImage::Opcode::Add;
+        case Instruction::Opcode::Subtract: return CodeImage::Opcode::Subtract;
+        case Instruction::Opcode::Mul: return CodeImage::Opcode::Mul;
+        case Instruction::Opcode::Div: return CodeImage::Opcode::Div;
+        case Instruction::Opcode::Negate: return CodeImage::Opcode::Negate;
+        case Instruction::Opcode::Return: return CodeImage::Opcode::Return;
+        case Instruction::Opcode::Constant:
+        case Instruction::Opcode::Parameter:
+        case Instruction::Opcode::Nop: return nullopt;
+    }
+    return nullopt;
+}
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+// Build the image of a function
+CodeImage CodeImage::build(const Function& function, ArithmeticMode arithmeticMode) {
+    IRBuilder irBuilder;
+    IRFunction irFunction = irBuilder.build(function);
+    const vector<Instruction>& instructions = irFunction.getInstructions();
+
+    CodeImage image;
+    image.parameterCount = static_cast<uint32_t>(irFunction.getParameters().size());
+    image.arithmeticMode = arithmeticMode;
+
+    // The constants are placed before the operations, so their slots are assigned first
+    vector<uint32_t> slots(instructions.size(), 0);
+    for (size_t i = 0; i < instructions.size(); i++) {
+        if (instructions[i].opcode == Instruction::Opcode::Parameter) {
+            slots[i] = static_cast<uint32_t>(instructions[i].value);
+        } else if (instructions[i].opcode == Instruction::Opcode::Constant) {
+            slots[i] = static_cast<uint32_t>(image.parameterCount + image.constants.size());
+            image.constants.push_back(instructions[i].value);
+        }
+    }
+
+    uint32_t firstResult = static_cast<uint32_t>(image.parameterCount + image.constants.size());
+    vector<uint32_t> operationsBefore(instructions.size() + 1, 0);
+    for (size_t i = 0; i < instructions.size(); i++) {
+        const Instruction& instruction = instructions[i];
+        if (optional<Opcode> opcode = lowerOpcode(instruction.opcode)) {
+            // A unary operation reads its operand twice, so it never reads an unused slot
+            const auto& [left, right] = instruction.operands;
+            slots[i] = firstResult + static_cast<uint32_t>(image.code.size());
+            image.code.push_back({*opcode, slots[left], slots[right == invalidValue ? left : right]});
+        }
+        operationsBefore[i + 1] = static_cast<uint32_t>(image.code.size());
+    }
+
+    // The fuel of a statement is consumed before its operations are executed
+    uint64_t fuel = 0;
+    const vector<size_t>& statementEnds = irBuilder.getStatementEnds();
+    for (size_t i = 0; i < statementEnds.size(); i++) {
+        fuel += function.getCost(i);
+        image.statements.emplace_back(operationsBefore[statementEnds[i]], fuel);
+    }
+
+    image.constants.shrink_to_fit();
+    image.code.shrink_to_fit();
+    image.statements.shrink_to_fit();
+    return image;
+}
+//---------------------------------------------------------------------------
+// Execute the image
+CodeImage::Status CodeImage::execute(span<const int64_t> parameters, uint64_t fuel, int64_t& result, bool reportErrors) const {
+    Status status;
+    if (fuel == 0 || statements.empty() || statements.back().second <= fuel) {
+        status = run(parameters, statements.size(), result);
+    } else {
+        // Only the statements whose fuel is left are executed, an error within them takes precedence
+        size_t statementCount = 0;
+        while (statements[statementCount].second <= fuel) {
+            statementCount++;
+        }
+        status = run(parameters, statementCount, result);
+        if (status == Status::Success) {
+            status = Status::FuelExhausted;
+        }
+    }
+
+    if (status != Status::Success && reportErrors) {
+        reportError(status);
+    }
+    return status;
+}
+//---------------------------------------------------------------------------
+// Execute the first statements
+CodeImage::Status CodeImage::run(span<const int64_t> parameters, size_t statementCount, int64_t& result) const {
+    // Small images keep their slots on the stack
+    constexpr size_t stackSlotCount = 64;
+    int64_t stackSlots[stackSlotCount];
+    vector<int64_t> heapSlots;
+    int64_t* slots = stackSlots;
+    if (getSlotCount() > stackSlotCount) {
+        heapSlots.resize(getSlotCount());
+        slots = heapSlots.data();
+    }
+    copy(parameters.begin(), parameters.begin() + parameterCount, slots);
+    copy(constants.begin(), constants.end(), slots + parameterCount);
+
+    int64_t* results = slots + parameterCount + constants.size();
+    bool saturating = arithmeticMode == ArithmeticMode::Saturating;
+    bool trapping = arithmeticMode == ArithmeticMode::Trapping;
+    result = 0;
+    size_t i = 0;
+    for (size_t statement = 0; statement < statementCount; statement++) {
+        // The operations only remember an overflow, it is checked once per statement like in the ast
+        bool overflow = false;
+        for (size_t end = statements[statement].first; i < end; i++) {
+            const Operation& operation = code[i];
+            int64_t left = slots[operation.left];
+            int64_t right = slots[operation.right];
+            CheckedResult checked;
+            switch (operation.opcode) {
+                case Opcode::Add: checked = checkedAdd(left, right); break;
+                case Opcode::Subtract: checked = checkedSubtract(left, right); break;
+                case Opcode::Mul: checked = checkedMul(left, right); break;
+                case Opcode::Div:
+                    if (right == 0) {
+                        return Status::DivisionByZero;
+                    }
+                    checked = checkedDiv(left, right);
+                    break;
+                case Opcode::Negate: checked = checkedNegate(left); break;
+                case Opcode::Return:
+                    if (overflow & trapping) {
+                        return Status::Overflow;
+                    }
+                    result = left;
+                    return Status::Success;
+            }
+            overflow |= checked.overflow;
+            results[i] = checked.get(saturating);
+        }
+        if (overflow & trapping) {
+            return Status::Overflow;
+        }
+    }
+    return Status::Success;
+}
+//---------------------------------------------------------------------------
+// Report a runtime error
+void CodeImage::reportError(Status status) {
+    switch (status) {
+        case Status::Success: return;
+        case Status::DivisionByZero: cerr << "runtime error : division by zero" << endl; return;
+        case Status::FuelExhausted: cerr << "runtime error : fuel exhausted" << endl; return;
+        case Status::Overflow: cerr << "runtime error : arithmetic overflow" << endl; return;
+    }
+}
+//---------------------------------------------------------------------------
+// Return the number of bytes the image occupies
+size_t CodeImage::getMemoryUsage() const {
+    return sizeof(CodeImage) + constants.capacity() * sizeof(int64_t) + code.capacity() * sizeof(Operation) + statements.capacity() * sizeof(pair<uint32_t, uint64_t>);
+}
+//---------------------------------------------------------------------------
+} // namespace pljit::ir
+//---------------------------------------------------------------------------
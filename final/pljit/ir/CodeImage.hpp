@@ -0,0 +1,72 @@
+#ifndef H_PLJIT_CODEIMAGE
+#define H_PLJIT_CODEIMAGE
+#include "pljit/ast/AST.hpp"
+#include <cstdint>
+#include <span>
+#include <vector>
+using namespace std;
+using namespace pljit::ast;
+//---------------------------------------------------------------------------
+namespace pljit::ir {
+//---------------------------------------------------------------------------
+/// Class that represents the immutable image of a compiled function, it refers to no names, symbols or source code
+/// The slots hold the parameters, then the constants, then the result of every operation in order.
+class CodeImage {
+    public:
+    /// All possible operations, every operation writes its result into its own slot
+    enum class Opcode : uint8_t {
+        Add,
+        Subtract,
+        Mul,
+        Div,
+        Negate,
+        Return
+    };
+    /// Struct that represents an operation, the operands are slots
+    struct Operation {
+        Opcode opcode;
+        uint32_t left;
+        uint32_t right;
+    };
+    /// All possible outcomes of an execution
+    enum class Status {
+        Success,
+        DivisionByZero,
+        FuelExhausted,
+        Overflow
+    };
+    /// Constructor
+    CodeImage() = default;
+    /// Build the image of a function, the fuel of its statements is kept, the operations are executed in the arithmetic mode
+    static CodeImage build(const Function& function, ArithmeticMode arithmeticMode = ArithmeticMode::Wrapping);
+    /// Execute the image, parameters needs a value for every parameter slot, 0 for no fuel limit
+    /// A runtime error is reported on stderr unless reportErrors is false, e.g. for the rows of a batch
+    Status execute(span<const int64_t> parameters, uint64_t fuel, int64_t& result, bool reportErrors = true) const;
+    /// Return the number of parameters the image reads
+    size_t getParameterCount() const { return parameterCount; }
+    /// Return the number of slots
+    size_t getSlotCount() const { return parameterCount + constants.size() + code.size(); }
+    /// Return the number of bytes the image occupies
+    size_t getMemoryUsage() const;
+
+    private:
+    /// Execute the first statements, an overflow is checked at the end of every statement
+    Status run(span<const int64_t> parameters, size_t statementCount, int64_t& result) const;
+    /// Report a runtime error
+    static void reportError(Status status);
+    /// Storage of the number of parameters
+    uint32_t parameterCount = 0;
+    /// Storage of the arithmetic mode
+    ArithmeticMode arithmeticMode = ArithmeticMode::Wrapping;
+    /// Storage of the constants
+    vector<int64_t> constants;
+    /// Storage of the operations
+    vector<Operation> code;
+    /// Storage of the number of operations at the end of every statement and the fuel that is consumed up to it
+    vector<pair<uint32_t, uint64_t>> statements;
+};
+//---------------------------------------------------------------------------
+} // namespace pljit::ir
+//---------------------------------------------------------------------------
+#endif // H_PLJIT_CODEIMAGE
+//---------------------------------------------------------------------------
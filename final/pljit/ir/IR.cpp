@@ -0,0 +1,137 @@
+#include "pljit/ir/IR.hpp"
+//---------------------------------------------------------------------------
+namespace pljit::ir {
+//---------------------------------------------------------------------------
+// Create a constant
+Instruction Instruction::constant(int64_t value) {
+    Instruction instruction;
+    instruction.opcode = Opcode::Constant;
+    instruction.value = value;
+    return instruction;
+}
+//---------------------------------------------------------------------------
+// Create a parameter
+Instruction Instruction::parameter(size_t position, string_view name) {
+    Instruction instruction;
+    instruction.opcode = Opcode::Parameter;
+    instruction.value = static_cast<int64_t>(position);
+    instruction.name = name;
+    return instruction;
+}
+//---------------------------------------------------------------------------
+// Return the number of operands of the instruction
+size_t Instruction::operandCount() const {
+    switch (opcode) {
+        case Opcode::Constant:
+        case Opcode::Parameter:
+        case Opcode::Nop:
+            return 0;
+        case Opcode::Negate:
+        case Opcode::Return:
+            return 1;
+        default:
+            return 2;
+    }
+}
+//---------------------------------------------------------------------------
+// Return whether the instruction is a division that may fail at runtime
+bool Instruction::mayTrap(const vector<Instruction>& instructions, evaluation::ArithmeticMode arithmeticMode) const {
+    bool trapping = arithmeticMode == evaluation::ArithmeticMode::Trapping;
+    switch (opcode) {
+        case Opcode::Add:
+        case Opcode::Subtract:
+        case Opcode::Mul:
+        case Opcode::Negate: return trapping;
+        case Opcode::Div: {
+            const Instruction& divisor = instructions[operands[1]];
+            return divisor.opcode != Opcode::Constant || divisor.value == 0 || (trapping && divisor.value == -1);
+        }
+        default: return false;
+    }
+}
+//---------------------------------------------------------------------------
+// Append an instruction
+ValueId IRFunction::append(Instruction instruction) {
+    instructions.push_back(instruction);
+    return static_cast<ValueId>(instructions.size() - 1);
+}
+//---------------------------------------------------------------------------
+// Build the def-use chains
+void IRFunction::computeUsers() {
+    users.assign(instructions.size(), {});
+    for (size_t i = 0; i < instructions.size(); i++) {
+        const Instruction& instruction = instructions[i];
+        for (size_t j = 0; j < instruction.operandCount(); j++) {
+            users[instruction.operands[j]].push_back(static_cast<ValueId>(i));
+        }
+    }
+}
+//---------------------------------------------------------------------------
+// Replace all uses of a value with another value
+void IRFunction::replaceAllUses(ValueId from, ValueId to) {
+    for (ValueId user : users[from]) {
+        Instruction& instruction = instructions[user];
+        for (size_t j = 0; j < instruction.operandCount(); j++) {
+            if (instruction.operands[j] == from) {
+                instruction.operands[j] = to;
+            }
+        }
+        users[to].push_back(user);
+    }
+    users[from].clear();
+}
+//---------------------------------------------------------------------------
+// Remove all Nop instructions and renumber the values
+void IRFunction::compact() {
+    vector<ValueId> renumbered(instructions.size(), invalidValue);
+    vector<Instruction> compacted;
+
+    for (size_t i = 0; i < instructions.size(); i++) {
+        Instruction instruction = instructions[i];
+        if (instruction.opcode == Instruction::Opcode::Nop) {
+            continue;
+        }
+        for (size_t j = 0; j < instruction.operandCount(); j++) {
+            instruction.operands[j] = renumbered[instruction.operands[j]];
+        }
+        renumbered[i] = static_cast<ValueId>(compacted.size());
+        compacted.push_back(instruction);
+    }
+
+    instructions = move(compacted);
+    users.clear();
+}
+//---------------------------------------------------------------------------
+// Return the number of instructions that are not Nop
+size_t IRFunction::size() const {
+    size_t count = 0;
+    for (const auto& instruction : instructions) {
+        if (instruction.opcode != Instruction::Opcode::Nop) {
+            count++;
+        }
+    }
+    return count;
+}
+//---------------------------------------------------------------------------
+// Print the function in a readable form
+void IRFunction::print(ostream& out) const {
+    for (size_t i = 0; i < instructions.size(); i++) {
+        const Instruction& instruction = instructions[i];
+        const auto& [left, right] = instruction.operands;
+
+        switch (instruction.opcode) {
+            case Instruction::Opcode::Constant: out << "%" << i << " = const " << instruction.value << "\n"; break;
+            case Instruction::Opcode::Parameter: out << "%" << i << " = param " << instruction.value << " " << instruction.name << "\n"; break;
+            case Instruction::Opcode::Add: out << "%" << i << " = add %" << left << ", %" << right << "\n"; break;
+            case Instruction::Opcode::Subtract: out << "%" << i << " = sub %" << left << ", %" << right << "\n"; break;
+            case Instruction::Opcode::Mul: out << "%" << i << " = mul %" << left << ", %" << right << "\n"; break;
+            case Instruction::Opcode::Div: out << "%" << i << " = div %" << left << ", %" << right << "\n"; break;
+            case Instruction::Opcode::Negate: out << "%" << i << " = neg %" << left << "\n"; break;
+            case Instruction::Opcode::Return: out << "return %" << left << "\n"; break;
+            case Instruction::Opcode::Nop: break;
+        }
+    }
+}
+//---------------------------------------------------------------------------
+} // namespace pljit::ir
+//---------------------------------------------------------------------------
@@ -0,0 +1,91 @@
+#ifndef H_PLJIT_IR
+#define H_PLJIT_IR
+#include "pljit/evaluation/Arithmetic.hpp"
+#include <array>
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+#include <vector>
+using namespace std;
+//---------------------------------------------------------------------------
+namespace pljit::ir {
+//---------------------------------------------------------------------------
+/// Number of an ssa value, it is the index of the instruction that defines the value
+using ValueId = uint32_t;
+/// Value number that marks an unused operand
+constexpr ValueId invalidValue = static_cast<ValueId>(-1);
+/// Struct that represents an instruction in the ssa form, every instruction defines exactly one value
+struct Instruction {
+    /// All possible operations
+    enum class Opcode {
+        Constant,
+        Parameter,
+        Add,
+        Subtract,
+        Mul,
+        Div,
+        Negate,
+        Return,
+        Nop
+    };
+    /// Constructors
+    Instruction() = default;
+    Instruction(Opcode opcode, ValueId left, ValueId right = invalidValue) : opcode(opcode), operands{left, right} {}
+    /// Create a constant
+    static Instruction constant(int64_t value);
+    /// Create a parameter, it reads the parameter at the given position
+    static Instruction parameter(size_t position, string_view name);
+    /// Return the number of operands of the instruction
+    size_t operandCount() const;
+    /// Return whether the instruction may fail at runtime, a division by zero or an overflow in the trapping mode
+    bool mayTrap(const vector<Instruction>& instructions, evaluation::ArithmeticMode arithmeticMode = evaluation::ArithmeticMode::Wrapping) const;
+    /// Storage of the operation
+    Opcode opcode = Opcode::Nop;
+    /// Storage of the operands
+    array<ValueId, 2> operands = {invalidValue, invalidValue};
+    /// Storage of the position of the statement in the code the instruction was lowered from, it fills the padding before the value
+    uint32_t sourceStatement = 0;
+    /// Storage of the value of a constant or the position of a parameter
+    int64_t value = 0;
+    /// Storage of the name of a parameter
+    string_view name;
+};
+/// Class that represents a function in ssa form (straight-line code ending in a single return)
+class IRFunction {
+    public:
+    /// Constructor
+    IRFunction() = default;
+    /// Append an instruction, returns the number of the defined value
+    ValueId append(Instruction instruction);
+    /// Getters
+    const vector<Instruction>& getInstructions() const { return instructions; }
+    vector<Instruction>& getInstructions() { return instructions; }
+    const Instruction& operator[](ValueId value) const { return instructions[value]; }
+    Instruction& operator[](ValueId value) { return instructions[value]; }
+    const vector<string_view>& getParameters() const { return parameters; }
+    void setParameters(vector<string_view> names) { parameters = move(names); }
+    /// Build the def-use chains
+    void computeUsers();
+    /// Return the instructions that use a value, computeUsers has to be called before
+    const vector<ValueId>& getUsers(ValueId value) const { return users[value]; }
+    /// Replace all uses of a value with another value and keep the def-use chains up to date
+    void replaceAllUses(ValueId from, ValueId to);
+    /// Remove all Nop instructions and renumber the values
+    void compact();
+    /// Return the number of instructions that are not Nop
+    size_t size() const;
+    /// Print the function in a readable form
+    void print(ostream& out) const;
+
+    private:
+    /// Storage of the instructions
+    vector<Instruction> instructions;
+    /// Storage of the users of every value
+    vector<vector<ValueId>> users;
+    /// Storage of the names of all declared parameters ordered by their position
+    vector<string_view> parameters;
+};
+//---------------------------------------------------------------------------
+} // namespace pljit::ir
+//---------------------------------------------------------------------------
+#endif // H_PLJIT_IR
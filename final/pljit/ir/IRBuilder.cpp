@@ -0,0 +1,127 @@
+#include "pljit/ir/IRBuilder.hpp"
+//---------------------------------------------------------------------------
+namespace pljit::ir {
+//---------------------------------------------------------------------------
+// Lower a function
+IRFunction IRBuilder::build(const Function& function) {
+    irFunction = IRFunction();
+    values.clear();
+    parameterPositions.clear();
+    statementEnds.clear();
+    returned = false;
+    function.accept(*this);
+    return move(irFunction);
+}
+//---------------------------------------------------------------------------
+// Lower a constant
+void IRBuilder::visit(const Constant& constant) {
+    result = append(Instruction::constant(constant.getValue()));
+}
+//---------------------------------------------------------------------------
+// Lower a read of an identifier
+void IRBuilder::visit(const Parameter& parameter) {
+    string_view name = parameter.getName();
+
+    if (auto valueIterator = values.find(name); valueIterator != values.end()) {
+        result = valueIterator->second;
+        return;
+    }
+
+    auto positionIterator = parameterPositions.find(name);
+    if (positionIterator != parameterPositions.end()) {
+        result = append(Instruction::parameter(positionIterator->second, name));
+    } else {
+        result = append(Instruction::constant(optimizationTable->getValue(name)));
+    }
+    values[name] = result;
+}
+//---------------------------------------------------------------------------
+// Lower a function
+void IRBuilder::visit(const Function& function) {
+    optimizationTable = &function.getSymbolTable();
+
+    vector<string_view> parameters = optimizationTable->getParameters();
+    for (size_t i = 0; i < parameters.size(); i++) {
+        if (!parameters[i].empty()) {
+            parameterPositions[parameters[i]] = i;
+        }
+    }
+    irFunction.setParameters(move(parameters));
+
+    for (const auto& statement : function.getStatements()) {
+        statement->accept(*this);
+        statementEnds.push_back(irFunction.getInstructions().size());
+        if (returned) {
+            break;
+        }
+    }
+}
+//---------------------------------------------------------------------------
+// Lower a statement
+void IRBuilder::visit(const ASTStatement& astStatement) {
+    sourceStatement = static_cast<uint32_t>(astStatement.getSourceIndex());
+    astStatement.getExpression().accept(*this);
+}
+//---------------------------------------------------------------------------
+// Append an instruction of the lowered statement
+ValueId IRBuilder::append(Instruction instruction) {
+    instruction.sourceStatement = sourceStatement;
+    return irFunction.append(instruction);
+}
+//---------------------------------------------------------------------------
+// Lower an assignment, the identifier is renamed to the assigned value
+void IRBuilder::visit(const AssignmentExpr& assignmentExpr) {
+    assignmentExpr.getRight().accept(*this);
+    const auto& left = static_cast<const Parameter&>(assignmentExpr.getLeft());
+    values[left.getName()] = result;
+}
+//---------------------------------------------------------------------------
+// Lower a return statement
+void IRBuilder::visit(const ReturnExpr& returnExpr) {
+    returnExpr.getChild().accept(*this);
+    append(Instruction(Instruction::Opcode::Return, result));
+    returned = true;
+}
+//---------------------------------------------------------------------------
+// Lower a binary expression
+void IRBuilder::lowerBinary(const BinaryExpr& binaryExpr, Instruction::Opcode opcode) {
+    binaryExpr.getLeft().accept(*this);
+    ValueId left = result;
+    binaryExpr.getRight().accept(*this);
+    ValueId right = result;
+    result = append(Instruction(opcode, left, right));
+}
+//---------------------------------------------------------------------------
+// Lower a multiplication
+void IRBuilder::visit(const MulExpr& mulExpr) {
+    lowerBinary(mulExpr, Instruction::Opcode::Mul);
+}
+//---------------------------------------------------------------------------
+// Lower a division
+void IRBuilder::visit(const DivExpr& divExpr) {
+    lowerBinary(divExpr, Instruction::Opcode::Div);
+}
+//---------------------------------------------------------------------------
+// Lower an addition
+void IRBuilder::visit(const AddExpr& addExpr) {
+    lowerBinary(addExpr, Instruction::Opcode::Add);
+}
+//---------------------------------------------------------------------------
+// Lower a subtraction
+void IRBuilder::visit(const SubtractExpr& subtractExpr) {
+    lowerBinary(subtractExpr, Instruction::Opcode::Subtract);
+}
+//---------------------------------------------------------------------------
+// Lower a unary plus, it does not change the value
+void IRBuilder::visit(const UnaryPlus& unaryPlus) {
+    unaryPlus.getChild().accept(*this);
+}
+//---------------------------------------------------------------------------
+// Lower a unary minus
+void IRBuilder::visit(const UnaryMinus& unaryMinus) {
+    unaryMinus.getChild().accept(*this);
+    result = append(Instruction(Instruction::Opcode::Negate, result));
+}
+//---------------------------------------------------------------------------
+} // namespace pljit::ir
+//---------------------------------------------------------------------------
@@ -0,0 +1,59 @@
+#ifndef H_PLJIT_IRBUILDER
+#define H_PLJIT_IRBUILDER
+#include "pljit/ast/AST.hpp"
+#include "pljit/ir/IR.hpp"
+#include <unordered_map>
+using namespace pljit::ast;
+//---------------------------------------------------------------------------
+namespace pljit::ir {
+//---------------------------------------------------------------------------
+/// Class that lowers an analyzed ast into ssa form, every variable is renamed to the value of its last assignment
+class IRBuilder : public ASTVisitor {
+    public:
+    /// Constructor
+    IRBuilder() = default;
+    /// Lower a function, the lowering stops at the first return statement
+    IRFunction build(const Function& function);
+    /// Return the number of instructions at the end of every lowered statement of the last build
+    const vector<size_t>& getStatementEnds() const { return statementEnds; }
+    /// Visit functions for each node type
+    void visit(const Constant&) override;
+    void visit(const Parameter&) override;
+    void visit(const Function&) override;
+    void visit(const ASTStatement&) override;
+    void visit(const AssignmentExpr&) override;
+    void visit(const ReturnExpr&) override;
+    void visit(const MulExpr&) override;
+    void visit(const DivExpr&) override;
+    void visit(const AddExpr&) override;
+    void visit(const SubtractExpr&) override;
+    void visit(const UnaryPlus&) override;
+    void visit(const UnaryMinus&) override;
+
+    private:
+    /// Append an instruction of the lowered statement
+    ValueId append(Instruction instruction);
+    /// Lower a binary expression
+    void lowerBinary(const BinaryExpr& binaryExpr, Instruction::Opcode opcode);
+    /// Storage of the function that is lowered
+    IRFunction irFunction;
+    /// Storage of the symbol table of the lowered function
+    const OptimizationTable* optimizationTable = nullptr;
+    /// Storage of the current value of every identifier
+    unordered_map<string_view, ValueId> values;
+    /// Storage of the positions of the parameters
+    unordered_map<string_view, size_t> parameterPositions;
+    /// Storage of the number of instructions at the end of every lowered statement
+    vector<size_t> statementEnds;
+    /// Storage of the value of the last visited expression
+    ValueId result = invalidValue;
+    /// Storage of the position of the lowered statement in the code
+    uint32_t sourceStatement = 0;
+    /// Mark whether a return statement was lowered
+    bool returned = false;
+};
+//---------------------------------------------------------------------------
+} // namespace pljit::ir
+//---------------------------------------------------------------------------
+#endif // H_PLJIT_IRBUILDER
+//---------------------------------------------------------------------------
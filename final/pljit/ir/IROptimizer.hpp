@@ -0,0 +1,20 @@
+#ifndef H_PLJIT_IROPTIMIZER
+#define H_PLJIT_IROPTIMIZER
+#include "pljit/ir/IR.hpp"
+//---------------------------------------------------------------------------
+namespace pljit::ir {
+//---------------------------------------------------------------------------
+/// Struct that represents a virtual optimization pass over a function in ssa form
+struct IROptimizer {
+    /// Constructor
+    IROptimizer() = default;
+    /// Destructor
+    virtual ~IROptimizer() = default;
+    /// Optimize the function in place
+    virtual void optimize(IRFunction& irFunction) = 0;
+};
+//---------------------------------------------------------------------------
+} // namespace pljit::ir
+//---------------------------------------------------------------------------
+#endif // H_PLJIT_IROPTIMIZER
+//---------------------------------------------------------------------------
@@ -0,0 +1,57 @@
+#include "pljit/ir/IROptimizerCommonSubexpression.hpp"
+#include <unordered_map>
+//---------------------------------------------------------------------------
+namespace pljit::ir {
+//---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+/// Struct that identifies the value computed by an instruction
+struct ValueKey {
+    Instruction::Opcode opcode;
+    ValueId left;
+    ValueId right;
+    int64_t value;
+
+    bool operator==(const ValueKey&) const = default;
+};
+/// Struct that hashes a value key
+struct ValueKeyHash {
+    size_t operator()(const ValueKey& key) const {
+        uint64_t hashValue = static_cast<uint64_t>(key.opcode);
+        hashValue = hashValue * 0x9e3779b97f4a7c15ull + key.left;
+        hashValue = hashValue * 0x9e3779b97f4a7c15ull + key.right;
+        hashValue = hashValue * 0x9e3779b97f4a7c15ull + static_cast<uint64_t>(key.value);
+        return hashValue ^ (hashValue >> 29);
+    }
+};
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+// Overridden optimize function
+void IROptimizerCommonSubexpression::optimize(IRFunction& irFunction) {
+    irFunction.computeUsers();
+    auto& instructions = irFunction.getInstructions();
+    unordered_map<ValueKey, ValueId, ValueKeyHash> numbering;
+
+    for (size_t i = 0; i < instructions.size(); i++) {
+        Instruction& instruction = instructions[i];
+        if (instruction.opcode == Instruction::Opcode::Return || instruction.opcode == Instruction::Opcode::Nop) {
+            continue;
+        }
+
+        ValueKey key{instruction.opcode, instruction.operands[0], instruction.operands[1], instruction.value};
+        // Addition and multiplication are commutative
+        if ((key.opcode == Instruction::Opcode::Add || key.opcode == Instruction::Opcode::Mul) && key.right < key.left) {
+            swap(key.left, key.right);
+        }
+
+        auto [numberIterator, inserted] = numbering.try_emplace(key, static_cast<ValueId>(i));
+        if (!inserted) {
+            irFunction.replaceAllUses(static_cast<ValueId>(i), numberIterator->second);
+            instruction = Instruction();
+        }
+    }
+}
+//---------------------------------------------------------------------------
+} // namespace pljit::ir
+//---------------------------------------------------------------------------
@@ -0,0 +1,20 @@
+#ifndef H_PLJIT_IROPTIMIZERCOMMONSUBEXPRESSION
+#define H_PLJIT_IROPTIMIZERCOMMONSUBEXPRESSION
+#include "pljit/ir/IROptimizer.hpp"
+//---------------------------------------------------------------------------
+namespace pljit::ir {
+//---------------------------------------------------------------------------
+/// Struct that represents a common subexpression elimination pass, it numbers every value by its operation and operands in one forward sweep
+struct IROptimizerCommonSubexpression : IROptimizer {
+    /// Constructor
+    IROptimizerCommonSubexpression() = default;
+    /// Destructor
+    ~IROptimizerCommonSubexpression() override = default;
+    /// Overridden optimize function
+    void optimize(IRFunction& irFunction) override;
+};
+//---------------------------------------------------------------------------
+} // namespace pljit::ir
+//---------------------------------------------------------------------------
+#endif // H_PLJIT_IROPTIMIZERCOMMONSUBEXPRESSION
+//---------------------------------------------------------------------------
@@ -0,0 +1,111 @@
+#include "pljit/ir/IROptimizerConstantPropagation.hpp"
+#include <optional>
+using namespace pljit::evaluation;
+//---------------------------------------------------------------------------
+namespace pljit::ir {
+//---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+// Check whether a value is a constant with the given value
+bool isConstant(const IRFunction& irFunction, ValueId value, int64_t constant) {
+    return irFunction[value].opcode == Instruction::Opcode::Constant && irFunction[value].value == constant;
+}
+//---------------------------------------------------------------------------
+// Fold an operation on constants in the arithmetic mode
+optional<int64_t> fold(Instruction::Opcode opcode, int64_t left, int64_t right, ArithmeticMode arithmeticMode) {
+    CheckedResult result;
+    switch (opcode) {
+        case Instruction::Opcode::Add: result = checkedAdd(left, right); break;
+        case Instruction::Opcode::Subtract: result = checkedSubtract(left, right); break;
+        case Instruction::Opcode::Mul: result = checkedMul(left, right); break;
+        case Instruction::Opcode::Negate: result = checkedNegate(left); break;
+        case Instruction::Opcode::Div:
+            // A division by zero has to fail at runtime
+            if (right == 0) {
+                return nullopt;
+            }
+            result = checkedDiv(left, right);
+            break;
+        default: return nullopt;
+    }
+    // An overflow in the trapping mode has to fail at runtime as well
+    if (result.overflow && arithmeticMode == ArithmeticMode::Trapping) {
+        return nullopt;
+    }
+    return result.get(arithmeticMode == ArithmeticMode::Saturating);
+}
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+// Overridden optimize function
+void IROptimizerConstantPropagation::optimize(IRFunction& irFunction) {
+    irFunction.computeUsers();
+    auto& instructions = irFunction.getInstructions();
+
+    for (size_t i = 0; i < instructions.size(); i++) {
+        Instruction& instruction = instructions[i];
+        auto valueId = static_cast<ValueId>(i);
+        const auto [left, right] = instruction.operands;
+        size_t operandCount = instruction.operandCount();
+
+        if (instruction.opcode == Instruction::Opcode::Return || operandCount == 0) {
+            continue;
+        }
+
+        // Fold operations whose operands are all constant
+        bool constantOperands = irFunction[left].opcode == Instruction::Opcode::Constant && (operandCount == 1 || irFunction[right].opcode == Instruction::Opcode::Constant);
+        if (constantOperands) {
+            int64_t rightValue = operandCount == 1 ? 0 : irFunction[right].value;
+            if (optional<int64_t> folded = fold(instruction.opcode, irFunction[left].value, rightValue, arithmeticMode)) {
+                instruction = Instruction::constant(folded.value());
+                continue;
+            }
+        }
+
+        // Simplify neutral and absorbing operands
+        ValueId replacement = invalidValue;
+        switch (instruction.opcode) {
+            case Instruction::Opcode::Add:
+                if (isConstant(irFunction, left, 0)) {
+                    replacement = right;
+                } else if (isConstant(irFunction, right, 0)) {
+                    replacement = left;
+                }
+                break;
+            case Instruction::Opcode::Subtract:
+                if (isConstant(irFunction, right, 0)) {
+                    replacement = left;
+                }
+                break;
+            case Instruction::Opcode::Mul:
+                if (isConstant(irFunction, left, 0) || isConstant(irFunction, right, 0)) {
+                    instruction = Instruction::constant(0);
+                } else if (isConstant(irFunction, left, 1)) {
+                    replacement = right;
+                } else if (isConstant(irFunction, right, 1)) {
+                    replacement = left;
+                }
+                break;
+            case Instruction::Opcode::Div:
+                if (isConstant(irFunction, right, 1)) {
+                    replacement = left;
+                }
+                break;
+            case Instruction::Opcode::Negate:
+                // A double negation only cancels out if the arithmetic wraps around
+                if (arithmeticMode == ArithmeticMode::Wrapping && irFunction[left].opcode == Instruction::Opcode::Negate) {
+                    replacement = irFunction[left].operands[0];
+                }
+                break;
+            default: break;
+        }
+
+        if (replacement != invalidValue) {
+            irFunction.replaceAllUses(valueId, replacement);
+            instruction = Instruction();
+        }
+    }
+}
+//---------------------------------------------------------------------------
+} // namespace pljit::ir
+//---------------------------------------------------------------------------
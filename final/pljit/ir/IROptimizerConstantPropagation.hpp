@@ -0,0 +1,24 @@
+#ifndef H_PLJIT_IROPTIMIZERCONSTANTPROPAGATION
+#define H_PLJIT_IROPTIMIZERCONSTANTPROPAGATION
+#include "pljit/ir/IROptimizer.hpp"
+//---------------------------------------------------------------------------
+namespace pljit::ir {
+//---------------------------------------------------------------------------
+/// Struct that represents a constant propagation pass, it folds constant operations and simplifies neutral operands in one forward sweep
+struct IROptimizerConstantPropagation : IROptimizer {
+    /// Constructor, the folded constants follow the arithmetic mode of the evaluation
+    explicit IROptimizerConstantPropagation(evaluation::ArithmeticMode arithmeticMode = evaluation::ArithmeticMode::Wrapping) : arithmeticMode(arithmeticMode) {}
+    /// Destructor
+    ~IROptimizerConstantPropagation() override = default;
+    /// Overridden optimize function
+    void optimize(IRFunction& irFunction) override;
+
+    private:
+    /// Storage of the arithmetic mode
+    evaluation::ArithmeticMode arithmeticMode;
+};
+//---------------------------------------------------------------------------
+} // namespace pljit::ir
+//---------------------------------------------------------------------------
+#endif // H_PLJIT_IROPTIMIZERCONSTANTPROPAGATION
+//---------------------------------------------------------------------------
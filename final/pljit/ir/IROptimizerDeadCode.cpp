@@ -0,0 +1,30 @@
+#include "pljit/ir/IROptimizerDeadCode.hpp"
+//---------------------------------------------------------------------------
+namespace pljit::ir {
+//---------------------------------------------------------------------------
+// Overridden optimize function
+void IROptimizerDeadCode::optimize(IRFunction& irFunction) {
+    auto& instructions = irFunction.getInstructions();
+    vector<bool> live(instructions.size(), false);
+
+    for (size_t i = instructions.size(); i-- > 0;) {
+        Instruction& instruction = instructions[i];
+        // An operation that may fail has to be executed even if its value is unused
+        if (instruction.opcode == Instruction::Opcode::Return || instruction.mayTrap(instructions, arithmeticMode)) {
+            live[i] = true;
+        }
+
+        if (!live[i]) {
+            instruction = Instruction();
+            continue;
+        }
+        for (size_t j = 0; j < instruction.operandCount(); j++) {
+            live[instruction.operands[j]] = true;
+        }
+    }
+
+    irFunction.compact();
+}
+//---------------------------------------------------------------------------
+} // namespace pljit::ir
+//---------------------------------------------------------------------------
@@ -0,0 +1,24 @@
+#ifndef H_PLJIT_IROPTIMIZERDEADCODE
+#define H_PLJIT_IROPTIMIZERDEADCODE
+#include "pljit/ir/IROptimizer.hpp"
+//---------------------------------------------------------------------------
+namespace pljit::ir {
+//---------------------------------------------------------------------------
+/// Struct that represents a dead code elimination pass, it removes all values that neither reach the return nor may fail at runtime in one backward sweep
+struct IROptimizerDeadCode : IROptimizer {
+    /// Constructor, values that overflow in the trapping mode may fail as well
+    explicit IROptimizerDeadCode(evaluation::ArithmeticMode arithmeticMode = evaluation::ArithmeticMode::Wrapping) : arithmeticMode(arithmeticMode) {}
+    /// Destructor
+    ~IROptimizerDeadCode() override = default;
+    /// Overridden optimize function
+    void optimize(IRFunction& irFunction) override;
+
+    private:
+    /// Storage of the arithmetic mode
+    evaluation::ArithmeticMode arithmeticMode;
+};
+//---------------------------------------------------------------------------
+} // namespace pljit::ir
+//---------------------------------------------------------------------------
+#endif // H_PLJIT_IROPTIMIZERDEADCODE
+//---------------------------------------------------------------------------
@@ -112,7 +112,7 @@ bool Lexer::isUpper(char c) {
 // Function to tokenize a literal
 Token Lexer::literal() {
     size_t start = currentPos;
-    while (isDigit(*currentChar)) {
+    while (isDigit(current())) {
         increment();
     }
     size_t length = currentPos - start;
@@ -121,7 +121,7 @@ Token Lexer::literal() {
 //---------------------------------------------------------------------------
 // Function to tokenize an identifier
 Token Lexer::identifier(size_t start) {
-    while (isAlpha(*currentChar)) {
+    while (isAlpha(current())) {
         increment();
     }
 
@@ -155,10 +155,10 @@ Token Lexer::keyword(size_t start, size_t length) {
 Token Lexer::identifierOrKeyword() {
     size_t start = currentPos;
 
-    while (isUpper(*currentChar)) {
+    while (isUpper(current())) {
         increment();
     }
-    if (isLower(*currentChar)) {
+    if (isLower(current())) {
         return identifier(start);
     } else {
         return keyword(start, currentPos - start);
@@ -173,27 +173,38 @@ void Lexer::increment() {
 //---------------------------------------------------------------------------
 // Function to return the next token in the code
 Token Lexer::next() {
+    if (!timed) {
+        return scan();
+    }
+    auto begin = chrono::steady_clock::now();
+    Token token = scan();
+    lexingTime += chrono::steady_clock::now() - begin;
+    return token;
+}
+//---------------------------------------------------------------------------
+// Function to scan the next token in the code
+Token Lexer::scan() {
     if (currentChar != beginning && (*(currentChar - 1) == '.')) {
         return Token();
     }
 
-    while (isWhitespace(*currentChar)) {
+    while (isWhitespace(current())) {
         increment();
     }
 
-    if (isDigit(*currentChar)) {
+    if (isDigit(current())) {
         return literal();
     }
 
-    if (isLower(*currentChar)) {
+    if (isLower(current())) {
         return identifier(currentPos);
     }
 
-    if (isAlpha(*currentChar)) {
+    if (isAlpha(current())) {
         return identifierOrKeyword();
     }
 
-    switch (*currentChar) {
+    switch (current()) {
         case ',': {
             increment();
             return Token(Token::TokenType::CommaSeparator, Reference(currentPos - 1));
@@ -223,7 +234,7 @@ Token Lexer::next() {
             return Token(Token::TokenType::RightParanthesis, Reference(currentPos - 1));
         }
         case ':': {
-            if (*(currentChar + 1) == '=') {
+            if (peek() == '=') {
                 increment();
                 increment();
                 return Token(Token::TokenType::AssignmentOperator, Reference(currentPos - 2, 2));
@@ -238,7 +249,7 @@ Token Lexer::next() {
         }
         case '+': {
             increment();
-            char c = *(currentChar);
+            char c = current();
 
             if (c == ' ') {
                 return Token(Token::TokenType::BinaryPlusOperator, Reference(currentPos - 1));
@@ -248,7 +259,7 @@ Token Lexer::next() {
         }
         case '-': {
             increment();
-            char c = *(currentChar);
+            char c = current();
 
             if (c == ' ') {
                 return Token(Token::TokenType::BinaryMinusOperator, Reference(currentPos - 1));
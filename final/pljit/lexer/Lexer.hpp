@@ -2,6 +2,7 @@
 #define H_PLJIT_LEXER
 #include "pljit/codem/CodeManagement.hpp"
 #include "pljit/lexer/Token.hpp"
+#include <chrono>
 #include <memory>
 //---------------------------------------------------------------------------
 namespace pljit::lexer {
@@ -11,6 +12,11 @@ struct Lexer {
     /// Constructors
     Lexer() = default;
     Lexer(const char* currentChar, shared_ptr<CodeManagement> codeM) : currentChar(currentChar), codeM(move(codeM)) {}
+    /// Constructor for a part of the code, the first character is at the given position of the code
+    Lexer(const char* currentChar, size_t currentPos, shared_ptr<CodeManagement> codeM) : currentChar(currentChar), currentPos(currentPos), codeM(move(codeM)) {}
+    /// Constructors for code that does not have to be terminated by a NUL character, the lexer does not read past its end
+    Lexer(string_view code, shared_ptr<CodeManagement> codeM) : currentChar(code.data()), end(code.data() + code.size()), codeM(move(codeM)) {}
+    Lexer(string_view code, size_t currentPos, shared_ptr<CodeManagement> codeM) : currentChar(code.data()), end(code.data() + code.size()), currentPos(currentPos), codeM(move(codeM)) {}
     /// Tokenize a literal (integer)
     Token literal();
     /// Tokenize an identifier
@@ -23,6 +29,10 @@ struct Lexer {
     void increment();
     /// Return the next token in the code
     Token next();
+    /// Measure the time spent in next, e.g. for the instrumentation or an active trace
+    void setTimed(bool timed1) { timed = timed1; }
+    /// Return the time spent in next, it is only measured if the lexer is timed
+    chrono::nanoseconds getLexingTime() const { return lexingTime; }
     /// Return whether the current character is a whitespace
     static bool isWhitespace(char);
     /// Return whether the current character is a digit
@@ -35,14 +45,25 @@ struct Lexer {
     static bool isLower(char);
 
     private:
+    /// Scan the next token in the code
+    Token scan();
+    /// Return the current and the next character, the end of the code reads as a NUL character
+    char current() const { return currentChar != end ? *currentChar : '\0'; }
+    char peek() const { return currentChar != end && currentChar + 1 != end ? currentChar[1] : '\0'; }
     /// Storage of the current character in the code
     const char* currentChar = "";
+    /// Storage of the position after the last character, nullptr if the code is terminated by a NUL character
+    const char* end = nullptr;
     /// Storage of the first character in the code
     const char* beginning = currentChar;
     /// Storage of the current position in the code
     size_t currentPos = 0;
     /// Storage of the code management unit
     shared_ptr<CodeManagement> codeM;
+    /// Storage of the time spent in next
+    chrono::nanoseconds lexingTime{0};
+    /// Storage of whether the time spent in next is measured
+    bool timed = false;
 };
 //---------------------------------------------------------------------------
 } // namespace pljit::lexer
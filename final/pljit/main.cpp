@@ -1,33 +1,414 @@
+#include "pljit/MappedFile.hpp"
 #include "pljit/Pljit.hpp"
+#include "pljit/Server.hpp"
+#include "pljit/StreamEvaluator.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <csignal>
+#include <thread>
+//---------------------------------------------------------------------------
 using namespace std;
 using namespace pljit;
+//---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+/// Struct that represents the command line options
+struct Options {
+    /// Files and directories of the sources
+    vector<string> sources;
+    /// File of the parameter rows, empty for stdin
+    string parameters;
+    /// Function that is called by all rows, otherwise every row starts with the index of its function
+    optional<size_t> function;
+    /// Number of threads
+    size_t threads = ThreadPool::defaultWorkerCount();
+    /// Optimization level of the functions
+    OptimizationLevel level = OptimizationLevel::O1;
+    /// Arithmetic mode of the functions
+    ArithmeticMode arithmetic = ArithmeticMode::Wrapping;
+    /// Number of rows a task evaluates
+    size_t morselSize = 1024;
+    /// File the results are streamed to, empty to write them to stdout
+    string output;
+    /// Whether the streamed parameter and result files are binary
+    bool binary = false;
+    /// Socket path of the server mode, empty to evaluate the parameter rows
+    string socket;
+    /// Number of nodes a call may evaluate, 0 for no limit
+    uint64_t fuel = 0;
+};
+/// Struct that represents a parameter row
+struct Row {
+    /// Index of the called function
+    size_t function = 0;
+    /// Parameters of the call
+    vector<int64_t> parameters;
+    /// Whether the row could be parsed
+    bool valid = true;
+};
+/// Class that buffers the output and writes it in large blocks without flushing
+class OutputBuffer {
+    public:
+    /// Destructor, writes the remaining output
+    ~OutputBuffer() { write(); }
+    /// Append a result
+    void append(optional<int64_t> result) {
+        if (result) {
+            char digits[24];
+            auto [end, error] = to_chars(digits, digits + sizeof(digits), *result);
+            buffer.append(digits, end);
+        } else {
+            buffer.append("error");
+        }
+        buffer.push_back('\n');
+        if (buffer.size() >= blockSize) {
+            write();
+        }
+    }
 
-int main() {
-    Pljit jit;
+    private:
+    /// Write the buffer to stdout
+    void write() {
+        fwrite(buffer.data(), 1, buffer.size(), stdout);
+        buffer.clear();
+    }
+    /// Size of the written blocks
+    static constexpr size_t blockSize = 1 << 20;
+    /// Storage of the buffered output
+    string buffer;
+};
+//---------------------------------------------------------------------------
+// Print the usage
+void printUsage(const char* program) {
+    cerr << "usage: " << program << " [options] <file or directory>...\n"
+         << "  every file is a bundle of functions that end with END., a directory contributes all its files in name order\n"
+         << "  every parameter row is a line of integers that starts with the index of the called function\n"
+         << "options:\n"
+         << "  --params <file>    read the parameter rows from a file instead of stdin\n"
+         << "  --function <index> call the function for all rows, the rows only contain the parameters\n"
+         << "  --threads <count>  number of threads for the compilation and evaluation\n"
+         << "  --level <0|1|2>    optimization level\n"
+         << "  --arithmetic <mode> wrapping, trapping or saturating handling of an overflow\n"
+         << "  --fuel <nodes>     number of nodes a call may evaluate before it fails\n"
+         << "  --output <file>    stream the results of one function over the --params file into a file\n"
+         << "  --binary           the streamed files hold native 64-bit integers instead of text\n"
+         << "  --serve <socket>   serve register and evaluate requests on a Unix domain socket, the sources are registered in advance\n";
+}
+//---------------------------------------------------------------------------
+// Parse a non-negative number of the command line
+optional<size_t> parseNumber(string_view argument) {
+    size_t value = 0;
+    auto [end, error] = from_chars(argument.data(), argument.data() + argument.size(), value);
+    if (error != errc() || end != argument.data() + argument.size()) {
+        return nullopt;
+    }
+    return value;
+}
+//---------------------------------------------------------------------------
+// Parse an arithmetic mode of the command line
+optional<ArithmeticMode> parseArithmeticMode(string_view argument) {
+    if (argument == "wrapping") {
+        return ArithmeticMode::Wrapping;
+    }
+    if (argument == "trapping") {
+        return ArithmeticMode::Trapping;
+    }
+    if (argument == "saturating") {
+        return ArithmeticMode::Saturating;
+    }
+    return nullopt;
+}
+//---------------------------------------------------------------------------
+// Parse the command line, returns nullopt if it is invalid
+optional<Options> parseOptions(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; i++) {
+        string_view argument = argv[i];
+        optional<size_t> value = i + 1 < argc ? parseNumber(argv[i + 1]) : nullopt;
+        if (argument == "--params" && i + 1 < argc) {
+            options.parameters = argv[++i];
+        } else if (argument == "--function" && value) {
+            options.function = *value;
+            i++;
+        } else if (argument == "--threads" && value) {
+            options.threads = max<size_t>(*value, 1);
+            i++;
+        } else if (argument == "--level" && value && *value <= 2) {
+            options.level = static_cast<OptimizationLevel>(*value);
+            i++;
+        } else if (argument == "--arithmetic" && i + 1 < argc) {
+            optional<ArithmeticMode> mode = parseArithmeticMode(argv[++i]);
+            if (!mode) {
+                return nullopt;
+            }
+            options.arithmetic = *mode;
+        } else if (argument == "--fuel" && value) {
+            options.fuel = *value;
+            i++;
+        } else if (argument == "--output" && i + 1 < argc) {
+            options.output = argv[++i];
+        } else if (argument == "--serve" && i + 1 < argc) {
+            options.socket = argv[++i];
+        } else if (argument == "--binary") {
+            options.binary = true;
+        } else if (argument.starts_with("--")) {
+            return nullopt;
+        } else {
+            options.sources.emplace_back(argument);
+        }
+    }
+    // Streaming needs a mapped parameter file
+    if ((options.sources.empty() && options.socket.empty()) || (!options.output.empty() && options.parameters.empty()) || (options.binary && options.output.empty())) {
+        return nullopt;
+    }
+    return options;
+}
+//---------------------------------------------------------------------------
+// Return the files of the sources, the files of a directory are sorted by their name
+vector<string> collectFiles(const vector<string>& sources) {
+    vector<string> files;
+    for (const auto& source : sources) {
+        if (!filesystem::is_directory(source)) {
+            files.push_back(source);
+            continue;
+        }
+        vector<string> directoryFiles;
+        for (const auto& entry : filesystem::directory_iterator(source)) {
+            if (entry.is_regular_file()) {
+                directoryFiles.push_back(entry.path().string());
+            }
+        }
+        sort(directoryFiles.begin(), directoryFiles.end());
+        files.insert(files.end(), directoryFiles.begin(), directoryFiles.end());
+    }
+    return files;
+}
+//---------------------------------------------------------------------------
+// Parse the parameter rows, every line is one row
+vector<Row> parseRows(string_view input, bool withFunction) {
+    vector<Row> rows;
+    while (!input.empty()) {
+        size_t lineEnd = input.find('\n');
+        string_view line = input.substr(0, lineEnd);
+        input.remove_prefix(lineEnd == string_view::npos ? input.size() : lineEnd + 1);
+        if (line.find_first_not_of(" \t\r") == string_view::npos) {
+            continue;
+        }
+
+        Row row;
+        bool first = withFunction;
+        const char* current = line.data();
+        const char* end = line.data() + line.size();
+        while (current != end) {
+            while (current != end && (*current == ' ' || *current == '\t' || *current == '\r' || *current == ',')) {
+                current++;
+            }
+            if (current == end) {
+                break;
+            }
+            int64_t value = 0;
+            auto [next, error] = from_chars(current, end, value);
+            if (error != errc()) {
+                row.valid = false;
+                break;
+            }
+            if (first) {
+                row.function = static_cast<size_t>(value);
+                first = false;
+            } else {
+                row.parameters.push_back(value);
+            }
+            current = next;
+        }
+        row.valid = row.valid && !first;
+        rows.push_back(move(row));
+    }
+    return rows;
+}
+//---------------------------------------------------------------------------
+// Return the seconds since begin
+double secondsSince(chrono::steady_clock::time_point begin) {
+    return chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+}
+//---------------------------------------------------------------------------
+// Stream the results of one function over the parameter file into the output file
+int stream(const Options& options, const vector<unique_ptr<PljitHandle>>& handles, ThreadPool& pool) {
+    if (!options.function && handles.size() != 1) {
+        cerr << "error: streaming needs --function or a single function" << endl;
+        return 1;
+    }
+    size_t function = options.function.value_or(0);
+    if (function >= handles.size() || !handles[function]->isCompiled()) {
+        cerr << "error: function " << function << " is not available" << endl;
+        return 2;
+    }
 
-    auto func1 = jit.registerFunction("PARAM a, b; VAR d; CONST c = 2; BEGIN d := (a + b); d := d * c; RETURN d END.");
-    auto func2 = jit.registerFunction("VAR d, e; BEGIN d := -1 * (12 / (-6)); e := d + +2; e := -(-(-e)); RETURN e; RETURN d END.");
-    auto func3 = jit.registerFunction("PARAM a; VAR b; CONST c = 1; BEGIN b := a - c - 2; RETURN b END.");
+    StreamOptions streamOptions;
+    streamOptions.inputFormat = options.binary ? StreamFormat::Binary : StreamFormat::Text;
+    streamOptions.outputFormat = streamOptions.inputFormat;
+    optional<StreamResult> result = StreamEvaluator(*handles[function], pool).run(options.parameters, options.output, streamOptions);
+    if (!result) {
+        cerr << "error: cannot stream " << options.parameters << " into " << options.output << endl;
+        return 1;
+    }
+    cerr << "streamed " << result->rows << " rows with " << result->errors << " errors in " << chrono::duration<double, milli>(result->duration).count() << " ms ("
+         << result->getThroughput() << " rows/s, " << static_cast<double>(result->bytesRead) / max(chrono::duration<double>(result->duration).count(), 1e-9) / (1 << 20) << " MiB/s)" << endl;
+    return result->errors == 0 ? 0 : 2;
+}
+//---------------------------------------------------------------------------
+// Serve the functions on the socket until SIGINT or SIGTERM
+int serve(const Options& options, span<const string_view> inputs) {
+    // The signals are blocked before the workers are started, so that they inherit the mask
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
 
-    vector<int64_t> params1 = {1, 2};
-    vector<int64_t> params2;
-    vector<int64_t> params3 = {4};
+    ServerOptions serverOptions;
+    serverOptions.workers = options.threads;
+    serverOptions.level = options.level;
+    serverOptions.arithmetic = options.arithmetic;
+    serverOptions.fuel = options.fuel;
+    Server server(serverOptions);
+    for (size_t i = 0; i < inputs.size(); i++) {
+        if (auto function = server.registerFunction(inputs[i])) {
+            cerr << "function " << i << " has id " << function->first << "\n";
+        }
+    }
+    if (!server.listen(options.socket)) {
+        cerr << "error: cannot listen on " << options.socket << endl;
+        return 1;
+    }
 
-    auto res1 = func1(params1);
+    // The signals are received by a thread of their own, which stops the event loop
+    thread waiter([&server, signals] {
+        int signal = 0;
+        sigwait(&signals, &signal);
+        server.stop();
+    });
+    waiter.detach();
 
-    if (res1.has_value()) {
-        cout << "result func1 = " << res1.value() << endl;
+    cerr << "serving on " << options.socket << endl;
+    server.run();
+    ServerStatistics statistics = server.getStatistics();
+    cerr << "served " << statistics.requests << " requests of " << statistics.connections << " connections, " << statistics.functions << " functions were compiled for "
+         << statistics.registrations << " registrations" << endl;
+    return 0;
+}
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+// Compile all functions of the sources and evaluate the parameter rows
+int main(int argc, char** argv) {
+    optional<Options> options = parseOptions(argc, argv);
+    if (!options) {
+        printUsage(argv[0]);
+        return 1;
     }
 
-    auto res2 = func2(params2);
+    // The functions are lexed in place, so the mapped files have to outlive the handles
+    vector<MappedFile> files;
+    vector<string_view> inputs;
+    // Storage of the file of every input, an error names it
+    vector<string> inputPaths;
+    for (const auto& path : collectFiles(options->sources)) {
+        MappedFile file(path);
+        if (!file.isOpen()) {
+            cerr << "error: cannot read " << path << endl;
+            return 1;
+        }
+        vector<string_view> fileInputs = Pljit::splitBundle(file.getContents());
+        inputs.insert(inputs.end(), fileInputs.begin(), fileInputs.end());
+        inputPaths.insert(inputPaths.end(), fileInputs.size(), path);
+        files.push_back(move(file));
+    }
 
-    if (res2.has_value()) {
-        cout << "result func2 = " << res2.value() << endl;
+    if (!options->socket.empty()) {
+        return serve(*options, inputs);
     }
 
-    auto res3 = func3(params3);
+    ThreadPool pool(options->threads);
+    Pljit jit;
+    auto compileBegin = chrono::steady_clock::now();
+    vector<unique_ptr<PljitHandle>> handles = jit.registerFunctions(pool, inputs, options->level, options->arithmetic);
+    double compileSeconds = secondsSince(compileBegin);
+    // A call of a function that did not compile would compile it again and repeat its diagnostics, so its rows fail without a call
+    vector<bool> available(handles.size());
+    for (size_t i = 0; i < handles.size(); i++) {
+        if (!handles[i]->isCompiled()) {
+            cerr << inputPaths[i] << ": error: function " << i << " does not compile" << endl;
+            continue;
+        }
+        handles[i]->setFuelLimit(options->fuel);
+        handles[i]->finalize();
+        available[i] = true;
+    }
+    size_t compiled = count(available.begin(), available.end(), true);
 
-    if (res3.has_value()) {
-        cout << "result func3 = " << res3.value() << endl;
+    if (!options->output.empty()) {
+        return stream(*options, handles, pool);
     }
+
+    optional<MappedFile> parameterFile;
+    string standardInput;
+    string_view input;
+    if (options->parameters.empty()) {
+        standardInput.assign(istreambuf_iterator<char>(cin), istreambuf_iterator<char>());
+        input = standardInput;
+    } else {
+        parameterFile.emplace(options->parameters);
+        if (!parameterFile->isOpen()) {
+            cerr << "error: cannot read " << options->parameters << endl;
+            return 1;
+        }
+        input = parameterFile->getContents();
+    }
+    vector<Row> rows = parseRows(input, !options->function);
+    if (options->function) {
+        for (auto& row : rows) {
+            row.function = *options->function;
+        }
+    }
+
+    // The rows are evaluated in morsels on the pool, the results are written in the order of the rows
+    auto evaluateBegin = chrono::steady_clock::now();
+    vector<optional<int64_t>> results(rows.size());
+    vector<future<void>> morsels;
+    for (size_t first = 0; first < rows.size(); first += options->morselSize) {
+        size_t last = min(first + options->morselSize, rows.size());
+        morsels.push_back(pool.submit([&rows, &results, &handles, &available, first, last] {
+            for (size_t i = first; i < last; i++) {
+                const Row& row = rows[i];
+                if (row.valid && row.function < handles.size() && available[row.function]) {
+                    results[i] = (*handles[row.function])(span<const int64_t>(row.parameters));
+                }
+            }
+        }));
+    }
+    for (auto& morsel : morsels) {
+        morsel.get();
+    }
+    double evaluateSeconds = secondsSince(evaluateBegin);
+
+    size_t errors = 0;
+    {
+        OutputBuffer output;
+        for (const auto& result : results) {
+            output.append(result);
+            errors += !result.has_value();
+        }
+    }
+    fflush(stdout);
+
+    cerr << "compiled " << compiled << " of " << handles.size() << " functions in " << compileSeconds * 1000 << " ms ("
+         << static_cast<double>(handles.size()) / max(compileSeconds, 1e-9) << " functions/s)\n"
+         << "evaluated " << rows.size() << " rows with " << errors << " errors in " << evaluateSeconds * 1000 << " ms ("
+         << static_cast<double>(rows.size()) / max(evaluateSeconds, 1e-9) << " rows/s)" << endl;
+    return compiled == handles.size() && errors == 0 ? 0 : 2;
 }
+//---------------------------------------------------------------------------
@@ -67,7 +67,7 @@ Identifier Parsing::identifier() {
 // Parse a primary expression
 PrimaryExpression Parsing::primary_expression() {
     ParseTreeNode::Type data;
-    vector<shared_ptr<ParseTreeNode>> children;
+    ChildVector<shared_ptr<ParseTreeNode>> children(resource);
     Reference ref;
 
     Identifier id = identifier();
@@ -78,9 +78,9 @@ PrimaryExpression Parsing::primary_expression() {
 
     if (id.success()) {
         data = ParseTreeNode::Type::Identifier;
-        children.push_back(make_shared<Identifier>(id));
+        children.push_back(allocateNode<Identifier>(id));
         ref = id.reference();
-        return PrimaryExpression(ref, data, children);
+        return PrimaryExpression(ref, data, move(children));
     }
 
     Literal l = literal();
@@ -91,9 +91,9 @@ PrimaryExpression Parsing::primary_expression() {
 
     if (l.success()) {
         data = ParseTreeNode::Type::Literal;
-        children.push_back(make_shared<Literal>(l));
+        children.push_back(allocateNode<Literal>(l));
         ref = l.reference();
-        return PrimaryExpression(ref, data, children);
+        return PrimaryExpression(ref, data, move(children));
     }
 
     TerminalSymbol leftParan = match(Token::TokenType::LeftParanthesis);
@@ -118,15 +118,15 @@ PrimaryExpression Parsing::primary_expression() {
 
         if (rightParan.success()) {
             data = ParseTreeNode::Type::AdditiveExpression;
-            children.push_back(make_shared<TerminalSymbol>(leftParan));
-            children.push_back(make_shared<AdditiveExpression>(additiveExpression));
-            children.push_back(make_shared<TerminalSymbol>(rightParan));
+            children.push_back(allocateNode<TerminalSymbol>(leftParan));
+            children.push_back(allocateNode<AdditiveExpression>(additiveExpression));
+            children.push_back(allocateNode<TerminalSymbol>(rightParan));
             ref.length = rightParan.reference().begin + 1 - ref.begin;
         } else {
             codeM->errorMissingEndParanthesis(currentToken.reference());
             return PrimaryExpression(true);
         }
-        return PrimaryExpression(ref, data, children);
+        return PrimaryExpression(ref, data, move(children));
     }
 
     codeM->errorInvalidPrimaryExpr(currentToken.reference());
@@ -189,7 +189,7 @@ MultiplicativeExpression Parsing::multiplicative_expression() {
             return MultiplicativeExpression(true);
         }
 
-        mulExpr = make_shared<MultiplicativeExpression>(move(mul));
+        mulExpr = allocateNode<MultiplicativeExpression>(move(mul));
 
     } else {
         terminalSymbol = match(Token::TokenType::DivOperator);
@@ -199,7 +199,7 @@ MultiplicativeExpression Parsing::multiplicative_expression() {
             if (mul.errorOccurred()) {
                 return MultiplicativeExpression(true);
             }
-            mulExpr = make_shared<MultiplicativeExpression>(move(mul));
+            mulExpr = allocateNode<MultiplicativeExpression>(move(mul));
 
         } else {
             terminalSymbol = nullopt;
@@ -231,7 +231,7 @@ AdditiveExpression Parsing::additive_expression() {
         if (add.errorOccurred()) {
             return AdditiveExpression(true);
         }
-        addExpr = make_shared<AdditiveExpression>(move(add));
+        addExpr = allocateNode<AdditiveExpression>(move(add));
 
     } else {
         terminalSymbol = match(Token::TokenType::BinaryMinusOperator);
@@ -241,7 +241,7 @@ AdditiveExpression Parsing::additive_expression() {
             if (add.errorOccurred()) {
                 return AdditiveExpression(true);
             }
-            addExpr = make_shared<AdditiveExpression>(add);
+            addExpr = allocateNode<AdditiveExpression>(add);
         } else {
             terminalSymbol = nullopt;
             addExpr = nullopt;
@@ -284,7 +284,7 @@ AssignmentExpression Parsing::assignment_expression() {
 Statement Parsing::statement() {
     Reference ref;
     ParseTreeNode::Type data;
-    vector<shared_ptr<ParseTreeNode>> children;
+    ChildVector<shared_ptr<ParseTreeNode>> children(resource);
 
     if (currentToken.tokenType() == Token::TokenType::EndKeyword) {
         codeM->errorEndline(currentToken.reference());
@@ -298,14 +298,14 @@ Statement Parsing::statement() {
     }
 
     if (ret.success()) {
-        children.push_back(make_shared<TerminalSymbol>(ret));
+        children.push_back(allocateNode<TerminalSymbol>(ret));
         AdditiveExpression additiveExpression = additive_expression();
 
         if (additiveExpression.errorOccurred()) {
             return Statement(true);
         }
 
-        children.push_back(make_shared<AdditiveExpression>(additiveExpression));
+        children.push_back(allocateNode<AdditiveExpression>(additiveExpression));
         data = ParseTreeNode::Type::AdditiveExpression;
         ref.begin = ret.reference().begin;
         ref.length = additiveExpression.reference().length + additiveExpression.reference().begin - ret.reference().begin;
@@ -315,18 +315,18 @@ Statement Parsing::statement() {
             return Statement(true);
         }
 
-        children.push_back(make_shared<AssignmentExpression>(assignmentExpression));
+        children.push_back(allocateNode<AssignmentExpression>(assignmentExpression));
         data = ParseTreeNode::Type::AssignmentExpression;
         ref = assignmentExpression.reference();
     }
-    return Statement(ref, data, children);
+    return Statement(ref, data, move(children));
 }
 //---------------------------------------------------------------------------
 // Parse a statement list
 StatementList Parsing::statement_list() {
     Reference ref;
     Statement stmt;
-    vector<pair<TerminalSymbol, Statement>> children;
+    ChildVector<pair<TerminalSymbol, Statement>> children(resource);
 
     stmt = statement();
 
@@ -348,21 +348,21 @@ StatementList Parsing::statement_list() {
             return StatementList(true);
         }
 
-        children.emplace_back(pair<TerminalSymbol, Statement>(t, st));
+        children.emplace_back(t, move(st));
         ref.length = st.reference().length + st.reference().begin - ref.begin;
         t = match(Token::TokenType::EndLineSeparator);
         if (t.errorOccurred()) {
             return StatementList(true);
         }
     }
-    return StatementList(ref, stmt, children);
+    return StatementList(ref, move(stmt), move(children));
 }
 //---------------------------------------------------------------------------
 // Parse a declarator list
 DeclaratorList Parsing::declarator_list() {
     Reference ref;
     Identifier identif;
-    vector<pair<TerminalSymbol, Identifier>> children;
+    ChildVector<pair<TerminalSymbol, Identifier>> children(resource);
 
     identif = identifier();
 
@@ -394,7 +394,7 @@ DeclaratorList Parsing::declarator_list() {
             return DeclaratorList(true);
         }
 
-        children.emplace_back(pair<TerminalSymbol, Identifier>(t, id));
+        children.emplace_back(t, id);
         ref.length = id.reference().length + id.reference().begin - ref.begin;
         t = match(Token::TokenType::CommaSeparator);
 
@@ -402,7 +402,7 @@ DeclaratorList Parsing::declarator_list() {
             return DeclaratorList(true);
         }
     }
-    return DeclaratorList(ref, identif, children);
+    return DeclaratorList(ref, identif, move(children));
 }
 //---------------------------------------------------------------------------
 // Parse an init declarator
@@ -451,7 +451,7 @@ InitDeclarator Parsing::init_declarator() {
 InitDeclaratorList Parsing::initdeclarator_list() {
     Reference ref;
     InitDeclarator initDeclarator;
-    vector<pair<TerminalSymbol, InitDeclarator>> children;
+    ChildVector<pair<TerminalSymbol, InitDeclarator>> children(resource);
 
     initDeclarator = init_declarator();
 
@@ -473,7 +473,7 @@ InitDeclaratorList Parsing::initdeclarator_list() {
             return InitDeclaratorList(true);
         }
 
-        children.emplace_back(pair<TerminalSymbol, InitDeclarator>(t, init));
+        children.emplace_back(t, init);
         ref.length = init.reference().length + init.reference().begin - ref.begin;
         t = match(Token::TokenType::CommaSeparator);
 
@@ -481,7 +481,7 @@ InitDeclaratorList Parsing::initdeclarator_list() {
             return InitDeclaratorList(true);
         }
     }
-    return InitDeclaratorList(ref, initDeclarator, children);
+    return InitDeclaratorList(ref, initDeclarator, move(children));
 }
 //---------------------------------------------------------------------------
 // Parse the parameter declarations
@@ -721,6 +721,20 @@ void Parsing::parsing() {
     }
 }
 //---------------------------------------------------------------------------
+// Parse only a list of statements
+void Parsing::parsingStatements() {
+    currentToken = lex.next();
+    statementList = statement_list();
+    if (statementList.errorOccurred()) {
+        error = true;
+        return;
+    }
+    if (currentToken.tokenType() != Token::TokenType::Dot) {
+        codeM->errorAnalyzingStatements(currentToken.reference());
+        error = true;
+    }
+}
+//---------------------------------------------------------------------------
 // Compute the actual value of a literal
 int64_t Parsing::computeVal(Reference ref) {
     string_view str = codeM->getCharacters(ref);
@@ -2,6 +2,7 @@
 #define H_PLJIT_PARSER
 #include "pljit/lexer/Lexer.hpp"
 #include "pljit/parsetree/ParseTree.hpp"
+#include <memory_resource>
 using namespace pljit::lexer;
 using namespace pljit::parsetree;
 //---------------------------------------------------------------------------
@@ -10,14 +11,20 @@ namespace pljit::parser {
 /// Class that represents the parser (MILESTONE 3)
 class Parsing {
     public:
-    /// Constructor
-    Parsing(Lexer& lex, shared_ptr<CodeManagement> codeM) : lex(lex), codeM(move(codeM)) {}
+    /// Constructor, the nodes of the parse tree are allocated from the memory resource, it has to outlive the parser
+    Parsing(Lexer& lex, shared_ptr<CodeManagement> codeM, pmr::memory_resource* resource = pmr::get_default_resource()) : lex(lex), codeM(move(codeM)), resource(resource) {}
     /// Start the parsing
     void parsing();
+    /// Parse only a list of statements, the code of the lexer has to end with a dot after the last statement
+    void parsingStatements();
     /// Get the parse tree structure
     const FunctionDefinition& getTree() const { return funcDef; }
+    /// Get the statements parsed by parsingStatements
+    const StatementList& getStatementList() const { return statementList; }
     /// Return whether an error occurred during parsing
     bool errorOccurred() const { return error; }
+    /// Get the lexer
+    const Lexer& getLexer() const { return lex; }
 
     private:
     /// Functions that parse a specific node from the grammer given the code
@@ -41,14 +48,21 @@ class Parsing {
     Literal literal();
     /// Compute the actual value of a literal
     int64_t computeVal(Reference ref);
+    /// Move a node of the parse tree into the memory resource
+    template <typename T>
+    shared_ptr<T> allocateNode(T node) { return allocate_shared<T>(pmr::polymorphic_allocator<T>(resource), move(node)); }
     /// Storage of whether an error occurred during parsing
     bool error = false;
     /// Storage of the lexer
     Lexer lex;
     /// Storage of the code management unit
     shared_ptr<CodeManagement> codeM;
+    /// Storage of the memory resource of the parse tree
+    pmr::memory_resource* resource;
     /// Storage of the parse tree
     FunctionDefinition funcDef;
+    /// Storage of the statements parsed by parsingStatements
+    StatementList statementList;
     /// Storage of the current token from the lexer
     Token currentToken;
 };
@@ -46,7 +46,7 @@ PrimaryExpression::PrimaryExpression(bool error) : ParseTreeNode(error) {
 }
 //---------------------------------------------------------------------------
 // Constructor with given children nodes
-PrimaryExpression::PrimaryExpression(Reference ref, ParseTreeNode::Type data, vector<shared_ptr<ParseTreeNode>> children)
+PrimaryExpression::PrimaryExpression(Reference ref, ParseTreeNode::Type data, ChildVector<shared_ptr<ParseTreeNode>> children)
     : ParseTreeNode(ref), data(data), children(move(children)) {
 }
 //---------------------------------------------------------------------------
@@ -116,7 +116,7 @@ Statement::Statement(bool error) : ParseTreeNode(error) {
 }
 //---------------------------------------------------------------------------
 // Constructor with given children nodes
-Statement::Statement(Reference ref, ParseTreeNode::Type data, vector<shared_ptr<ParseTreeNode>> children)
+Statement::Statement(Reference ref, ParseTreeNode::Type data, ChildVector<shared_ptr<ParseTreeNode>> children)
     : ParseTreeNode(ref), data(data), children(move(children)) {
 }
 //---------------------------------------------------------------------------
@@ -126,7 +126,7 @@ void Statement::accept(ParseTreeVisitor& visitor) const {
 }
 //---------------------------------------------------------------------------
 // Constructor with given children nodes
-StatementList::StatementList(Reference ref, Statement statement, vector<pair<TerminalSymbol, Statement>> children)
+StatementList::StatementList(Reference ref, Statement statement, ChildVector<pair<TerminalSymbol, Statement>> children)
     : ParseTreeNode(ref), statement(move(statement)), children(move(children)) {
 }
 //---------------------------------------------------------------------------
@@ -144,7 +144,7 @@ DeclaratorList::DeclaratorList(bool error) : ParseTreeNode(error) {
 }
 //---------------------------------------------------------------------------
 // Constructor with given children nodes
-DeclaratorList::DeclaratorList(Reference ref, Identifier identifier, vector<pair<TerminalSymbol, Identifier>> children)
+DeclaratorList::DeclaratorList(Reference ref, Identifier identifier, ChildVector<pair<TerminalSymbol, Identifier>> children)
     : ParseTreeNode(ref), identifier(move(identifier)), children(move(children)) {
 }
 //---------------------------------------------------------------------------
@@ -172,7 +172,7 @@ InitDeclaratorList::InitDeclaratorList(bool error) : ParseTreeNode(error) {
 }
 //---------------------------------------------------------------------------
 // Constructor with given children nodes
-InitDeclaratorList::InitDeclaratorList(Reference ref, InitDeclarator initDeclarator, vector<pair<TerminalSymbol, InitDeclarator>> children)
+InitDeclaratorList::InitDeclaratorList(Reference ref, InitDeclarator initDeclarator, ChildVector<pair<TerminalSymbol, InitDeclarator>> children)
     : ParseTreeNode(ref), initDeclarator(move(initDeclarator)), children(move(children)) {
 }
 //---------------------------------------------------------------------------
@@ -3,12 +3,42 @@
 #include "pljit/codem/Reference.hpp"
 #include "pljit/parsetree/ParseTreeVisitor.hpp"
 #include <memory>
+#include <memory_resource>
+#include <optional>
 #include <vector>
 using namespace std;
 using namespace pljit::codemanagement;
 //---------------------------------------------------------------------------
 namespace pljit::parsetree {
 //---------------------------------------------------------------------------
+/// Allocator of the children of the parse tree nodes, a copied or moved node keeps the memory resource of its children
+template <typename T>
+class ParseTreeAllocator {
+    public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = true_type;
+    using propagate_on_container_move_assignment = true_type;
+    using propagate_on_container_swap = true_type;
+    /// Constructors
+    ParseTreeAllocator(pmr::memory_resource* resource = pmr::get_default_resource()) : resource(resource) {}
+    template <typename U>
+    ParseTreeAllocator(const ParseTreeAllocator<U>& other) : resource(other.getResource()) {}
+    /// Allocate and deallocate memory for n values
+    T* allocate(size_t n) { return static_cast<T*>(resource->allocate(n * sizeof(T), alignof(T))); }
+    void deallocate(T* p, size_t n) { resource->deallocate(p, n * sizeof(T), alignof(T)); }
+    /// Get the memory resource
+    pmr::memory_resource* getResource() const { return resource; }
+    /// Compare two allocators
+    bool operator==(const ParseTreeAllocator& other) const { return *resource == *other.resource; }
+
+    private:
+    /// Storage of the memory resource
+    pmr::memory_resource* resource;
+};
+/// Vector of the children of a parse tree node
+template <typename T>
+using ChildVector = vector<T, ParseTreeAllocator<T>>;
+//---------------------------------------------------------------------------
 /// class to represent a node in the parse tree (MILESTONE 3)
 class ParseTreeNode {
     public:
@@ -117,12 +147,12 @@ class PrimaryExpression : public ParseTreeNode {
     /// Constructors
     PrimaryExpression() = default;
     explicit PrimaryExpression(bool error);
-    PrimaryExpression(Reference ref, ParseTreeNode::Type data, vector<shared_ptr<ParseTreeNode>> children);
+    PrimaryExpression(Reference ref, ParseTreeNode::Type data, ChildVector<shared_ptr<ParseTreeNode>> children);
     /// Overridden getType function
     ParseTreeNode::Type getType() const override { return ParseTreeNode::Type::PrimaryExpression; }
     /// Getters
     const ParseTreeNode::Type& getData() const { return data; }
-    const vector<shared_ptr<ParseTreeNode>>& getChildren() const { return children; }
+    const ChildVector<shared_ptr<ParseTreeNode>>& getChildren() const { return children; }
     /// Overridden accept function
     void accept(ParseTreeVisitor& visitor) const override;
 
@@ -130,7 +160,7 @@ class PrimaryExpression : public ParseTreeNode {
     /// Storage of the type of the primary expression
     ParseTreeNode::Type data;
     /// Storage of the different children
-    vector<shared_ptr<ParseTreeNode>> children;
+    ChildVector<shared_ptr<ParseTreeNode>> children;
 };
 //---------------------------------------------------------------------------
 class UnaryExpression : public ParseTreeNode {
@@ -231,12 +261,12 @@ class Statement : public ParseTreeNode {
     /// Constructors
     Statement() = default;
     explicit Statement(bool error);
-    Statement(Reference ref, ParseTreeNode::Type data, vector<shared_ptr<ParseTreeNode>> children);
+    Statement(Reference ref, ParseTreeNode::Type data, ChildVector<shared_ptr<ParseTreeNode>> children);
     /// Overridden getType function
     ParseTreeNode::Type getType() const override { return ParseTreeNode::Type::Statement; }
     /// Getters
     const ParseTreeNode::Type& getData() const { return data; }
-    const vector<shared_ptr<ParseTreeNode>>& getChildren() const { return children; }
+    const ChildVector<shared_ptr<ParseTreeNode>>& getChildren() const { return children; }
     //const Reference& reference() const { return ref; }
     /// Overridden accept function
     void accept(ParseTreeVisitor& visitor) const override;
@@ -245,7 +275,7 @@ class Statement : public ParseTreeNode {
     /// Storage of the different data types of the node
     ParseTreeNode::Type data;
     /// Storage of the children of the node
-    vector<shared_ptr<ParseTreeNode>> children;
+    ChildVector<shared_ptr<ParseTreeNode>> children;
 };
 //---------------------------------------------------------------------------
 class StatementList : public ParseTreeNode {
@@ -253,12 +283,12 @@ class StatementList : public ParseTreeNode {
     /// Constructors
     StatementList() = default;
     explicit StatementList(bool error);
-    StatementList(Reference ref, Statement statement, vector<pair<TerminalSymbol, Statement>> children);
+    StatementList(Reference ref, Statement statement, ChildVector<pair<TerminalSymbol, Statement>> children);
     /// Overridden getType function
     ParseTreeNode::Type getType() const override { return ParseTreeNode::Type::StatementList; }
     /// Getters
     const Statement& getStatement() const { return statement; }
-    const vector<pair<TerminalSymbol, Statement>>& getChildren() const { return children; }
+    const ChildVector<pair<TerminalSymbol, Statement>>& getChildren() const { return children; }
     /// Overridden accept function
     void accept(ParseTreeVisitor& visitor) const override;
 
@@ -266,7 +296,7 @@ class StatementList : public ParseTreeNode {
     /// Storage of a statement
     Statement statement;
     /// Storage of possible following statements
-    vector<pair<TerminalSymbol, Statement>> children;
+    ChildVector<pair<TerminalSymbol, Statement>> children;
 };
 //---------------------------------------------------------------------------
 class DeclaratorList : public ParseTreeNode {
@@ -274,12 +304,12 @@ class DeclaratorList : public ParseTreeNode {
     /// Constructors
     DeclaratorList() = default;
     explicit DeclaratorList(bool error);
-    DeclaratorList(Reference ref, Identifier identifier, vector<pair<TerminalSymbol, Identifier>> children);
+    DeclaratorList(Reference ref, Identifier identifier, ChildVector<pair<TerminalSymbol, Identifier>> children);
     /// Overriden function
     ParseTreeNode::Type getType() const override { return ParseTreeNode::Type::DeclaratorList; }
     /// Getters
     const Identifier& getIdentifier() const { return identifier; }
-    const vector<pair<TerminalSymbol, Identifier>>& getChildren() const { return children; }
+    const ChildVector<pair<TerminalSymbol, Identifier>>& getChildren() const { return children; }
     /// Overridden accept function
     void accept(ParseTreeVisitor& visitor) const override;
 
@@ -287,7 +317,7 @@ class DeclaratorList : public ParseTreeNode {
     /// Storage of an identifier
     Identifier identifier;
     /// Storage of possible following indentifiers
-    vector<pair<TerminalSymbol, Identifier>> children;
+    ChildVector<pair<TerminalSymbol, Identifier>> children;
 };
 //---------------------------------------------------------------------------
 class InitDeclarator : public ParseTreeNode {
@@ -319,12 +349,12 @@ class InitDeclaratorList : public ParseTreeNode {
     /// Constructors
     InitDeclaratorList() = default;
     explicit InitDeclaratorList(bool error);
-    InitDeclaratorList(Reference ref, InitDeclarator initDeclarator, vector<pair<TerminalSymbol, InitDeclarator>> children);
+    InitDeclaratorList(Reference ref, InitDeclarator initDeclarator, ChildVector<pair<TerminalSymbol, InitDeclarator>> children);
     /// Overridden getType function
     ParseTreeNode::Type getType() const override { return ParseTreeNode::Type::InitDeclaratorList; }
     /// Getters
     const InitDeclarator& getInitDecl() const { return initDeclarator; }
-    const vector<pair<TerminalSymbol, InitDeclarator>> getChildren() const { return children; }
+    const ChildVector<pair<TerminalSymbol, InitDeclarator>> getChildren() const { return children; }
     //const Reference& reference() const { return ref; }
     /// Overridden accept function
     void accept(ParseTreeVisitor& visitor) const override;
@@ -333,7 +363,7 @@ class InitDeclaratorList : public ParseTreeNode {
     /// Storage of an init declarator
     InitDeclarator initDeclarator;
     /// Storage of possible following init declarators
-    vector<pair<TerminalSymbol, InitDeclarator>> children;
+    ChildVector<pair<TerminalSymbol, InitDeclarator>> children;
 };
 //---------------------------------------------------------------------------
 class Declarations : public ParseTreeNode {
@@ -110,10 +110,32 @@ bool SemanticAnalysis::errorAnalyzeStatement(vector<unique_ptr<ASTNode>>& funcSt
         existingReturn = true;
     }
 
-    funcStatements.push_back(make_unique<ASTStatement>(move(astStatement)));
+    astStatement.setSourceIndex(funcStatements.size());
+    funcStatements.push_back(allocateNode<ASTStatement>(resource, move(astStatement)));
     return false;
 }
 //---------------------------------------------------------------------------
+// Return whether an error occurred whilst analyzing a list of statements
+bool SemanticAnalysis::errorAnalyzeStatementList(vector<unique_ptr<ASTNode>>& funcStatements, const StatementList& statementList) {
+    if (errorAnalyzeStatement(funcStatements, statementList.getStatement())) {
+        return true;
+    }
+
+    for (const auto& child : statementList.getChildren()) {
+        const auto& [t, st] = child;
+        if (errorAnalyzeStatement(funcStatements, st)) {
+            return true;
+        }
+    }
+    return false;
+}
+//---------------------------------------------------------------------------
+// Return whether an error occurred whilst analyzing statements in the scope of the symbol table
+bool SemanticAnalysis::errorAnalyzeStatements(const StatementList& statementList, SymbolTable scope, vector<unique_ptr<ASTNode>>& funcStatements) {
+    symbolTable = move(scope);
+    return errorAnalyzeStatementList(funcStatements, statementList);
+}
+//---------------------------------------------------------------------------
 // Return an ast node representing a function
 Function SemanticAnalysis::analyzeFunction(const FunctionDefinition& functionDefinition) {
     if (errorAnalyzeParameters(functionDefinition)) {
@@ -128,25 +150,15 @@ Function SemanticAnalysis::analyzeFunction(const FunctionDefinition& functionDef
         return Function(true);
     }
 
+    declarations = symbolTable;
+
     const StatementList& statementList = functionDefinition.getCompoundStatement().getStatementList();
-    const Statement& statement = statementList.getStatement();
     vector<unique_ptr<ASTNode>> funcStatements;
 
-    if (errorAnalyzeStatement(funcStatements, statement)) {
+    if (errorAnalyzeStatementList(funcStatements, statementList)) {
         return Function(true);
     }
 
-    const auto& statements = statementList.getChildren();
-
-    if (!statements.empty()) {
-        for (const auto& child : statements) {
-            const auto& [t, st] = child;
-            if (errorAnalyzeStatement(funcStatements, st)) {
-                return Function(true);
-            }
-        }
-    }
-
     if (!existingReturn) {
         codeM->errorMissingReturn();
         return Function(true);
@@ -156,22 +168,22 @@ Function SemanticAnalysis::analyzeFunction(const FunctionDefinition& functionDef
 }
 //---------------------------------------------------------------------------
 // Return whether an error occurred whilst analyzing an assignment expression
-bool SemanticAnalysis::errorAnalyzeAssignmentExpression(const vector<shared_ptr<ParseTreeNode>>& parseExpr, unique_ptr<ASTNode>& astExpr) {
+bool SemanticAnalysis::errorAnalyzeAssignmentExpression(const ChildVector<shared_ptr<ParseTreeNode>>& parseExpr, unique_ptr<ASTNode>& astExpr) {
     AssignmentExpr assignmentExpr = analyzeAssignmentExpression(parseExpr[0]);
     if (assignmentExpr.errorOccurred()) {
         return true;
     }
-    astExpr = make_unique<AssignmentExpr>(move(assignmentExpr));
+    astExpr = allocateNode<AssignmentExpr>(resource, move(assignmentExpr));
     return false;
 }
 //---------------------------------------------------------------------------
 // Return whether an error occurred whilst analyzing a return expression
-bool SemanticAnalysis::errorAnalyzeReturnExpression(const vector<shared_ptr<ParseTreeNode>>& parseExpr, unique_ptr<ASTNode>& astExpr) {
+bool SemanticAnalysis::errorAnalyzeReturnExpression(const ChildVector<shared_ptr<ParseTreeNode>>& parseExpr, unique_ptr<ASTNode>& astExpr) {
     ReturnExpr returnExpr = analyzeReturnExpression(parseExpr[1]);
     if (returnExpr.errorOccurred()) {
         return true;
     }
-    astExpr = make_unique<ReturnExpr>(move(returnExpr));
+    astExpr = allocateNode<ReturnExpr>(resource, move(returnExpr));
     return false;
 }
 //---------------------------------------------------------------------------
@@ -216,7 +228,14 @@ bool SemanticAnalysis::errorAnalyzeChildExpression(const MultiplicativeExpressio
 // Return whether an error occurred whilst analyzing a child of a unary expression
 bool SemanticAnalysis::errorAnalyzeChildExpression(const UnaryExpression& unaryExpression, const MultiplicativeExpression& multiplicativeExpression, unique_ptr<ASTNode>& child) {
     ASTNode::Type type = getTypeFromUnaryExpression(unaryExpression);
-    child = analyzeType(type, multiplicativeExpression);
+    const auto& children = unaryExpression.getPrimaryExpression().getChildren();
+
+    if (!unaryExpression.getTerminalSymbol().has_value() && children.size() > 1) { // operand is in parentheses
+        const auto& addexpr = static_cast<AdditiveExpression&>(*children[1]);
+        child = analyzeType(type, addexpr);
+    } else {
+        child = analyzeType(type, multiplicativeExpression);
+    }
     if (!child) {
         return true;
     }
@@ -257,7 +276,7 @@ bool SemanticAnalysis::errorAnalyzeParameter(const Identifier& identifier, uniqu
     if (p.errorOccurred()) {
         return true;
     }
-    ptr = make_unique<Parameter>(move(p));
+    ptr = allocateNode<Parameter>(resource, move(p));
     return false;
 }
 //---------------------------------------------------------------------------
@@ -430,7 +449,7 @@ bool SemanticAnalysis::errorAnalyzeUnary(const MultiplicativeExpression& multipl
     PrimaryExpression primaryExpression = multiplicativeExpression.getUnaryExpression().getPrimaryExpression();
     ASTNode::Type type = getTypeFromPrimaryExpression(primaryExpression);
 
-    if (type == ASTNode::Type::UnaryMinus || type == ASTNode::Type::UnaryPlus) {
+    if (primaryExpression.getChildren().size() > 1) { // operand is in parentheses
         const auto& children = primaryExpression.getChildren();
         const auto& add = children[1];
         const auto& addexpr = static_cast<AdditiveExpression&>(*add);
@@ -471,38 +490,26 @@ unique_ptr<ASTNode> SemanticAnalysis::analyzeType(ASTNode::Type type, const Mult
     switch (type) {
         case ASTNode::Type::Parameter: {
             Parameter parameter;
-            PrimaryExpression primaryExpression = multiplicativeExpression.getUnaryExpression().getPrimaryExpression();
+            const PrimaryExpression& primaryExpression = stripParentheses(multiplicativeExpression.getUnaryExpression().getPrimaryExpression());
             const auto& children = primaryExpression.getChildren();
             const auto& identifier = *static_cast<Identifier*>(children[0].get());
             parameter = analyzeParameter(identifier);
             if (parameter.errorOccurred()) {
                 return nullptr;
             }
-            return make_unique<Parameter>(move(parameter));
+            return allocateNode<Parameter>(resource, move(parameter));
         }
 
         case ASTNode::Type::Constant: {
             Constant constant;
-            PrimaryExpression primaryExpression = multiplicativeExpression.getUnaryExpression().getPrimaryExpression();
+            const PrimaryExpression& primaryExpression = stripParentheses(multiplicativeExpression.getUnaryExpression().getPrimaryExpression());
             const auto& children = primaryExpression.getChildren();
-            if (children.size() != 1) { // literal is inside primary
-                auto& addexpr = static_cast<AdditiveExpression&>(*children[1]);
-                PrimaryExpression primaryExpression1 = addexpr.getMultiplicativeExpression().getUnaryExpression().getPrimaryExpression();
-                const auto& children1 = primaryExpression1.getChildren();
-                const auto& literal = *static_cast<Literal*>(children1[0].get());
-                constant = analyzeConstant(literal);
-                if (constant.errorOccurred()) {
-                    return nullptr;
-                }
-                return make_unique<Constant>(move(constant));
-            } else {
-                const auto& literal = *static_cast<Literal*>(children[0].get());
-                constant = analyzeConstant(literal);
-                if (constant.errorOccurred()) {
-                    return nullptr;
-                }
-                return make_unique<Constant>(move(constant));
+            const auto& literal = *static_cast<Literal*>(children[0].get());
+            constant = analyzeConstant(literal);
+            if (constant.errorOccurred()) {
+                return nullptr;
             }
+            return allocateNode<Constant>(resource, move(constant));
         }
 
         case ASTNode::Type::UnaryPlus: {
@@ -510,7 +517,7 @@ unique_ptr<ASTNode> SemanticAnalysis::analyzeType(ASTNode::Type type, const Mult
             if (unaryPlus.errorOccurred()) {
                 return nullptr;
             }
-            return make_unique<UnaryPlus>(move(unaryPlus));
+            return allocateNode<UnaryPlus>(resource, move(unaryPlus));
         }
         case ASTNode::Type::UnaryMinus: {
             auto& children = multiplicativeExpression.getUnaryExpression().getPrimaryExpression().getChildren();
@@ -519,7 +526,7 @@ unique_ptr<ASTNode> SemanticAnalysis::analyzeType(ASTNode::Type type, const Mult
                 if (unaryMinus.errorOccurred()) {
                     return nullptr;
                 }
-                return make_unique<UnaryMinus>(move(unaryMinus));
+                return allocateNode<UnaryMinus>(resource, move(unaryMinus));
             } else {
                 auto add = children[1];
                 auto& addexpr = static_cast<AdditiveExpression&>(*add);
@@ -531,14 +538,14 @@ unique_ptr<ASTNode> SemanticAnalysis::analyzeType(ASTNode::Type type, const Mult
             if (mulExpr.errorOccurred()) {
                 return nullptr;
             }
-            return make_unique<MulExpr>(move(mulExpr));
+            return allocateNode<MulExpr>(resource, move(mulExpr));
         }
         case ASTNode::Type::DivExpr: {
             DivExpr divExpr = analyzeDivExpr(multiplicativeExpression);
             if (divExpr.errorOccurred()) {
                 return nullptr;
             }
-            return make_unique<DivExpr>(move(divExpr));
+            return allocateNode<DivExpr>(resource, move(divExpr));
         }
         default: {
             auto& children = multiplicativeExpression.getUnaryExpression().getPrimaryExpression().getChildren();
@@ -557,14 +564,14 @@ unique_ptr<ASTNode> SemanticAnalysis::analyzeType(ASTNode::Type type, const Addi
             if (addExpr.errorOccurred()) {
                 return nullptr;
             }
-            return make_unique<AddExpr>(move(addExpr));
+            return allocateNode<AddExpr>(resource, move(addExpr));
         }
         case ASTNode::Type::SubtractExpr: {
             SubtractExpr subtractExpr = analyzeSubtractExpr(additiveExpression);
             if (subtractExpr.errorOccurred()) {
                 return nullptr;
             }
-            return make_unique<SubtractExpr>(move(subtractExpr));
+            return allocateNode<SubtractExpr>(resource, move(subtractExpr));
         }
         default: {
             return analyzeType(type, additiveExpression.getMultiplicativeExpression());
@@ -572,6 +579,16 @@ unique_ptr<ASTNode> SemanticAnalysis::analyzeType(ASTNode::Type type, const Addi
     }
 }
 //---------------------------------------------------------------------------
+// Return the primary expression inside redundant parentheses around an identifier or a literal
+const PrimaryExpression& SemanticAnalysis::stripParentheses(const PrimaryExpression& primaryExpression) {
+    const PrimaryExpression* primary = &primaryExpression;
+    while (primary->getData() != ParseTreeNode::Type::Identifier && primary->getData() != ParseTreeNode::Type::Literal) {
+        const auto& addexpr = static_cast<const AdditiveExpression&>(*primary->getChildren()[1]);
+        primary = &addexpr.getMultiplicativeExpression().getUnaryExpression().getPrimaryExpression();
+    }
+    return *primary;
+}
+//---------------------------------------------------------------------------
 // Return the type the ast node should have
 ASTNode::Type SemanticAnalysis::getTypeFromPrimaryExpression(const PrimaryExpression& primaryExpression) {
     if (primaryExpression.getData() == ParseTreeNode::Type::Identifier) {
@@ -10,10 +10,14 @@ namespace pljit::semanticanalysis {
 /// Class that represents the semantic analysis given a parse tree (MILESTONE 4)
 class SemanticAnalysis {
     public:
-    /// Constructor
-    explicit SemanticAnalysis(shared_ptr<CodeManagement> codeM) : codeM(move(codeM)) {}
+    /// Constructor, the nodes and symbol tables of the ast are allocated from the memory resource, it has to outlive the ast
+    explicit SemanticAnalysis(shared_ptr<CodeManagement> codeM, pmr::memory_resource* resource = pmr::get_default_resource()) : symbolTable(resource), declarations(resource), codeM(move(codeM)), resource(resource) {}
     /// Return the ast
     Function getAST(const Parsing& parser);
+    /// Return the declared symbols of the last analyzed function before any statement was analyzed
+    const SymbolTable& getDeclarations() const { return declarations; }
+    /// Return whether an error occurred whilst analyzing statements in the scope of the symbol table, the ast of every statement is appended
+    bool errorAnalyzeStatements(const StatementList& statementList, SymbolTable scope, vector<unique_ptr<ASTNode>>& funcStatements);
 
     private:
     /// Functions that return whether an error occurred during the semantic analysis
@@ -21,8 +25,9 @@ class SemanticAnalysis {
     bool errorAnalyzeVariables(const FunctionDefinition& functionDefinition);
     bool errorAnalyzeConstants(const FunctionDefinition& functionDefinition);
     bool errorAnalyzeStatement(vector<unique_ptr<ASTNode>>& funcStatements, const Statement& statement);
-    bool errorAnalyzeAssignmentExpression(const vector<shared_ptr<ParseTreeNode>>& parseExpr, unique_ptr<ASTNode>& astExpr);
-    bool errorAnalyzeReturnExpression(const vector<shared_ptr<ParseTreeNode>>& parseExpr, unique_ptr<ASTNode>& astExpr);
+    bool errorAnalyzeStatementList(vector<unique_ptr<ASTNode>>& funcStatements, const StatementList& statementList);
+    bool errorAnalyzeAssignmentExpression(const ChildVector<shared_ptr<ParseTreeNode>>& parseExpr, unique_ptr<ASTNode>& astExpr);
+    bool errorAnalyzeReturnExpression(const ChildVector<shared_ptr<ParseTreeNode>>& parseExpr, unique_ptr<ASTNode>& astExpr);
     bool errorAnalyzeChildExpression(const AdditiveExpression& additiveExpression, unique_ptr<ASTNode>& child);
     bool errorAnalyzeChildExpression(const MultiplicativeExpression& multiplicativeExpression, unique_ptr<ASTNode>& child);
     bool errorAnalyzeChildExpression(const UnaryExpression& unaryExpression, const MultiplicativeExpression& multiplicativeExpression, unique_ptr<ASTNode>& child);
@@ -47,15 +52,21 @@ class SemanticAnalysis {
     ASTNode::Type getTypeFromUnaryExpression(const UnaryExpression& unaryExpression);
     ASTNode::Type getTypeFromMultiplicativeExpression(const MultiplicativeExpression& multiplicativeExpression);
     ASTNode::Type getTypeFromAdditiveExpression(const AdditiveExpression& additiveExpression);
+    /// Return the primary expression inside redundant parentheses around an identifier or a literal
+    static const PrimaryExpression& stripParentheses(const PrimaryExpression& primaryExpression);
     /// Functions that analyze and return an ast node, given the type of the ast node and a parse tree node
     unique_ptr<ASTNode> analyzeType(ASTNode::Type type, const AdditiveExpression& additiveExpression);
     unique_ptr<ASTNode> analyzeType(ASTNode::Type type, const MultiplicativeExpression& multiplicativeExpression);
     /// Storage of the symbol table
     SymbolTable symbolTable;
+    /// Storage of the symbol table after the declarations
+    SymbolTable declarations;
     /// Storage of whether there exists a return statement in the program
     bool existingReturn = false;
     /// Storage of the code management unit
     shared_ptr<CodeManagement> codeM;
+    /// Storage of the memory resource of the ast
+    pmr::memory_resource* resource;
 };
 //---------------------------------------------------------------------------
 } // namespace pljit::semanticanalysis
@@ -0,0 +1,173 @@
+#include "test/ProgramGenerator.hpp"
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+/// Largest absolute value of a subexpression
+constexpr int64_t maxIntermediate = int64_t(1) << 31;
+/// Largest absolute value of an assigned variable
+constexpr int64_t maxVariable = int64_t(1) << 20;
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+// Constructor
+ProgramGenerator::ProgramGenerator(ProgramShape shape) : shape(shape), random(shape.seed) {}
+//---------------------------------------------------------------------------
+// Return the name of an identifier, identifiers consist of letters only
+string ProgramGenerator::getName(char prefix, size_t index) {
+    string name(1, prefix);
+    do {
+        name += static_cast<char>('a' + index % 26);
+        index /= 26;
+    } while (index > 0);
+    return name;
+}
+//---------------------------------------------------------------------------
+// Generate an operand
+string ProgramGenerator::operand(int64_t& bound) {
+    vector<size_t> initialized;
+    for (size_t i = 0; i < variableBounds.size(); i++) {
+        if (variableBounds[i] >= 0) {
+            initialized.push_back(i);
+        }
+    }
+
+    bool useConstant = bernoulli_distribution(shape.constantDensity)(random) || (shape.parameters == 0 && initialized.empty());
+    if (useConstant) {
+        if (!constantValues.empty() && bernoulli_distribution(0.5)(random)) {
+            size_t index = uniform_int_distribution<size_t>(0, constantValues.size() - 1)(random);
+            bound = constantValues[index];
+            return getName('c', index);
+        }
+        bound = uniform_int_distribution<int64_t>(1, 100)(random);
+        return to_string(bound);
+    }
+
+    size_t choices = shape.parameters + initialized.size();
+    size_t choice = uniform_int_distribution<size_t>(0, choices - 1)(random);
+    if (choice < shape.parameters) {
+        bound = maxParameter;
+        return getName('p', choice);
+    }
+    size_t variable = initialized[choice - shape.parameters];
+    bound = variableBounds[variable];
+    return getName('v', variable);
+}
+//---------------------------------------------------------------------------
+// Generate an expression of at most the given depth
+string ProgramGenerator::expression(size_t depth, int64_t& bound) {
+    if (depth == 0 || bernoulli_distribution(0.2)(random)) {
+        return operand(bound);
+    }
+
+    int64_t leftBound = 0;
+    string left = expression(depth - 1, leftBound);
+
+    switch (uniform_int_distribution<int>(0, 4)(random)) {
+        case 0: {
+            // The divisor is a literal so that the division never fails
+            int64_t divisor = uniform_int_distribution<int64_t>(2, 9)(random);
+            bound = leftBound;
+            return "(" + left + " / " + to_string(divisor) + ")";
+        }
+        case 1:
+            bound = leftBound;
+            return "-(" + left + ")";
+        default: break;
+    }
+
+    int64_t rightBound = 0;
+    string right = expression(depth - 1, rightBound);
+
+    // Multiply only if the product cannot overflow, otherwise add or subtract
+    bool multiply = bernoulli_distribution(0.3)(random) && leftBound <= maxIntermediate / max<int64_t>(rightBound, 1);
+    if (multiply) {
+        bound = leftBound * rightBound;
+        return "(" + left + " * " + right + ")";
+    }
+    bound = leftBound + rightBound;
+    string sum = "(" + left + (bernoulli_distribution(0.5)(random) ? " + " : " - ") + right + ")";
+
+    // Scale large sums down so that deeply nested expressions cannot overflow
+    if (bound > maxIntermediate) {
+        int64_t divisor = bound / maxIntermediate + 1;
+        bound = bound / divisor + 1;
+        return "(" + sum + " / " + to_string(divisor) + ")";
+    }
+    return sum;
+}
+//---------------------------------------------------------------------------
+// Generate a program
+string ProgramGenerator::generate() {
+    random.seed(shape.seed);
+    constantValues.clear();
+    variableBounds.assign(shape.variables, -1);
+
+    string code;
+    if (shape.parameters > 0) {
+        code += "PARAM ";
+        for (size_t i = 0; i < shape.parameters; i++) {
+            code += (i == 0 ? "" : ", ") + getName('p', i);
+        }
+        code += ";\n";
+    }
+    if (shape.variables > 0) {
+        code += "VAR ";
+        for (size_t i = 0; i < shape.variables; i++) {
+            code += (i == 0 ? "" : ", ") + getName('v', i);
+        }
+        code += ";\n";
+    }
+    if (shape.constants > 0) {
+        code += "CONST ";
+        for (size_t i = 0; i < shape.constants; i++) {
+            constantValues.push_back(uniform_int_distribution<int64_t>(1, 100)(random));
+            code += (i == 0 ? "" : ", ") + getName('c', i) + " = " + to_string(constantValues.back());
+        }
+        code += ";\n";
+    }
+
+    code += "BEGIN\n";
+    for (size_t i = 0; shape.variables > 0 && i < shape.statements; i++) {
+        size_t variable = uniform_int_distribution<size_t>(0, shape.variables - 1)(random);
+        int64_t bound = 0;
+        string value = expression(shape.depth, bound);
+
+        // Scale the value down so that later statements cannot overflow
+        if (bound > maxVariable) {
+            int64_t divisor = bound / maxVariable + 1;
+            value = "(" + value + ") / " + to_string(divisor);
+            bound = bound / divisor + 1;
+        }
+        variableBounds[variable] = bound;
+        code += getName('v', variable) + " := " + value + ";\n";
+    }
+
+    int64_t bound = 0;
+    code += "RETURN " + expression(shape.depth, bound) + "\nEND.\n";
+    return code;
+}
+//---------------------------------------------------------------------------
+// Generate a program that returns its parameter nested in the given number of parentheses
+string ProgramGenerator::generateNested(size_t depth) {
+    string code = "PARAM a;\nBEGIN\nRETURN ";
+    code.append(depth, '(');
+    code += "a";
+    code.append(depth, ')');
+    code += "\nEND.\n";
+    return code;
+}
+//---------------------------------------------------------------------------
+// Generate a program that returns the sum of its parameter repeated the given number of times
+string ProgramGenerator::generateChain(size_t length) {
+    string code = "PARAM a;\nBEGIN\nRETURN a";
+    for (size_t i = 1; i < length; i++) {
+        code += " + a";
+    }
+    code += "\nEND.\n";
+    return code;
+}
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
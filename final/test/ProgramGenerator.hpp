@@ -0,0 +1,62 @@
+#ifndef H_TEST_PROGRAMGENERATOR
+#define H_TEST_PROGRAMGENERATOR
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+using namespace std;
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+/// Struct that represents the shape of a generated program
+struct ProgramShape {
+    /// Number of assignments before the return statement
+    size_t statements = 16;
+    /// Number of declared parameters
+    size_t parameters = 2;
+    /// Number of declared variables
+    size_t variables = 4;
+    /// Number of declared constants
+    size_t constants = 2;
+    /// Maximum depth of an expression
+    size_t depth = 4;
+    /// Probability that an operand is a literal or a constant instead of a parameter or variable
+    double constantDensity = 0.3;
+    /// Seed of the random number generator, equal seeds generate equal programs
+    uint64_t seed = 0;
+};
+/// Class that generates random valid programs, they never divide by zero or overflow for parameters within maxParameter
+class ProgramGenerator {
+    public:
+    /// Constructor
+    explicit ProgramGenerator(ProgramShape shape);
+    /// Generate a program
+    string generate();
+    /// Generate a program that returns its parameter nested in the given number of parentheses
+    static string generateNested(size_t depth);
+    /// Generate a program that returns the sum of its parameter repeated the given number of times
+    static string generateChain(size_t length);
+    /// Largest absolute value of a parameter for which the programs do not overflow
+    static constexpr int64_t maxParameter = 1000;
+
+    private:
+    /// Generate an expression of at most the given depth, bound is set to the largest absolute value of the expression
+    string expression(size_t depth, int64_t& bound);
+    /// Generate an operand
+    string operand(int64_t& bound);
+    /// Return the name of an identifier
+    static string getName(char prefix, size_t index);
+    /// Storage of the shape
+    ProgramShape shape;
+    /// Storage of the random number generator
+    mt19937_64 random;
+    /// Storage of the values of the constants
+    vector<int64_t> constantValues;
+    /// Storage of the largest absolute value of every variable, -1 if it is not initialized yet
+    vector<int64_t> variableBounds;
+};
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
+#endif // H_TEST_PROGRAMGENERATOR
+//---------------------------------------------------------------------------
@@ -1,10 +1,35 @@
 #include "pljit/semantic/SemanticAnalysis.hpp"
+#include <memory_resource>
 #include <vector>
 #include <gtest/gtest.h>
 //---------------------------------------------------------------------------
 using namespace std;
 using namespace pljit::semanticanalysis;
 //---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+/// Memory resource that counts the bytes it hands out and gets back
+class CountingResource : public pmr::memory_resource {
+    public:
+    explicit CountingResource(pmr::memory_resource* upstream) : upstream(upstream) {}
+    size_t allocated = 0;
+    size_t deallocated = 0;
+
+    private:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        allocated += bytes;
+        return upstream->allocate(bytes, alignment);
+    }
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+        deallocated += bytes;
+        upstream->deallocate(p, bytes, alignment);
+    }
+    bool do_is_equal(const pmr::memory_resource& other) const noexcept override { return this == &other; }
+    pmr::memory_resource* upstream;
+};
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
 TEST(TestAST, Add) {
     const auto code =
         "VAR a;\n"
@@ -660,3 +685,46 @@ TEST(TestAST, MissingReturn) {
     ASSERT_TRUE(function.errorOccurred());
 }
 //---------------------------------------------------------------------------
+TEST(TestAST, MemoryResource) {
+    const auto code =
+        "PARAM a;\n"
+        "VAR b;\n"
+        "BEGIN\n"
+        "b := a * (a + 2);\n"
+        "RETURN b - 1\n"
+        "END.\n";
+
+    // The parse tree and the ast only use the buffer, its upstream does not allocate
+    array<byte, 1 << 16> buffer;
+    pmr::monotonic_buffer_resource bufferResource(buffer.data(), buffer.size(), pmr::null_memory_resource());
+    CountingResource parseTreeResource(&bufferResource);
+    CountingResource astResource(&bufferResource);
+
+    shared_ptr<CodeManagement> codeM = make_shared<CodeManagement>(code);
+    Lexer lex(code, codeM);
+    Parsing parser(lex, codeM, &parseTreeResource);
+    parser.parsing();
+    ASSERT_FALSE(parser.errorOccurred());
+    ASSERT_GT(parseTreeResource.allocated, 0);
+
+    // The children of the nodes stay in the resource, also after the tree was moved into the parser
+    const StatementList& statementList = parser.getTree().getCompoundStatement().getStatementList();
+    ASSERT_EQ(statementList.getChildren().get_allocator().getResource(), &parseTreeResource);
+    ASSERT_EQ(statementList.getStatement().getChildren().get_allocator().getResource(), &parseTreeResource);
+
+    {
+        SemanticAnalysis semanticAnalysis(codeM, &astResource);
+        unique_ptr<Function> function = allocateNode<Function>(&astResource, semanticAnalysis.getAST(parser));
+        ASSERT_FALSE(function->errorOccurred());
+        ASSERT_GT(astResource.allocated, 0);
+
+        array<int64_t, 1> parameters = {3};
+        EvaluationContext evaluationContext(function->getSymbolTable(), parameters);
+        function->execute(evaluationContext);
+        ASSERT_EQ(evaluationContext.getReturnValue(), 14);
+    }
+
+    // Every node and symbol table was returned to its resource
+    ASSERT_EQ(astResource.deallocated, astResource.allocated);
+}
+//---------------------------------------------------------------------------
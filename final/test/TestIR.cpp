@@ -0,0 +1,207 @@
+#include "pljit/ir/ASTBuilder.hpp"
+#include "pljit/ir/IRBuilder.hpp"
+#include "pljit/ir/IROptimizerCommonSubexpression.hpp"
+#include "pljit/ir/IROptimizerConstantPropagation.hpp"
+#include "pljit/ir/IROptimizerDeadCode.hpp"
+#include "pljit/semantic/SemanticAnalysis.hpp"
+#include <gtest/gtest.h>
+#include <sstream>
+#include <thread>
+//---------------------------------------------------------------------------
+using namespace std;
+using namespace pljit::ir;
+using namespace pljit::semanticanalysis;
+//---------------------------------------------------------------------------
+static Function analyze(const char* code) {
+    shared_ptr<CodeManagement> codeM = make_shared<CodeManagement>(code);
+    Lexer lex(code, codeM);
+    Parsing parser(lex, codeM);
+    parser.parsing();
+
+    SemanticAnalysis semanticAnalysis(codeM);
+    return semanticAnalysis.getAST(parser);
+}
+//---------------------------------------------------------------------------
+static optional<int64_t> evaluate(Function& function, const vector<int64_t>& parameters) {
+    EvaluationContext evaluationContext(function.getSymbolTable(), parameters);
+    function.evaluate(evaluationContext);
+    if (function.errorOccurred()) {
+        return nullopt;
+    }
+    return evaluationContext.getReturnValue();
+}
+//---------------------------------------------------------------------------
+static void optimize(IRFunction& irFunction) {
+    IROptimizerConstantPropagation constantPropagation;
+    IROptimizerCommonSubexpression commonSubexpression;
+    IROptimizerDeadCode deadCode;
+    constantPropagation.optimize(irFunction);
+    commonSubexpression.optimize(irFunction);
+    deadCode.optimize(irFunction);
+}
+//---------------------------------------------------------------------------
+TEST(TestIR, LowerFunction) {
+    const auto code =
+        "PARAM a;\n"
+        "VAR b;\n"
+        "BEGIN\n"
+        "b := a * 2;\n"
+        "RETURN b\n"
+        "END.\n";
+
+    auto function = analyze(code);
+    IRBuilder irBuilder;
+    IRFunction irFunction = irBuilder.build(function);
+
+    stringstream output;
+    irFunction.print(output);
+    EXPECT_EQ(output.str(),
+              "%0 = param 0 a\n"
+              "%1 = const 2\n"
+              "%2 = mul %0, %1\n"
+              "return %2\n");
+
+    irFunction.computeUsers();
+    EXPECT_EQ(irFunction.getUsers(0).size(), 1);
+    EXPECT_EQ(irFunction.getUsers(2)[0], 3);
+}
+//---------------------------------------------------------------------------
+TEST(TestIR, OptimizeConstantPropagation) {
+    const auto code =
+        "PARAM a;\n"
+        "VAR b, c;\n"
+        "CONST d = 3;\n"
+        "BEGIN\n"
+        "b := d * 4 - 12;\n"
+        "c := (a + b) * 1;\n"
+        "RETURN -(-c)\n"
+        "END.\n";
+
+    auto function = analyze(code);
+    IRBuilder irBuilder;
+    IRFunction irFunction = irBuilder.build(function);
+    optimize(irFunction);
+
+    stringstream output;
+    irFunction.print(output);
+    EXPECT_EQ(output.str(),
+              "%0 = param 0 a\n"
+              "return %0\n");
+}
+//---------------------------------------------------------------------------
+TEST(TestIR, OptimizeCommonSubexpression) {
+    const auto code =
+        "PARAM a, b;\n"
+        "VAR c, d;\n"
+        "BEGIN\n"
+        "c := a * b + 1;\n"
+        "d := b * a + 1;\n"
+        "RETURN c * d\n"
+        "END.\n";
+
+    auto function = analyze(code);
+    IRBuilder irBuilder;
+    IRFunction irFunction = irBuilder.build(function);
+    ASSERT_EQ(irFunction.size(), 10);
+    optimize(irFunction);
+    EXPECT_EQ(irFunction.size(), 7);
+
+    ASTBuilder astBuilder;
+    auto optimized = astBuilder.build(irFunction);
+    auto& optimizedFunction = static_cast<Function&>(*optimized);
+    // The shared value is computed once in a temporary variable
+    EXPECT_EQ(optimizedFunction.getStatements().size(), 2);
+    EXPECT_EQ(evaluate(optimizedFunction, {2, 3}), 49);
+}
+//---------------------------------------------------------------------------
+TEST(TestIR, OptimizeDeadCode) {
+    const auto code =
+        "PARAM a;\n"
+        "VAR b, c;\n"
+        "BEGIN\n"
+        "b := a * a;\n"
+        "c := 10 / a;\n"
+        "RETURN a;\n"
+        "RETURN b\n"
+        "END.\n";
+
+    auto function = analyze(code);
+    IRBuilder irBuilder;
+    IRFunction irFunction = irBuilder.build(function);
+    optimize(irFunction);
+
+    // The unused multiplication is removed, the division may fail and is kept
+    stringstream output;
+    irFunction.print(output);
+    EXPECT_EQ(output.str(),
+              "%0 = param 0 a\n"
+              "%1 = const 10\n"
+              "%2 = div %1, %0\n"
+              "return %0\n");
+
+    ASTBuilder astBuilder;
+    auto optimized = astBuilder.build(irFunction);
+    auto& optimizedFunction = static_cast<Function&>(*optimized);
+    EXPECT_EQ(evaluate(optimizedFunction, {5}), 5);
+    EXPECT_EQ(evaluate(optimizedFunction, {0}), nullopt);
+}
+//---------------------------------------------------------------------------
+TEST(TestIR, KeepDivisionByZero) {
+    const auto code =
+        "VAR a;\n"
+        "BEGIN\n"
+        "a := 1 / 0;\n"
+        "RETURN 2\n"
+        "END.\n";
+
+    auto function = analyze(code);
+    IRBuilder irBuilder;
+    IRFunction irFunction = irBuilder.build(function);
+    optimize(irFunction);
+
+    ASTBuilder astBuilder;
+    auto optimized = astBuilder.build(irFunction);
+    EXPECT_EQ(evaluate(static_cast<Function&>(*optimized), {}), nullopt);
+}
+//---------------------------------------------------------------------------
+TEST(TestIR, RoundTrip) {
+    const vector<const char*> codes = {
+        "PARAM a, b, c;\nVAR d;\nBEGIN\nd := a - b - c;\nRETURN d * (a + b) / (c + 1)\nEND.\n",
+        "PARAM a, b;\nVAR c;\nCONST e = 7;\nBEGIN\nc := a;\na := b;\nb := c;\nRETURN a - e * b\nEND.\n",
+        "PARAM a, b, c;\nVAR d, e;\nBEGIN\nd := a * b;\ne := d + d / c;\nd := e - +a;\nRETURN -d + e\nEND.\n"};
+    const vector<vector<int64_t>> parameterRows = {{1, 2, 3}, {-4, 5, 0}, {100, -7, 9}, {0, 0, -1}};
+
+    for (const char* code : codes) {
+        for (const auto& parameters : parameterRows) {
+            auto function = analyze(code);
+            IRBuilder irBuilder;
+            IRFunction irFunction = irBuilder.build(function);
+            optimize(irFunction);
+            ASTBuilder astBuilder;
+            auto optimized = astBuilder.build(irFunction);
+
+            EXPECT_EQ(evaluate(static_cast<Function&>(*optimized), parameters), evaluate(function, parameters)) << code;
+        }
+    }
+}
+//---------------------------------------------------------------------------
+TEST(TestIR, TemporaryNames) {
+    // The names are created concurrently and found again at the same address
+    vector<thread> threads;
+    for (size_t t = 0; t < 4; t++) {
+        threads.emplace_back([] {
+            for (size_t i = 0; i < 1000; i++) {
+                string expected = "$";
+                expected.append(to_string(i));
+                EXPECT_EQ(ASTBuilder::getTemporaryName(i), expected);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    ASSERT_EQ(ASTBuilder::getTemporaryName(63).data(), ASTBuilder::getTemporaryName(63).data());
+    ASSERT_EQ(ASTBuilder::getTemporaryName(64), "$64");
+    ASSERT_EQ(ASTBuilder::getTemporaryName(100000), "$100000");
+}
+//---------------------------------------------------------------------------
@@ -237,3 +237,29 @@ TEST(TestLexer, unknownCharacter) {
     }
 }
 //---------------------------------------------------------------------------
+TEST(TestLexer, boundedCode) {
+    // The view ends inside a literal and before the assignment is complete, the characters after it are never read
+    const string_view bundle = "BEGIN RETURN 123 END. a :=";
+    const string_view code = bundle.substr(0, 15);
+
+    vector<Token::TokenType> tokenTypes = {Token::TokenType::BeginKeyword,
+                                           Token::TokenType::ReturnKeyword,
+                                           Token::TokenType::Literal,
+                                           Token::TokenType::Unexpected};
+    shared_ptr<CodeManagement> codeM = make_shared<CodeManagement>(code);
+    Lexer lex(code, codeM);
+    for (size_t i = 0; i < tokenTypes.size(); i++) {
+        auto token = lex.next();
+        ASSERT_EQ(token.tokenType(), tokenTypes[i]);
+        if (i == 2) {
+            ASSERT_EQ(codeM->getCharacters(token.reference()), "12");
+        }
+    }
+
+    const string_view assignment = bundle.substr(22, 3);
+    shared_ptr<CodeManagement> assignmentM = make_shared<CodeManagement>(assignment);
+    Lexer assignmentLex(assignment, assignmentM);
+    ASSERT_EQ(assignmentLex.next().tokenType(), Token::TokenType::Identifier);
+    ASSERT_EQ(assignmentLex.next().tokenType(), Token::TokenType::Unexpected);
+}
+//---------------------------------------------------------------------------
@@ -1,10 +1,53 @@
+#include "pljit/BatchDispatcher.hpp"
+#include "pljit/MappedFile.hpp"
 #include "pljit/Pljit.hpp"
+#include "pljit/Replayer.hpp"
+#include "pljit/Server.hpp"
+#include "pljit/StreamEvaluator.hpp"
+#include "pljit/ThreadPool.hpp"
+#include <fstream>
+#include <map>
+#include <memory_resource>
+#include <sstream>
 #include <thread>
 #include <gtest/gtest.h>
 //---------------------------------------------------------------------------
 using namespace std;
 using namespace pljit;
 //---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+// Coroutine that awaits two calls and records the thread it is resumed on
+Task<optional<int64_t>> addTwoCalls(PljitHandle& func, Executor& executor, thread::id& resumedOn) {
+    optional<int64_t> first = co_await func.callAsync(executor, vector<int64_t>(1, 1));
+    optional<int64_t> second = co_await func.callAsync(executor, vector<int64_t>(1, 2));
+    resumedOn = this_thread::get_id();
+    if (!first || !second) {
+        co_return nullopt;
+    }
+    co_return *first + *second;
+}
+//---------------------------------------------------------------------------
+// Memory resource that counts the bytes it hands out and gets back, it can be used by many threads
+class CountingResource : public pmr::memory_resource {
+    public:
+    atomic<size_t> allocated = 0;
+    atomic<size_t> deallocated = 0;
+
+    private:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        allocated += bytes;
+        return pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+        deallocated += bytes;
+        pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+    bool do_is_equal(const pmr::memory_resource& other) const noexcept override { return this == &other; }
+};
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
 TEST(TestPljit, MultipleFunctionsCorrect) {
     const auto program =
         "PARAM c;\n"
@@ -371,3 +414,1392 @@ TEST(TestPljit, ParallelMultipleFunctions) {
         thread.join();
 }
 //---------------------------------------------------------------------------
+TEST(TestPljit, SpecializedFunction) {
+    const auto code =
+        "PARAM a, b, c;\n"
+        "VAR d;\n"
+        "BEGIN\n"
+        "d := a * b + c;\n"
+        "b := b * 2;\n"
+        "d := d - b;\n"
+        "RETURN d\n"
+        "END.\n";
+
+    Pljit jit;
+    auto func = jit.registerFunction(code);
+    ASSERT_TRUE(func.specialize({{1, 3}}));
+
+    vector<int64_t> parameters = {4, 3, 5};
+    auto res = func(parameters);
+    ASSERT_TRUE(res.has_value());
+    ASSERT_EQ(res.value(), 11);
+
+    auto specializedRes = func({{1, 3}}, parameters);
+    ASSERT_TRUE(specializedRes.has_value());
+    ASSERT_EQ(specializedRes.value(), 11);
+
+    // the bound parameter ignores the value from the parameter list
+    vector<int64_t> parameters2 = {4, 100, 5};
+    specializedRes = func({{1, 3}}, parameters2);
+    ASSERT_TRUE(specializedRes.has_value());
+    ASSERT_EQ(specializedRes.value(), 11);
+
+    specializedRes = func({{2, 1}, {0, 2}}, parameters);
+    ASSERT_TRUE(specializedRes.has_value());
+    ASSERT_EQ(specializedRes.value(), 1);
+}
+//---------------------------------------------------------------------------
+TEST(TestPljit, SpecializedFunctionWithErrors) {
+    const auto code =
+        "PARAM a, b;\n"
+        "BEGIN\n"
+        "RETURN a / b\n"
+        "END.\n";
+
+    Pljit jit;
+    auto func = jit.registerFunction(code);
+    vector<int64_t> parameters = {4, 2};
+    auto res = func({{1, 0}}, parameters);
+    ASSERT_FALSE(res.has_value());
+    res = func({{1, 2}}, parameters);
+    ASSERT_TRUE(res.has_value());
+    ASSERT_EQ(res.value(), 2);
+
+    const auto code2 =
+        "PARAM a;\n"
+        "BEGIN\n"
+        "RETURN b\n"
+        "END.\n";
+
+    auto func2 = jit.registerFunction(code2);
+    ASSERT_FALSE(func2.specialize({{0, 1}}));
+}
+//---------------------------------------------------------------------------
+TEST(TestPljit, SpecializationCacheEviction) {
+    SpecializationCache cache(2);
+    cache.insert({{0, 1}}, make_unique<Constant>(1));
+    cache.insert({{0, 2}}, make_unique<Constant>(2));
+    ASSERT_NE(cache.find({{0, 1}}), nullptr);
+
+    // {0, 2} is now the least recently used binding
+    cache.insert({{0, 3}}, make_unique<Constant>(3));
+    ASSERT_EQ(cache.size(), 2);
+    ASSERT_EQ(cache.find({{0, 2}}), nullptr);
+    ASSERT_NE(cache.find({{0, 1}}), nullptr);
+    auto* function = cache.find({{0, 3}});
+    ASSERT_NE(function, nullptr);
+    ASSERT_EQ(static_cast<Constant*>(function)->getValue(), 3);
+
+    cache.setCapacity(1);
+    ASSERT_EQ(cache.size(), 1);
+    ASSERT_NE(cache.find({{0, 3}}), nullptr);
+
+    auto binding = SpecializationCache::normalize({{2, 1}, {0, 5}, {2, 7}});
+    ParameterBinding expected = {{0, 5}, {2, 1}};
+    ASSERT_EQ(binding, expected);
+}
+//---------------------------------------------------------------------------
+TEST(TestPljit, MemoizedFunction) {
+    const auto code =
+        "PARAM a, b;\n"
+        "BEGIN\n"
+        "RETURN a * b + 1\n"
+        "END.\n";
+
+    Pljit jit;
+    auto func = jit.registerFunction(code);
+    ASSERT_TRUE(func.enableMemoization(1 << 12));
+
+    vector<int64_t> parameters1 = {2, 3};
+    vector<int64_t> parameters2 = {3, 2};
+    ASSERT_EQ(func(parameters1), 7);
+    ASSERT_EQ(func(parameters2), 7);
+    ASSERT_EQ(func(parameters1), 7);
+    ASSERT_EQ(func(parameters1), 7);
+
+    auto statistics = func.getMemoizationStatistics();
+    ASSERT_EQ(statistics.hits, 2);
+    ASSERT_EQ(statistics.misses, 2);
+    ASSERT_EQ(statistics.entries, 2);
+    ASSERT_GT(statistics.capacity, 0);
+    ASSERT_EQ(statistics.memoryBudget, 1 << 12);
+
+    func.disableMemoization();
+    ASSERT_EQ(func(parameters1), 7);
+    ASSERT_EQ(func.getMemoizationStatistics().hits, 0);
+}
+//---------------------------------------------------------------------------
+TEST(TestPljit, MemoizationCacheCapacity) {
+    MemoizationCache cache(2, 0);
+    cache.store({1, 2}, 3);
+    ASSERT_FALSE(cache.lookup({1, 2}).has_value());
+    ASSERT_EQ(cache.getStatistics().capacity, 0);
+
+    MemoizationCache smallCache(2, 256);
+    auto capacity = smallCache.getStatistics().capacity;
+    ASSERT_GT(capacity, 0);
+    for (int64_t i = 0; i < 100; i++) {
+        smallCache.store({i, i}, 2 * i);
+    }
+    ASSERT_LE(smallCache.getStatistics().entries, capacity);
+
+    size_t found = 0;
+    for (int64_t i = 0; i < 100; i++) {
+        auto result = smallCache.lookup({i, i});
+        if (result.has_value()) {
+            ASSERT_EQ(result.value(), 2 * i);
+            found++;
+        }
+    }
+    ASSERT_EQ(found, smallCache.getStatistics().entries);
+    ASSERT_FALSE(smallCache.lookup({1}).has_value());
+
+    // A cache without capacity counts every lookup as a miss
+    MemoizationCache emptyCache(2, 1);
+    emptyCache.store({1, 2}, 3);
+    ASSERT_FALSE(emptyCache.lookup({1, 2}).has_value());
+    ASSERT_EQ(emptyCache.getStatistics().capacity, 0);
+    ASSERT_EQ(emptyCache.getStatistics().misses, 1);
+}
+//---------------------------------------------------------------------------
+TEST(TestPljit, ParallelMemoizedFunction) {
+    const auto code =
+        "PARAM a;\n"
+        "BEGIN\n"
+        "RETURN a * 2\n"
+        "END.\n";
+
+    Pljit jit;
+    auto func = jit.registerFunction(code);
+    ASSERT_TRUE(func.enableMemoization());
+
+    vector<thread> threads;
+    for (int64_t t = 0; t < 4; t++) {
+        threads.emplace_back([&func]() {
+            for (int64_t i = 0; i < 100; i++) {
+                vector<int64_t> parameters = {i % 10};
+                auto res = func(parameters);
+                ASSERT_TRUE(res.has_value());
+                ASSERT_EQ(res.value(), 2 * (i % 10));
+            }
+        });
+    }
+
+    for (auto& thread : threads)
+        thread.join();
+
+    auto statistics = func.getMemoizationStatistics();
+    ASSERT_EQ(statistics.hits + statistics.misses, 400);
+    ASSERT_EQ(statistics.entries, 10);
+}
+//---------------------------------------------------------------------------
+TEST(TestPljit, ConstantFoldedFunctions) {
+    const auto code =
+        "VAR d, e;\n"
+        "BEGIN\n"
+        "d := -1 * (12 / (-6));\n"
+        "e := d + +2;\n"
+        "e := -(-(-e));\n"
+        "RETURN e;\n"
+        "RETURN d\n"
+        "END.\n";
+
+    Pljit jit;
+    auto func = jit.registerFunction(code);
+    vector<int64_t> parameters;
+    ASSERT_FALSE(func.isConstantFolded());
+    ASSERT_EQ(func(parameters), -4);
+    ASSERT_TRUE(func.isConstantFolded());
+    ASSERT_EQ(func(parameters), -4);
+
+    const auto code2 =
+        "VAR d;\n"
+        "CONST c = 0;\n"
+        "BEGIN\n"
+        "d := 12 / c;\n"
+        "RETURN d\n"
+        "END.\n";
+
+    auto func2 = jit.registerFunction(code2);
+    ASSERT_FALSE(func2(parameters).has_value());
+    ASSERT_TRUE(func2.isConstantFolded());
+    ASSERT_FALSE(func2(parameters).has_value());
+
+    const auto code3 =
+        "PARAM a;\n"
+        "BEGIN\n"
+        "RETURN a\n"
+        "END.\n";
+
+    auto func3 = jit.registerFunction(code3);
+    vector<int64_t> parameters3 = {1};
+    ASSERT_EQ(func3(parameters3), 1);
+    ASSERT_FALSE(func3.isConstantFolded());
+}
+//---------------------------------------------------------------------------
+TEST(TestPljit, OptimizationLevels) {
+    const auto code =
+        "PARAM a, b;\n"
+        "VAR c, d;\n"
+        "CONST e = 0;\n"
+        "BEGIN\n"
+        "c := a * b + e;\n"
+        "d := b * a + 1;\n"
+        "RETURN c * d;\n"
+        "RETURN a\n"
+        "END.\n";
+
+    Pljit jit;
+    auto func0 = jit.registerFunction(code, OptimizationLevel::O0);
+    auto func1 = jit.registerFunction(code, OptimizationLevel::O1);
+    auto func2 = jit.registerFunction(code, OptimizationLevel::O2);
+    vector<int64_t> parameters = {3, 4};
+
+    ASSERT_EQ(func0(parameters), 156);
+    ASSERT_EQ(func1(parameters), 156);
+    ASSERT_EQ(func2(parameters), 156);
+
+    ASSERT_TRUE(func0.getPassStatistics().empty());
+    ASSERT_EQ(func1.getPassStatistics().size(), 2);
+
+    auto statistics = func2.getPassStatistics();
+    ASSERT_EQ(statistics.size(), 5);
+    for (size_t i = 1; i < statistics.size(); i++) {
+        ASSERT_EQ(statistics[i].nodesBefore, statistics[i - 1].nodesAfter);
+    }
+    ASSERT_EQ(statistics[0].pass, Pass::DeadCode);
+    ASSERT_LT(statistics[0].nodesAfter, statistics[0].nodesBefore);
+    ASSERT_EQ(statistics[3].pass, Pass::SSACommonSubexpression);
+}
+//---------------------------------------------------------------------------
+TEST(TestPljit, CustomPipeline) {
+    const auto code =
+        "PARAM a;\n"
+        "VAR b;\n"
+        "BEGIN\n"
+        "b := a / 0;\n"
+        "RETURN a * 1\n"
+        "END.\n";
+
+    Pljit jit;
+    auto func = jit.registerFunction(code);
+    func.setPassManager(PassManager({Pass::SSAConstantPropagation, Pass::SSADeadCode}));
+    vector<int64_t> parameters = {3};
+
+    // The failing division is not removed
+    ASSERT_FALSE(func(parameters).has_value());
+    auto statistics = func.getPassStatistics();
+    ASSERT_EQ(statistics.size(), 2);
+    ASSERT_EQ(PassManager::getName(statistics[0].pass), "SSAConstantPropagation");
+    ASSERT_EQ(PassManager::getName(statistics[1].pass), "SSADeadCode");
+}
+//---------------------------------------------------------------------------
+TEST(TestPljit, Instrumentation) {
+    const auto code =
+        "PARAM a;\n"
+        "VAR b;\n"
+        "BEGIN\n"
+        "b := a * 2;\n"
+        "RETURN b\n"
+        "END.\n";
+
+    Pljit jit;
+    auto func = jit.registerFunction(code);
+    vector<int64_t> parameters = {3};
+    for (size_t i = 0; i < 10; i++) {
+        ASSERT_EQ(func(parameters), 6);
+    }
+
+    auto snapshot = func.getInstrumentation();
+    ASSERT_EQ(snapshot.enabled, Instrumentation::enabled);
+    ASSERT_NE(snapshot.toJSON().find("\"semanticAnalysis\":{\"count\":"), string::npos);
+
+    if (!Instrumentation::enabled) {
+        ASSERT_EQ(snapshot.getCount(Phase::Evaluation), 0);
+        ASSERT_EQ(snapshot.toJSON().find("{\"enabled\":false"), 0);
+        return;
+    }
+
+    ASSERT_EQ(snapshot.getCount(Phase::Lexing), 1);
+    ASSERT_EQ(snapshot.getCount(Phase::Parsing), 1);
+    ASSERT_EQ(snapshot.getCount(Phase::SemanticAnalysis), 1);
+    ASSERT_EQ(snapshot.getCount(Phase::Optimization), 1);
+    ASSERT_EQ(snapshot.getCount(Phase::Evaluation), 10);
+    ASSERT_EQ(snapshot.getCount(Phase::LockWait), 20);
+    ASSERT_GT(snapshot.getDuration(Phase::Lexing).count(), 0);
+    ASSERT_GT(snapshot.nodes, 0);
+    ASSERT_GE(snapshot.allocations, snapshot.nodes);
+}
+//---------------------------------------------------------------------------
+TEST(TestPljit, CallInterfaces) {
+    const auto code =
+        "PARAM a, b, c;\n"
+        "BEGIN\n"
+        "RETURN a * b - c\n"
+        "END.\n";
+
+    Pljit jit;
+    auto func = jit.registerFunction(code);
+    array<int64_t, 3> parameters = {2, 3, 4};
+    ASSERT_EQ(func(span<const int64_t>(parameters)), 2);
+    ASSERT_EQ(func(2, 3, 4), 2);
+    ASSERT_EQ(func(vector<int64_t>{2, 3, 4}), 2);
+
+    // A wrong number of parameters is an error and does not read out of bounds
+    ASSERT_FALSE(func(2, 3).has_value());
+    ASSERT_FALSE(func(vector<int64_t>{}).has_value());
+    ASSERT_FALSE(func(1, 2, 3, 4).has_value());
+    ASSERT_FALSE(func({{0, 5}}, vector<int64_t>{}).has_value());
+    ASSERT_EQ(func({{0, 5}}, vector<int64_t>{0, 3, 4}), 11);
+
+    auto typedFunc = jit.registerFunction<3>(code);
+    ASSERT_EQ(typedFunc(2, 3, 4), 2);
+    ASSERT_EQ(typedFunc(parameters), 2);
+    ASSERT_TRUE(typedFunc.isCompiled());
+
+    // The arity of a typed handle is checked once during the compilation
+    auto wrongFunc = jit.registerFunction<2>(code);
+    ASSERT_FALSE(wrongFunc(2, 3).has_value());
+    ASSERT_FALSE(wrongFunc.isCompiled());
+
+    auto constantFunc = jit.registerFunction<0>("BEGIN RETURN 7 END.");
+    ASSERT_EQ(constantFunc(), 7);
+}
+//---------------------------------------------------------------------------
+TEST(TestPljit, AsyncCall) {
+    const auto code =
+        "PARAM a;\n"
+        "BEGIN\n"
+        "RETURN 10 / a\n"
+        "END.\n";
+
+    Pljit jit;
+    auto func = jit.registerFunction(code);
+    InlineExecutor inlineExecutor;
+    ASSERT_EQ(syncWait(func.callAsync(inlineExecutor, {2})), 5);
+    ASSERT_FALSE(syncWait(func.callAsync(inlineExecutor, {0})).has_value());
+
+    // The task is lazy, nothing runs before it is awaited
+    ThreadExecutor threadExecutor;
+    auto func2 = jit.registerFunction(code);
+    auto task = func2.callAsync(threadExecutor, {5});
+    ASSERT_FALSE(func2.isCompiled());
+    ASSERT_EQ(syncWait(move(task)), 2);
+    ASSERT_TRUE(func2.isCompiled());
+
+    thread::id resumedOn;
+    ASSERT_EQ(syncWait(addTwoCalls(func2, threadExecutor, resumedOn)), 15);
+    ASSERT_NE(resumedOn, this_thread::get_id());
+
+    vector<thread> threads;
+    vector<optional<int64_t>> results(8);
+    for (size_t i = 0; i < results.size(); i++) {
+        threads.emplace_back([&, i] { results[i] = syncWait(func2.callAsync(threadExecutor, {static_cast<int64_t>(i + 1)})); });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (size_t i = 0; i < results.size(); i++) {
+        ASSERT_EQ(results[i], 10 / static_cast<int64_t>(i + 1));
+    }
+}
+//---------------------------------------------------------------------------
+TEST(TestPljit, BatchEvaluation) {
+    const auto code =
+        "PARAM a, b;\n"
+        "BEGIN\n"
+        "RETURN a / b\n"
+        "END.\n";
+
+    Pljit jit;
+    auto func = jit.registerFunction(code);
+    vector<vector<int64_t>> calls = {{6, 3}, {1, 0}, {8}, {9, -3}};
+    testing::internal::CaptureStderr();
+    auto results = func.evaluateBatch(calls);
+    ASSERT_EQ(results.size(), 4);
+    ASSERT_EQ(results[0], 2);
+    ASSERT_FALSE(results[1].has_value());
+    ASSERT_FALSE(results[2].has_value());
+    ASSERT_EQ(results[3], -3);
+
+    // The failed rows of a batch are only counted, also once the function is finalized
+    vector<int64_t> rows = {1, 0, 4, 2};
+    vector<optional<int64_t>> rowResults(2);
+    ASSERT_TRUE(func.evaluateRows(rows, rowResults));
+    ASSERT_TRUE(func.finalize());
+    ASSERT_TRUE(func.evaluateRows(rows, rowResults));
+    ASSERT_EQ(rowResults, vector<optional<int64_t>>({nullopt, 2}));
+    ASSERT_EQ(testing::internal::GetCapturedStderr(), "");
+    ASSERT_EQ(func.getMetrics().divisionByZeroErrors, 3);
+
+    auto func2 = jit.registerFunction(code);
+    BatchOptions options;
+    options.maxBatchSize = 16;
+    options.window = chrono::microseconds(50);
+    BatchDispatcher dispatcher(func2, options);
+    ASSERT_EQ(dispatcher({10, 5}), 2);
+
+    vector<thread> threads;
+    vector<bool> correct(8, true);
+    for (size_t i = 0; i < correct.size(); i++) {
+        threads.emplace_back([&, i] {
+            for (int64_t j = 1; j <= 200; j++) {
+                auto a = static_cast<int64_t>(i) * j;
+                if (dispatcher({a, j}) != static_cast<int64_t>(i)) {
+                    correct[i] = false;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (bool threadCorrect : correct) {
+        ASSERT_TRUE(threadCorrect);
+    }
+
+    auto statistics = dispatcher.getStatistics();
+    ASSERT_EQ(statistics.calls, 1601);
+    ASSERT_LE(statistics.batches, statistics.calls);
+    ASSERT_GE(statistics.batches, statistics.calls / options.maxBatchSize);
+}
+//---------------------------------------------------------------------------
+TEST(TestPljit, ThreadPool) {
+    ThreadPool pool(4, 8);
+    ASSERT_EQ(pool.getWorkerCount(), 4);
+    ASSERT_GE(ThreadPool::defaultWorkerCount(), 1);
+
+    // Every task spawns children on its own worker, idle workers steal them
+    atomic<size_t> sum = 0;
+    vector<future<void>> parents;
+    for (size_t i = 0; i < 32; i++) {
+        parents.push_back(pool.submit([&pool, &sum] {
+            for (size_t j = 0; j < 16; j++) {
+                pool.execute([&sum] { sum.fetch_add(1); });
+            }
+        }));
+    }
+    for (auto& parent : parents) {
+        parent.get();
+    }
+    ASSERT_EQ(pool.submit([] { return 42; }).get(), 42);
+
+    // The destructor runs the remaining tasks
+    {
+        ThreadPool drainedPool(2);
+        for (size_t i = 0; i < 100; i++) {
+            drainedPool.execute([&sum] { sum.fetch_add(1); });
+        }
+    }
+    while (sum.load() < 32 * 16 + 100) {
+        this_thread::yield();
+    }
+    auto statistics = pool.getStatistics();
+    ASSERT_GE(statistics.executed + statistics.inlined, 32);
+}
+//---------------------------------------------------------------------------
+TEST(TestPljit, ParallelEvaluation) {
+    const auto code =
+        "PARAM a, b;\n"
+        "VAR c;\n"
+        "BEGIN\n"
+        "c := a * 2;\n"
+        "RETURN c / b\n"
+        "END.\n";
+
+    ThreadPool pool(4);
+    Pljit jit;
+    auto func = jit.registerFunction(code);
+    ASSERT_TRUE(func.compileInBackground(pool).get());
+    ASSERT_TRUE(func.isCompiled());
+
+    vector<vector<int64_t>> calls;
+    for (int64_t i = 0; i < 1000; i++) {
+        calls.push_back({i, i % 7});
+    }
+    auto results = func.evaluateParallel(pool, calls, 64);
+    ASSERT_EQ(results.size(), calls.size());
+    for (int64_t i = 0; i < 1000; i++) {
+        if (i % 7 == 0) {
+            ASSERT_FALSE(results[i].has_value());
+        } else {
+            ASSERT_EQ(results[i], i * 2 / (i % 7));
+        }
+    }
+
+    // A division by zero does not affect later calls
+    ASSERT_FALSE(func(1, 0).has_value());
+    ASSERT_EQ(func(3, 2), 3);
+
+    vector<string_view> codes = {code, "BEGIN RETURN 1 END.", "PARAM a; BEGIN RETURN a + END.", code};
+    auto handles = jit.registerFunctions(pool, codes);
+    ASSERT_EQ(handles.size(), 4);
+    ASSERT_TRUE(handles[0]->isCompiled());
+    ASSERT_EQ((*handles[1])(), 1);
+    ASSERT_FALSE(handles[2]->isCompiled());
+    ASSERT_EQ((*handles[3])(5, 5), 2);
+}
+//---------------------------------------------------------------------------
+TEST(TestPljit, IncrementalUpdate) {
+    Pljit jit;
+    auto func = jit.registerFunction("PARAM a; BEGIN RETURN a END.");
+    ASSERT_EQ(func(7), 7);
+
+    ASSERT_TRUE(func.update("PARAM a, b;\nVAR c, d, e;\nBEGIN\nc := a + 1;\nd := c * b;\ne := d - a;\nRETURN e\nEND.\n"));
+    ASSERT_TRUE(func.getUpdateStatistics().fullCompilation);
+    ASSERT_EQ(func(2, 3), 7);
+
+    // Editing one statement analyzes it and its neighbours again
+    ASSERT_TRUE(func.update("PARAM a, b;\nVAR c, d, e;\nBEGIN\nc := a + 1;\nd := c * b;\ne := d - a * 2;\nRETURN e\nEND.\n"));
+    auto statistics = func.getUpdateStatistics();
+    ASSERT_FALSE(statistics.fullCompilation);
+    ASSERT_EQ(statistics.analyzedStatements, 3);
+    ASSERT_EQ(statistics.reusedStatements, 1);
+    ASSERT_EQ(func(2, 3), 5);
+
+    // Inserting a statement
+    ASSERT_TRUE(func.update("PARAM a, b;\nVAR c, d, e;\nBEGIN\nc := a + 1;\nc := c + 10;\nd := c * b;\ne := d - a * 2;\nRETURN e\nEND.\n"));
+    ASSERT_FALSE(func.getUpdateStatistics().fullCompilation);
+    ASSERT_EQ(func(2, 3), 35);
+
+    // An error keeps the current version
+    ASSERT_FALSE(func.update("PARAM a, b;\nVAR c, d, e;\nBEGIN\nc := a + 1;\nc := c + ;\nd := c * b;\ne := d - a * 2;\nRETURN e\nEND.\n"));
+    ASSERT_FALSE(func.update("PARAM a, b;\nVAR c, d, e;\nBEGIN\nc := a + 1;\nc := x + 10;\nd := c * b;\ne := d - a * 2;\nRETURN e\nEND.\n"));
+    ASSERT_EQ(func(2, 3), 35);
+
+    // Removing the initialization of a variable that a later statement uses
+    ASSERT_FALSE(func.update("PARAM a, b;\nVAR c, d, e;\nBEGIN\nc := a + 1;\nc := c + 10;\nRETURN c;\ne := d - a * 2;\nRETURN e\nEND.\n"));
+    ASSERT_EQ(func(2, 3), 35);
+
+    // A changed header needs a full compilation
+    ASSERT_TRUE(func.update("PARAM a, b;\nVAR c, d, e;\nCONST f = 4;\nBEGIN\nc := a + 1;\nc := c + f;\nd := c * b;\ne := d - a * 2;\nRETURN e\nEND.\n"));
+    ASSERT_TRUE(func.getUpdateStatistics().fullCompilation);
+    ASSERT_EQ(func(2, 3), 17);
+
+    ASSERT_TRUE(func.update("BEGIN RETURN 6 * 7 END."));
+    ASSERT_TRUE(func.isConstantFolded());
+    ASSERT_EQ(func(), 42);
+}
+//---------------------------------------------------------------------------
+TEST(TestPljit, ExecutionProfile) {
+    const auto code =
+        "PARAM a, b;\n"
+        "VAR c;\n"
+        "BEGIN\n"
+        "c := a * b;\n"
+        "RETURN c / (b - 2)\n"
+        "END.\n";
+
+    Pljit jit;
+    auto func = jit.registerFunction(code, OptimizationLevel::O0);
+    func.enableProfiling();
+    for (int64_t i = 0; i < 95; i++) {
+        ASSERT_EQ(func(i, 5), i * 5 / 3);
+    }
+    for (int64_t i = 0; i < 5; i++) {
+        ASSERT_FALSE(func(i, 2).has_value());
+    }
+    func.disableProfiling();
+    ASSERT_EQ(func(1, 5), 1);
+
+    auto profile = func.getProfile();
+    ASSERT_EQ(profile.getCalls(), 100);
+    ASSERT_EQ(profile.getStatements().size(), 2);
+    ASSERT_EQ(profile.getStatements()[0].executions, 100);
+    ASSERT_EQ(profile.getStatements()[1].executions, 100);
+    ASSERT_EQ(profile.getStatements()[0].zeroDivisors, 0);
+    ASSERT_EQ(profile.getStatements()[1].zeroDivisors, 5);
+    ASSERT_EQ(profile.getDominantValue(1, 0.9), 5);
+    ASSERT_FALSE(profile.getDominantValue(0, 0.9).has_value());
+    ASSERT_FALSE(profile.getDominantValue(1, 0.99).has_value());
+
+    // The text format keeps all measurements
+    stringstream out;
+    profile.write(out);
+    auto readProfile = ExecutionProfile::read(out);
+    ASSERT_TRUE(readProfile.has_value());
+    ASSERT_EQ(readProfile->getCalls(), 100);
+    ASSERT_EQ(readProfile->getStatements()[1].zeroDivisors, 5);
+    ASSERT_EQ(readProfile->getStatements()[1].time, profile.getStatements()[1].time);
+    stringstream malformed("pljit-profile 1\ncalls x\n");
+    ASSERT_FALSE(ExecutionProfile::read(malformed).has_value());
+
+    // A value that becomes frequent after the tracked values are full replaces the least counted one
+    ExecutionProfile lateProfile;
+    for (int64_t i = 0; i < 2 * static_cast<int64_t>(ExecutionProfile::maxTrackedValues); i++) {
+        lateProfile.recordCall(array<int64_t, 1>{i});
+    }
+    for (int64_t i = 0; i < 500; i++) {
+        lateProfile.recordCall(array<int64_t, 1>{42});
+    }
+    ASSERT_EQ(lateProfile.getDominantValue(0, 0.9), 42);
+
+    // The statements are numbered as in the code at every optimization level
+    const auto splitCode = "PARAM a, b; VAR c, d; BEGIN c := 1; d := a * b; RETURN d / (b - 2) END.";
+    for (OptimizationLevel level : {OptimizationLevel::O0, OptimizationLevel::O1, OptimizationLevel::O2}) {
+        auto levelFunc = jit.registerFunction(splitCode, level);
+        levelFunc.enableProfiling();
+        for (int64_t i = 0; i < 10; i++) {
+            ASSERT_EQ(levelFunc(i, 5), i * 5 / 3);
+        }
+        ASSERT_FALSE(levelFunc(1, 2).has_value());
+        auto levelProfile = levelFunc.getProfile();
+        ASSERT_EQ(levelProfile.getStatements().size(), 3);
+        ASSERT_EQ(levelProfile.getStatements()[2].executions, 11);
+        ASSERT_EQ(levelProfile.getStatements()[2].zeroDivisors, 1);
+    }
+
+    // A later compilation specializes on the dominant value
+    string path = testing::TempDir() + "pljit_profile.txt";
+    ASSERT_TRUE(func.saveProfile(path));
+    auto optimized = jit.registerFunction(code);
+    ASSERT_TRUE(optimized.loadProfile(path));
+    ASSERT_EQ(optimized.getProfileBinding(), ParameterBinding({{1, 5}}));
+    ASSERT_EQ(optimized(6, 5), 10);
+    ASSERT_EQ(optimized(6, 4), 12);
+    ASSERT_FALSE(optimized(6, 2).has_value());
+    vector<vector<int64_t>> calls = {{6, 5}, {6, 4}, {9, 5}};
+    auto results = optimized.evaluateBatch(calls);
+    ASSERT_EQ(results[0], 10);
+    ASSERT_EQ(results[1], 12);
+    ASSERT_EQ(results[2], 15);
+    ASSERT_FALSE(optimized.loadProfile(testing::TempDir() + "pljit_missing_profile.txt"));
+    remove(path.c_str());
+
+    // Concurrent calls and batches evaluate without the lock and add their profiles to the one of the handle
+    auto concurrent = jit.registerFunction(code, OptimizationLevel::O0);
+    concurrent.enableProfiling();
+    vector<thread> threads;
+    for (int64_t i = 0; i < 4; i++) {
+        threads.emplace_back([&concurrent] {
+            for (int64_t j = 0; j < 50; j++) {
+                concurrent(j, 5);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    concurrent.evaluateBatch(calls);
+    ASSERT_EQ(concurrent.getProfile().getCalls(), 203);
+    ASSERT_EQ(concurrent.getProfile().getStatements()[0].executions, 203);
+    ASSERT_EQ(concurrent.getProfile().getDominantValue(1, 0.9), 5);
+}
+//---------------------------------------------------------------------------
+TEST(TestPljit, Trace) {
+    string path = testing::TempDir() + "pljit_trace.json";
+    Pljit jit;
+    auto func = jit.registerFunction("PARAM a; BEGIN RETURN a * 2 END.");
+    TraceStatistics statistics;
+    {
+        Tracer tracer(path);
+        ASSERT_TRUE(tracer.isOpen());
+        ASSERT_TRUE(Tracer::isActive());
+
+        // Only one tracer is active at a time
+        Tracer second(testing::TempDir() + "pljit_trace_second.json");
+        ASSERT_FALSE(second.isOpen());
+
+        vector<thread> threads;
+        for (int64_t i = 0; i < 2; i++) {
+            threads.emplace_back([&func, i] {
+                for (int64_t j = 0; j < 50; j++) {
+                    ASSERT_EQ(func(i + j), 2 * (i + j));
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        statistics = tracer.getStatistics();
+    }
+    ASSERT_FALSE(Tracer::isActive());
+    ASSERT_EQ(statistics.threads, 2);
+    ASSERT_EQ(statistics.dropped, 0);
+
+    ifstream in(path);
+    string trace((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+    ASSERT_EQ(trace.rfind("{\"traceEvents\":[", 0), 0);
+    ASSERT_EQ(trace.substr(trace.size() - 4), "\n]}\n");
+    for (string_view name : {"parsing", "semanticAnalysis", "optimization", "evaluation", "lockWait"}) {
+        ASSERT_NE(trace.find("\"name\":\"" + string(name) + "\""), string::npos) << name;
+    }
+    ASSERT_NE(trace.find("\"args\":{\"function\":" + to_string(func.getId()) + "}"), string::npos);
+    // The lexing is timed whenever a tracer is active
+    size_t lexing = trace.find("\"name\":\"lexing\"");
+    ASSERT_NE(lexing, string::npos);
+    size_t duration = trace.find("\"dur\":", lexing) + 6;
+    ASSERT_NE(trace.substr(duration, trace.find(',', duration) - duration), "0.000");
+    // Every call waits for the lock once and evaluates without it
+    ASSERT_EQ(count(trace.begin(), trace.end(), '\n'), 100 * 2 + 4 + 2);
+
+    // Events are dropped instead of blocking a thread whose buffer is full
+    {
+        TraceOptions options;
+        options.bufferCapacity = 4;
+        options.flushInterval = chrono::hours(1);
+        Tracer tracer(path, options);
+        for (int64_t i = 0; i < 10; i++) {
+            ASSERT_EQ(func(i), 2 * i);
+        }
+        ASSERT_GT(tracer.getStatistics().dropped, 0);
+    }
+    remove(path.c_str());
+}
+//---------------------------------------------------------------------------
+TEST(TestPljit, Metrics) {
+    Pljit jit;
+    auto func = jit.registerFunction("PARAM a, b; BEGIN RETURN a / b END.");
+    auto broken = jit.registerFunction("PARAM a; BEGIN RETURN b END.");
+
+    for (int64_t i = 0; i < 20; i++) {
+        ASSERT_EQ(func(i, 1), i);
+    }
+    ASSERT_FALSE(func(1, 0).has_value());
+    ASSERT_FALSE(func(1).has_value());
+    ASSERT_FALSE(broken(1).has_value());
+    vector<vector<int64_t>> calls = {{4, 2}, {4, 0}};
+    func.evaluateBatch(calls);
+
+    auto metrics = func.getMetrics();
+    ASSERT_EQ(metrics.functionId, func.getId());
+    ASSERT_EQ(metrics.calls, 24);
+    ASSERT_EQ(metrics.compileErrors, 0);
+    ASSERT_EQ(metrics.parameterCountErrors, 1);
+    ASSERT_EQ(metrics.divisionByZeroErrors, 2);
+    ASSERT_EQ(metrics.latency.total, 22);
+    ASSERT_GT(metrics.latency.percentile(0.5).count(), 0);
+    ASSERT_LE(metrics.latency.percentile(0.5), metrics.latency.percentile(0.99));
+    ASSERT_LE(metrics.latency.percentile(0.99), metrics.latency.percentile(1.0));
+
+    // The snapshot of the instance adds up all handles
+    auto aggregate = jit.getMetrics();
+    ASSERT_EQ(aggregate.functionId, 0);
+    ASSERT_EQ(aggregate.calls, 25);
+    ASSERT_EQ(aggregate.compileErrors, 1);
+    ASSERT_EQ(aggregate.latency.total, 23);
+    ASSERT_EQ(jit.getHandleMetrics().size(), 2);
+
+    // Every value lies in a bucket whose width is at most 1/16 of its values
+    for (uint64_t value : {0ull, 15ull, 16ull, 17ull, 1000ull, 123456789ull, ~0ull}) {
+        size_t bucket = LatencyHistogram::getBucket(value);
+        ASSERT_LT(bucket, LatencyHistogram::bucketCount);
+        ASSERT_GE(LatencyHistogram::getUpperBound(bucket), value);
+        ASSERT_LE(LatencyHistogram::getUpperBound(bucket) - value, value / 16);
+        ASSERT_TRUE(bucket == 0 || LatencyHistogram::getUpperBound(bucket - 1) < value);
+    }
+
+    // The counts of a destroyed handle stay in the aggregate, an idle handle has no latencies
+    {
+        auto temporary = jit.registerFunction("PARAM a; BEGIN RETURN a END.");
+        ASSERT_EQ(temporary.getMetrics().latency.total, 0);
+        ASSERT_EQ(temporary(7), 7);
+        ASSERT_EQ(jit.getHandleMetrics().size(), 3);
+    }
+    ASSERT_EQ(jit.getHandleMetrics().size(), 2);
+    aggregate = jit.getMetrics();
+    ASSERT_EQ(aggregate.calls, 26);
+    ASSERT_EQ(aggregate.compileErrors, 1);
+    ASSERT_EQ(aggregate.latency.total, 24);
+}
+//---------------------------------------------------------------------------
+TEST(TestPljit, RecordAndReplay) {
+    string path = testing::TempDir() + "pljit_recording.bin";
+    const auto code = "PARAM a, b; BEGIN RETURN a / b END.";
+    {
+        Pljit jit;
+        auto before = jit.registerFunction(code);
+        ASSERT_TRUE(jit.startRecording(path));
+        auto func = jit.registerFunction("PARAM a; BEGIN RETURN -a END.");
+        auto unused = jit.registerFunction("BEGIN RETURN 1 END.");
+
+        vector<thread> threads;
+        for (int64_t i = 0; i < 2; i++) {
+            threads.emplace_back([&before, i] {
+                for (int64_t j = 0; j < 20; j++) {
+                    before(j, i);
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        ASSERT_EQ(func(-1234567890123), 1234567890123);
+        vector<vector<int64_t>> calls = {{1}, {2}};
+        func.evaluateBatch(calls);
+        ASSERT_TRUE(func.update("PARAM a; BEGIN RETURN a + 1 END."));
+        ASSERT_EQ(func(1), 2);
+        jit.stopRecording();
+        ASSERT_EQ(func(5), 6);
+    }
+
+    auto events = Recorder::read(path);
+    ASSERT_TRUE(events.has_value());
+    // Three registrations, an update and 44 invocations
+    ASSERT_EQ(events->size(), 3 + 1 + 44);
+    size_t registrations = 0;
+    for (const auto& event : *events) {
+        registrations += event.kind == RecordedEvent::Kind::Registration;
+    }
+    ASSERT_EQ(registrations, 4);
+    auto negation = find_if(events->begin(), events->end(), [](const RecordedEvent& event) {
+        return event.kind == RecordedEvent::Kind::Invocation && event.parameters.size() == 1;
+    });
+    ASSERT_EQ(negation->parameters[0], -1234567890123);
+    ASSERT_EQ(negation->result, 1234567890123);
+    map<uint32_t, chrono::nanoseconds> lastTimestamps;
+    for (const auto& event : *events) {
+        ASSERT_GE(event.timestamp, lastTimestamps[event.thread]);
+        lastTimestamps[event.thread] = event.timestamp;
+    }
+    ASSERT_EQ(lastTimestamps.size(), 3);
+
+    // The results of the replay match the recording, the divisions by zero included
+    ReplayResult result = Replayer(*events).run();
+    ASSERT_EQ(result.invocations, 44);
+    ASSERT_EQ(result.mismatches, 0);
+    ASSERT_EQ(result.threads, 3);
+    ASSERT_EQ(result.latency.total, 44);
+    ASSERT_GT(result.getThroughput(), 0);
+
+    ReplayOptions options;
+    options.timed = true;
+    ASSERT_EQ(Replayer(*events).run(options).mismatches, 0);
+
+    // The settings of the handles are recorded and a finalized handle still registers its updated code
+    {
+        Pljit jit;
+        auto updated = jit.registerFunction("PARAM a; BEGIN RETURN a END.");
+        ASSERT_TRUE(updated.update("PARAM a; BEGIN RETURN a * 2 END."));
+        ASSERT_TRUE(updated.finalize());
+        auto trapping = jit.registerFunction("PARAM a; VAR b; BEGIN b := a * a; RETURN b END.", OptimizationLevel::O2, ArithmeticMode::Trapping);
+        ASSERT_TRUE(jit.startRecording(path));
+        ASSERT_EQ(updated(3), 6);
+        ASSERT_EQ(trapping(3), 9);
+        ASSERT_FALSE(trapping(int64_t(1) << 32));
+        trapping.setFuelLimit(1);
+        ASSERT_FALSE(trapping(3));
+        jit.stopRecording();
+    }
+    events = Recorder::read(path);
+    ASSERT_TRUE(events.has_value());
+    ASSERT_EQ(events->size(), 2 + 1 + 4);
+    ASSERT_EQ((*events)[0].code, "PARAM a; BEGIN RETURN a * 2 END.");
+    ASSERT_EQ((*events)[2].settings.pipeline, PassManager::getPipeline(OptimizationLevel::O2));
+    ASSERT_EQ((*events)[2].settings.arithmeticMode, ArithmeticMode::Trapping);
+    ASSERT_EQ((*events)[5].settings.fuelLimit, 1);
+    result = Replayer(*events).run();
+    ASSERT_EQ(result.invocations, 4);
+    ASSERT_EQ(result.mismatches, 0);
+
+    ofstream truncated(path, ios::binary | ios::trunc);
+    truncated << "PLJT";
+    truncated.close();
+    ASSERT_FALSE(Recorder::read(path).has_value());
+    remove(path.c_str());
+}
+//---------------------------------------------------------------------------
+TEST(TestPljit, Bundle) {
+    const string bundle =
+        "PARAM a, b; BEGIN RETURN a + b END.\n"
+        "  BEGIN RETURN 7 END.\n"
+        "PARAM a; BEGIN RETURN a * END.\n"
+        "PARAM a; VAR b; BEGIN b := a * a; RETURN b END.";
+    auto inputs = Pljit::splitBundle(bundle);
+    ASSERT_EQ(inputs.size(), 4);
+    ASSERT_EQ(inputs[1], "BEGIN RETURN 7 END.");
+    ASSERT_TRUE(Pljit::splitBundle(" \n\t").empty());
+    ASSERT_EQ(Pljit::splitBundle("BEGIN RETURN 1 END. BEGIN").back(), "BEGIN");
+
+    string path = testing::TempDir() + "pljit_bundle.pl";
+    {
+        ofstream out(path, ios::binary);
+        out << bundle;
+    }
+    MappedFile file(path);
+    ASSERT_TRUE(file.isOpen());
+    ASSERT_EQ(file.getContents(), bundle);
+
+    ThreadPool pool(2);
+    Pljit jit;
+    auto handles = jit.registerBundle(pool, file.getContents());
+    ASSERT_EQ(handles.size(), 4);
+    ASSERT_EQ((*handles[0])(2, 3), 5);
+    ASSERT_EQ((*handles[1])(), 7);
+    ASSERT_FALSE(handles[2]->isCompiled());
+    ASSERT_EQ((*handles[3])(4), 16);
+
+    MappedFile moved = move(file);
+    ASSERT_FALSE(file.isOpen());
+    ASSERT_EQ(moved.getContents().size(), bundle.size());
+    ASSERT_FALSE(MappedFile(testing::TempDir() + "pljit_missing_bundle.pl").isOpen());
+    remove(path.c_str());
+}
+//---------------------------------------------------------------------------
+TEST(TestPljit, StreamEvaluation) {
+    Pljit jit;
+    auto func = jit.registerFunction("PARAM a, b; BEGIN RETURN a / b END.");
+    ThreadPool pool(3);
+    StreamEvaluator evaluator(func, pool);
+
+    // Small morsels split the text between lines, the results keep the order of the rows
+    string inputPath = testing::TempDir() + "pljit_stream_input.txt";
+    string outputPath = testing::TempDir() + "pljit_stream_output.txt";
+    string expected;
+    {
+        ofstream out(inputPath, ios::binary);
+        for (int64_t i = 0; i < 1000; i++) {
+            out << i << "," << (i % 7) << "\n";
+            expected += i % 7 == 0 ? "error\n" : to_string(i / (i % 7)) + "\n";
+        }
+        out << "\n1 2 3\n8 x\n9\t3";
+        expected += "error\nerror\n3\n";
+    }
+    StreamOptions options;
+    options.morselSize = 64;
+    options.window = 4;
+    auto result = evaluator.run(inputPath, outputPath, options);
+    ASSERT_TRUE(result);
+    ASSERT_EQ(result->rows, 1003);
+    ASSERT_EQ(result->malformed, 2);
+    ASSERT_EQ(result->errors, 143 + 2);
+    {
+        ifstream in(outputPath, ios::binary);
+        ASSERT_EQ(string(istreambuf_iterator<char>(in), istreambuf_iterator<char>()), expected);
+    }
+    ASSERT_EQ(result->bytesWritten, expected.size());
+
+    // Binary rows are evaluated in place
+    string binaryPath = testing::TempDir() + "pljit_stream_input.bin";
+    {
+        ofstream out(binaryPath, ios::binary);
+        array<int64_t, 6> rows = {10, 2, 7, 0, -9, 3};
+        out.write(reinterpret_cast<const char*>(rows.data()), sizeof(rows));
+    }
+    options.inputFormat = StreamFormat::Binary;
+    options.outputFormat = StreamFormat::Binary;
+    options.morselSize = 1;
+    result = evaluator.run(binaryPath, outputPath, options);
+    ASSERT_TRUE(result);
+    ASSERT_EQ(result->rows, 3);
+    ASSERT_EQ(result->errors, 1);
+    {
+        ifstream in(outputPath, ios::binary);
+        string output(istreambuf_iterator<char>(in), (istreambuf_iterator<char>()));
+        ASSERT_EQ(output.size(), 27);
+        int64_t value = 0;
+        memcpy(&value, output.data() + 1, sizeof(value));
+        ASSERT_EQ(output[0], 1);
+        ASSERT_EQ(value, 5);
+        ASSERT_EQ(output[9], 0);
+        memcpy(&value, output.data() + 19, sizeof(value));
+        ASSERT_EQ(value, -3);
+    }
+
+    // A binary file has to consist of whole rows
+    {
+        ofstream out(binaryPath, ios::binary | ios::app);
+        out << "x";
+    }
+    ASSERT_FALSE(evaluator.run(binaryPath, outputPath, options));
+    ASSERT_FALSE(evaluator.run(testing::TempDir() + "pljit_missing_stream.bin", outputPath, options));
+    ASSERT_EQ(func.getMetrics().calls, 1003 + 3);
+    remove(inputPath.c_str());
+    remove(binaryPath.c_str());
+    remove(outputPath.c_str());
+}
+//---------------------------------------------------------------------------
+TEST(TestPljit, Server) {
+    string path = testing::TempDir() + "pljit_server.sock";
+    ServerOptions options;
+    options.workers = 3;
+    Server server(options);
+    ASSERT_TRUE(server.listen(path));
+    thread loop([&server] { server.run(); });
+
+    const string code = "PARAM a, b; BEGIN RETURN a / b END.";
+    ServerClient first;
+    ServerClient second;
+    ASSERT_TRUE(first.connect(path));
+    ASSERT_TRUE(second.connect(path));
+
+    // Both clients get the same compiled function
+    ASSERT_TRUE(first.sendRegister(1, code));
+    auto registered = first.receive();
+    ASSERT_TRUE(registered);
+    ASSERT_EQ(registered->status, ResponseStatus::Ok);
+    ASSERT_EQ(registered->parameterCount, 2);
+    ASSERT_TRUE(second.sendRegister(1, code));
+    auto shared = second.receive();
+    ASSERT_TRUE(shared);
+    ASSERT_EQ(shared->functionId, registered->functionId);
+    uint64_t function = registered->functionId;
+
+    // Pipelined requests are answered in any order
+    for (uint32_t i = 0; i < 100; i++) {
+        array<int64_t, 2> parameters = {static_cast<int64_t>(i), static_cast<int64_t>(i % 5)};
+        ASSERT_TRUE(first.sendEvaluate(i, function, parameters));
+    }
+    vector<int64_t> batch = {8, 2, 1, 0, 9, 3};
+    ASSERT_TRUE(first.sendEvaluateBatch(100, function, 2, batch));
+    ASSERT_TRUE(first.sendEvaluate(101, function + 1000, batch));
+    ASSERT_TRUE(first.sendRegister(102, "BEGIN RETURN END."));
+    ASSERT_TRUE(first.sendEvaluateBatch(103, function, 0, batch));
+    vector<bool> answered(104, false);
+    for (size_t i = 0; i < answered.size(); i++) {
+        auto response = first.receive();
+        ASSERT_TRUE(response);
+        ASSERT_LT(response->requestId, answered.size());
+        ASSERT_FALSE(answered[response->requestId]);
+        answered[response->requestId] = true;
+        uint32_t id = response->requestId;
+        if (id < 100) {
+            if (id % 5 == 0) {
+                ASSERT_EQ(response->status, ResponseStatus::EvaluationError);
+            } else {
+                ASSERT_EQ(response->status, ResponseStatus::Ok);
+                ASSERT_EQ(response->results, vector<optional<int64_t>>(1, id / (id % 5)));
+            }
+        } else if (id == 100) {
+            ASSERT_EQ(response->results, (vector<optional<int64_t>>{4, nullopt, 3}));
+        } else if (id == 101) {
+            ASSERT_EQ(response->status, ResponseStatus::UnknownFunction);
+        } else if (id == 102) {
+            ASSERT_EQ(response->status, ResponseStatus::CompileError);
+        } else {
+            ASSERT_EQ(response->status, ResponseStatus::Malformed);
+        }
+    }
+
+    server.stop();
+    loop.join();
+    auto statistics = server.getStatistics();
+    ASSERT_EQ(statistics.connections, 2);
+    ASSERT_EQ(statistics.requests, 106);
+    ASSERT_EQ(statistics.registrations, 3);
+    ASSERT_EQ(statistics.sharedRegistrations, 1);
+    ASSERT_EQ(statistics.functions, 2);
+
+    // The least recently used function is removed once more codes are registered than the server keeps
+    ServerOptions smallOptions;
+    smallOptions.workers = 1;
+    smallOptions.maxFunctions = 2;
+    Server small(smallOptions);
+    const string identity = "PARAM a; BEGIN RETURN a END.";
+    const string increment = "PARAM a; BEGIN RETURN a + 1 END.";
+    auto identityFunction = small.registerFunction(identity);
+    auto incrementFunction = small.registerFunction(increment);
+    ASSERT_TRUE(identityFunction && incrementFunction);
+    ASSERT_EQ(small.registerFunction(identity)->first, identityFunction->first);
+    // A code that does not compile is kept, its second registration fails without compiling it again
+    ASSERT_FALSE(small.registerFunction("PARAM a; BEGIN RETURN b END."));
+    ASSERT_FALSE(small.registerFunction("PARAM a; BEGIN RETURN b END."));
+    ASSERT_EQ(small.getStatistics().functions, 2);
+    ASSERT_EQ(small.getStatistics().sharedRegistrations, 2);
+    ASSERT_EQ(small.registerFunction(identity)->first, identityFunction->first);
+    auto registeredAgain = small.registerFunction(increment);
+    ASSERT_TRUE(registeredAgain);
+    ASSERT_NE(registeredAgain->first, incrementFunction->first);
+}
+//---------------------------------------------------------------------------
+TEST(TestPljit, ServerBackpressure) {
+    string path = testing::TempDir() + "pljit_server_backpressure.sock";
+    ServerOptions options;
+    options.workers = 2;
+    options.maxPendingRequests = 4;
+    options.maxPendingBytes = 256;
+    Server server(options);
+    ASSERT_TRUE(server.listen(path));
+    thread loop([&server] { server.run(); });
+    auto function = server.registerFunction("PARAM a; BEGIN RETURN a * 2 END.");
+    ASSERT_TRUE(function);
+
+    // The server stops reading while a connection has too many pending requests, all of them are still answered
+    ServerClient client;
+    ASSERT_TRUE(client.connect(path));
+    constexpr uint32_t requestCount = 2000;
+    thread sender([&client, &function] {
+        for (uint32_t i = 0; i < requestCount; i++) {
+            array<int64_t, 1> parameters = {static_cast<int64_t>(i)};
+            client.sendEvaluate(i, function->first, parameters);
+        }
+        // The responses that are still pending are written after the client finished sending
+        client.finishSending();
+    });
+    vector<bool> answered(requestCount, false);
+    for (uint32_t i = 0; i < requestCount; i++) {
+        auto response = client.receive();
+        ASSERT_TRUE(response);
+        ASSERT_LT(response->requestId, requestCount);
+        ASSERT_FALSE(answered[response->requestId]);
+        answered[response->requestId] = true;
+        ASSERT_EQ(response->results, vector<optional<int64_t>>(1, 2 * response->requestId));
+    }
+    sender.join();
+    ASSERT_FALSE(client.receive());
+
+    // A client that finishes sending before it receives gets all responses
+    ServerClient pipelined;
+    ASSERT_TRUE(pipelined.connect(path));
+    for (uint32_t i = 0; i < 50; i++) {
+        array<int64_t, 1> parameters = {static_cast<int64_t>(i)};
+        ASSERT_TRUE(pipelined.sendEvaluate(i, function->first, parameters));
+    }
+    ASSERT_TRUE(pipelined.finishSending());
+    for (uint32_t i = 0; i < 50; i++) {
+        auto response = pipelined.receive();
+        ASSERT_TRUE(response);
+        ASSERT_EQ(response->status, ResponseStatus::Ok);
+    }
+    ASSERT_FALSE(pipelined.receive());
+
+    server.stop();
+    loop.join();
+    ASSERT_EQ(server.getStatistics().requests, requestCount + 50);
+}
+//---------------------------------------------------------------------------
+TEST(TestPljit, Fuel) {
+    Pljit jit;
+    auto func = jit.registerFunction("PARAM a; VAR b, c; BEGIN b := a + 1; c := b * b; RETURN c - a END.", OptimizationLevel::O0);
+    ASSERT_EQ(func(3), 13);
+
+    // The statements consume 6, 6 and 5 nodes
+    func.setFuelLimit(17);
+    ASSERT_EQ(func(3), 13);
+    func.setFuelLimit(16);
+    CallOutcome outcome = CallOutcome::Success;
+    array<int64_t, 1> parameters = {3};
+    ASSERT_FALSE(func(span<const int64_t>(parameters), outcome));
+    ASSERT_EQ(outcome, CallOutcome::FuelExhausted);
+
+    auto results = func.evaluateBatch(vector<vector<int64_t>>(3, vector<int64_t>(1, 2)));
+    ASSERT_EQ(results, vector<optional<int64_t>>(3, nullopt));
+    auto metrics = func.getMetrics();
+    ASSERT_EQ(metrics.fuelExhaustedErrors, 4);
+    ASSERT_EQ(metrics.divisionByZeroErrors, 0);
+
+    // A division by zero is still reported as such
+    auto divide = jit.registerFunction("PARAM a; BEGIN RETURN 1 / a END.");
+    divide.setFuelLimit(100);
+    array<int64_t, 1> zero = {0};
+    ASSERT_FALSE(divide(span<const int64_t>(zero), outcome));
+    ASSERT_EQ(outcome, CallOutcome::DivisionByZero);
+
+    // A function without parameters is evaluated during the compilation, which is not limited
+    auto constant = jit.registerFunction("BEGIN RETURN 1 + 2 * 3 END.", OptimizationLevel::O0);
+    constant.setFuelLimit(1);
+    ASSERT_EQ(constant(), 7);
+
+    func.setFuelLimit(0);
+    ASSERT_EQ(func(3), 13);
+}
+//---------------------------------------------------------------------------
+TEST(TestPljit, Finalize) {
+    Pljit jit;
+    auto code = make_unique<string>("PARAM a, b; VAR c, d; BEGIN c := a + 1; d := c * c; RETURN d / b - a END.");
+    auto func = jit.registerFunction(*code, OptimizationLevel::O0);
+    ASSERT_EQ(func(3, 2), 5);
+    ASSERT_TRUE(func.finalize());
+    ASSERT_TRUE(func.finalize());
+    ASSERT_TRUE(func.isFinalized());
+    ASSERT_NE(func.getImage(), nullptr);
+    ASSERT_EQ(func.getImage()->getParameterCount(), 2);
+    ASSERT_GT(func.getImage()->getMemoryUsage(), 0);
+
+    // The image refers to no source code
+    code.reset();
+    ASSERT_EQ(func(3, 2), 5);
+    ASSERT_EQ(func(-4, 3), 7);
+    ASSERT_FALSE(func(3));
+    CallOutcome outcome = CallOutcome::Success;
+    array<int64_t, 2> zero = {3, 0};
+    ASSERT_FALSE(func(span<const int64_t>(zero), outcome));
+    ASSERT_EQ(outcome, CallOutcome::DivisionByZero);
+    ASSERT_EQ(func(ParameterBinding({{1, 4}}), array<int64_t, 1>{3}), 1);
+
+    auto results = func.evaluateBatch(vector<vector<int64_t>>{{3, 2}, {3, 0}, {1}});
+    ASSERT_EQ(results, vector<optional<int64_t>>({5, nullopt, nullopt}));
+    auto metrics = func.getMetrics();
+    ASSERT_EQ(metrics.divisionByZeroErrors, 2);
+    ASSERT_EQ(metrics.parameterCountErrors, 2);
+
+    // The statements consume 6, 6 and 7 nodes, an error before the fuel runs out takes precedence
+    func.setFuelLimit(19);
+    ASSERT_EQ(func(3, 2), 5);
+    func.setFuelLimit(18);
+    array<int64_t, 2> parameters = {3, 2};
+    ASSERT_FALSE(func(span<const int64_t>(parameters), outcome));
+    ASSERT_EQ(outcome, CallOutcome::FuelExhausted);
+    func.setFuelLimit(0);
+
+    // A finalized function cannot change anymore
+    ASSERT_FALSE(func.update("PARAM a, b; BEGIN RETURN a END."));
+    ASSERT_FALSE(func.specialize({{0, 1}}));
+    ASSERT_FALSE(func.enableMemoization(1 << 10));
+    ASSERT_EQ(func(3, 2), 5);
+
+    auto constant = jit.registerFunction("BEGIN RETURN 6 * 7 END.");
+    ASSERT_TRUE(constant.finalize());
+    ASSERT_EQ(constant.getImage(), nullptr);
+    ASSERT_EQ(constant(), 42);
+}
+//---------------------------------------------------------------------------
+TEST(TestPljit, FinalizeConcurrently) {
+    Pljit jit;
+    // Calls that race the finalization run either on the ast or on the image
+    for (int round = 0; round < 20; round++) {
+        auto func = jit.registerFunction("PARAM a, b; BEGIN RETURN a * 2 + b END.");
+        ASSERT_EQ(func(1, 0), 2);
+        thread caller([&] {
+            for (int64_t i = 0; i < 100; i++) {
+                EXPECT_EQ(func(i, 1), 2 * i + 1);
+                EXPECT_EQ(func(ParameterBinding({{1, 3}}), array<int64_t, 1>{i}), 2 * i + 3);
+            }
+        });
+        ASSERT_TRUE(func.finalize());
+        caller.join();
+        ASSERT_EQ(func(5, 1), 11);
+    }
+
+    // A batch evaluates the version of its start, updates and the finalization do not release it meanwhile
+    ThreadPool pool(4);
+    vector<vector<int64_t>> calls(2000, {3});
+    for (int round = 0; round < 10; round++) {
+        auto func = jit.registerFunction("PARAM a; BEGIN RETURN a END.");
+        func.enableProfiling();
+        thread caller([&] {
+            for (int i = 0; i < 5; i++) {
+                for (const auto& result : func.evaluateParallel(pool, calls, 64)) {
+                    EXPECT_TRUE(result == 3 || result == 6 || result == 9);
+                }
+                vector<optional<int64_t>> results(2);
+                array<int64_t, 2> rows = {3, 3};
+                EXPECT_TRUE(func.evaluateRows(rows, results));
+            }
+        });
+        ASSERT_TRUE(func.update("PARAM a; BEGIN RETURN a * 2 END."));
+        ASSERT_TRUE(func.update("PARAM a; BEGIN RETURN a * 3 END."));
+        ASSERT_TRUE(func.finalize());
+        caller.join();
+        ASSERT_EQ(func(3), 9);
+    }
+}
+//---------------------------------------------------------------------------
+TEST(TestPljit, MemoryResource) {
+    CountingResource resource;
+    {
+        Pljit jit(&resource);
+        ThreadPool pool(4);
+        vector<string_view> codes(8, "PARAM a, b; VAR c; BEGIN c := a * b; RETURN c + a END.");
+        auto handles = jit.registerFunctions(pool, codes);
+        for (auto& handle : handles) {
+            ASSERT_EQ((*handle)(2, 5), 12);
+        }
+        size_t allocated = resource.allocated;
+        ASSERT_GT(allocated, 0);
+
+        // A finalized function returns its ast to the resource
+        ASSERT_TRUE(handles[0]->finalize());
+        ASSERT_GT(resource.deallocated, 0);
+        ASSERT_EQ((*handles[0])(2, 5), 12);
+
+        // The specialized versions are allocated from the resource as well
+        ASSERT_EQ((*handles[1])(ParameterBinding({{0, 3}}), vector<int64_t>{0, 4}), 15);
+        ASSERT_GT(resource.allocated, allocated);
+    }
+    ASSERT_EQ(resource.deallocated, resource.allocated);
+
+    // The optimized asts stay in the resource at every level until the function is finalized
+    for (OptimizationLevel level : {OptimizationLevel::O1, OptimizationLevel::O2}) {
+        CountingResource levelResource;
+        Pljit jit(&levelResource);
+        auto func = jit.registerFunction("PARAM a, b; VAR c; BEGIN c := a * b; RETURN c + a END.", level);
+        ASSERT_EQ(func(2, 5), 12);
+        ASSERT_GT(levelResource.allocated - levelResource.deallocated, 0);
+        ASSERT_TRUE(func.finalize());
+        ASSERT_EQ(levelResource.deallocated, levelResource.allocated);
+    }
+}
+//---------------------------------------------------------------------------
+TEST(TestPljit, ArithmeticMode) {
+    Pljit jit;
+    const int64_t max = numeric_limits<int64_t>::max();
+    const int64_t min = numeric_limits<int64_t>::min();
+    struct Case {
+        string_view code;
+        vector<int64_t> parameters;
+        // Expected results of the wrapping, trapping and saturating mode, nullopt for an overflow
+        array<optional<int64_t>, 3> results;
+    };
+    vector<Case> cases = {
+        {"PARAM a, b; BEGIN RETURN a + b END.", {max, 1}, {{min, nullopt, max}}},
+        {"PARAM a, b; BEGIN RETURN a - b END.", {min, 1}, {{max, nullopt, min}}},
+        {"PARAM a, b; BEGIN RETURN a * b END.", {max, -2}, {{2, nullopt, min}}},
+        {"PARAM a, b; BEGIN RETURN a / b END.", {min, -1}, {{min, nullopt, max}}},
+        {"PARAM a, b; BEGIN RETURN a / b END.", {min, 1}, {{min, min, min}}},
+        // An overflow is remembered until the end of its statement
+        {"PARAM a; BEGIN RETURN (a + 1) - 1 END.", {max}, {{max, nullopt, max - 1}}},
+        {"PARAM a; VAR b; BEGIN b := a * 2; RETURN b / 2 END.", {max}, {{-1, nullopt, max / 2}}},
+        // The negations cancel only if the results wrap
+        {"PARAM a; BEGIN RETURN -(-a) END.", {min}, {{min, nullopt, min + 1}}},
+        // The folding of constants respects the mode
+        {"PARAM a; VAR b; BEGIN b := 2147483647 * 2147483647 * 4; RETURN b + a END.", {0}, {{-17179869180, nullopt, max}}},
+    };
+
+    array<ArithmeticMode, 3> modes = {ArithmeticMode::Wrapping, ArithmeticMode::Trapping, ArithmeticMode::Saturating};
+    for (const Case& c : cases) {
+        for (size_t i = 0; i < modes.size(); i++) {
+            for (OptimizationLevel level : {OptimizationLevel::O0, OptimizationLevel::O2}) {
+                for (bool finalized : {false, true}) {
+                    SCOPED_TRACE(string(c.code) + " mode " + to_string(i) + " level " + to_string(static_cast<int>(level)) + (finalized ? " finalized" : ""));
+                    auto func = jit.registerFunction(c.code, level, modes[i]);
+                    if (finalized) {
+                        ASSERT_TRUE(func.finalize());
+                    }
+                    CallOutcome outcome = CallOutcome::Success;
+                    ASSERT_EQ(func(span<const int64_t>(c.parameters), outcome), c.results[i]);
+                    ASSERT_EQ(outcome, c.results[i] ? CallOutcome::Success : CallOutcome::Overflow);
+                    ASSERT_EQ(func.evaluateBatch(vector<vector<int64_t>>{c.parameters}), vector<optional<int64_t>>{c.results[i]});
+                }
+            }
+        }
+    }
+
+    // The metrics count the overflows apart from the other errors, a new pass manager keeps the mode
+    auto func = jit.registerFunction("PARAM a, b; BEGIN RETURN a / b END.", OptimizationLevel::O1, ArithmeticMode::Trapping);
+    func.setPassManager(PassManager(OptimizationLevel::O2));
+    ASSERT_EQ(func(6, 3), 2);
+    ASSERT_FALSE(func(min, -1));
+    ASSERT_FALSE(func(1, 0));
+    auto metrics = func.getMetrics();
+    ASSERT_EQ(metrics.overflowErrors, 1);
+    ASSERT_EQ(metrics.divisionByZeroErrors, 1);
+
+    // A function without parameters keeps the outcome of its evaluation
+    auto constant = jit.registerFunction("VAR a; BEGIN a := 2147483647 * 2147483647; RETURN a * 4 END.", OptimizationLevel::O2, ArithmeticMode::Trapping);
+    CallOutcome outcome = CallOutcome::Success;
+    ASSERT_FALSE(constant(span<const int64_t>(), outcome));
+    ASSERT_EQ(outcome, CallOutcome::Overflow);
+}
+//---------------------------------------------------------------------------
+TEST(TestPljit, UpdateReleasesVersions) {
+    // The asts of the updates are allocated from the default resource
+    CountingResource resource;
+    pmr::memory_resource* previous = pmr::set_default_resource(&resource);
+    {
+        Pljit jit;
+        auto func = jit.registerFunction("PARAM a; VAR b; BEGIN b := a * 2; RETURN b + 1 END.");
+        ASSERT_EQ(func(1), 3);
+        ASSERT_TRUE(func.update("PARAM a; VAR b; BEGIN b := a * 3; RETURN b + 1 END."));
+        size_t live = resource.allocated - resource.deallocated;
+        for (int64_t i = 0; i < 100; i++) {
+            ASSERT_TRUE(func.update("PARAM a; VAR b; BEGIN b := a * " + to_string(i % 10) + "; RETURN b + 1 END."));
+            ASSERT_EQ(func(2), 2 * (i % 10) + 1);
+        }
+        // A replaced version is released once no call evaluates it, so the updates do not accumulate
+        ASSERT_LT(resource.allocated - resource.deallocated, 2 * live);
+    }
+    pmr::set_default_resource(previous);
+    ASSERT_EQ(resource.deallocated, resource.allocated);
+}
+//---------------------------------------------------------------------------
@@ -0,0 +1,64 @@
+#include "pljit/Pljit.hpp"
+#include "test/ProgramGenerator.hpp"
+#include <gtest/gtest.h>
+//---------------------------------------------------------------------------
+using namespace std;
+using namespace pljit;
+//---------------------------------------------------------------------------
+TEST(TestProgramGenerator, Deterministic) {
+    ProgramShape shape;
+    shape.seed = 42;
+    ProgramGenerator generator(shape);
+    string program = generator.generate();
+
+    ASSERT_EQ(program, generator.generate());
+    ASSERT_EQ(program, ProgramGenerator(shape).generate());
+
+    shape.seed = 43;
+    ASSERT_NE(program, ProgramGenerator(shape).generate());
+}
+//---------------------------------------------------------------------------
+TEST(TestProgramGenerator, ValidPrograms) {
+    const vector<vector<int64_t>> parameterRows = {{0, 0, 0}, {1, -2, 3}, {1000, -1000, 1000}, {-7, 999, 13}};
+
+    for (uint64_t seed = 0; seed < 20; seed++) {
+        ProgramShape shape;
+        shape.seed = seed;
+        shape.statements = 50;
+        shape.parameters = 3;
+        shape.depth = 6;
+        shape.constantDensity = static_cast<double>(seed % 5) / 4;
+        string program = ProgramGenerator(shape).generate();
+
+        Pljit jit;
+        auto func0 = jit.registerFunction(program, OptimizationLevel::O0);
+        auto func2 = jit.registerFunction(program, OptimizationLevel::O2);
+        for (const auto& parameters : parameterRows) {
+            auto result = func0(parameters);
+            ASSERT_TRUE(result.has_value()) << program;
+            ASSERT_EQ(result, func2(parameters)) << program;
+        }
+    }
+}
+//---------------------------------------------------------------------------
+TEST(TestProgramGenerator, NestedParentheses) {
+    Pljit jit;
+    vector<int64_t> parameters = {5};
+
+    string nested = ProgramGenerator::generateNested(200);
+    auto func = jit.registerFunction(nested);
+    ASSERT_EQ(func(parameters), 5);
+
+    string chain = ProgramGenerator::generateChain(200);
+    auto func2 = jit.registerFunction(chain);
+    ASSERT_EQ(func2(parameters), 1000);
+
+    const auto code =
+        "PARAM a;\n"
+        "BEGIN\n"
+        "RETURN -(a) + ((2))\n"
+        "END.\n";
+    auto func3 = jit.registerFunction(code);
+    ASSERT_EQ(func3(parameters), -3);
+}
+//---------------------------------------------------------------------------